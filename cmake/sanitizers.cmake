@@ -17,4 +17,17 @@ function( target_enable_sanitizers _target )
         target_compile_options(${_target} INTERFACE -fsanitize=address,leak,undefined)
         target_link_options(${_target} INTERFACE -fsanitize=address,leak,undefined)
     endif()
-endfunction()
\ No newline at end of file
+endfunction()
+
+function( target_enable_thread_sanitizer _target )
+    if( MSVC )
+        message(SEND_ERROR "ThreadSanitizer is not available with MSVC")
+    else()
+        target_compile_options(${_target} PUBLIC -fsanitize=thread)
+        target_link_options(${_target} PUBLIC -fsanitize=thread)
+        if( CMAKE_CXX_COMPILER_ID STREQUAL "GNU" )
+            # GCC warns that atomic_thread_fence is not instrumented.
+            target_compile_options(${_target} PUBLIC -Wno-tsan)
+        endif()
+    endif()
+endfunction()
@@ -1,4 +1,4 @@
-#version 330 core
+#version 430 core
 
 in vec3 Normal;
 in vec2 TexCoords;
@@ -23,13 +23,14 @@ struct DirectionalLight
     vec3 specular;
 };
 
+// std430 layout, mirrored by wmcv::PointLight. Only xyz of the vec4s is used.
 struct PointLight
 {
-    vec3 position;
+    vec4 position;
 
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
 
     float constant;
     float linear;
@@ -53,11 +54,14 @@ struct SpotLight
     float outerRadius;
 };
 
-#define NUM_POINT_LIGHTS 4
+layout (std430, binding = 0) readonly buffer PointLightBuffer
+{
+    uint pointLightCount;
+    PointLight pointLights[];
+};
 
 uniform Material material;
 uniform DirectionalLight dirLight;
-uniform PointLight pointLights[NUM_POINT_LIGHTS];
 uniform SpotLight spotLight;
 uniform vec3 viewPos;
 
@@ -76,7 +80,7 @@ vec3 ComputeDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir)
 
 vec3 ComputePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
 {
-    vec3 lightDir = normalize(light.position - fragPos);
+    vec3 lightDir = normalize(light.position.xyz - fragPos);
 
     // diffuse shading
     float diff = max(dot(normal, lightDir), 0.0);
@@ -86,14 +90,14 @@ vec3 ComputePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
 
     // attenuation
-    float distance    = length(light.position - fragPos);
+    float distance    = length(light.position.xyz - fragPos);
     float attenuation = 1.0 / (light.constant + light.linear * distance + 
   			            light.quadratic * (distance * distance));    
 
     // combine results
-    vec3 ambient  = light.ambient  * vec3(texture(material.diffuse, TexCoords));
-    vec3 diffuse  = light.diffuse  * diff * vec3(texture(material.diffuse, TexCoords));
-    vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
+    vec3 ambient  = light.ambient.rgb  * vec3(texture(material.diffuse, TexCoords));
+    vec3 diffuse  = light.diffuse.rgb  * diff * vec3(texture(material.diffuse, TexCoords));
+    vec3 specular = light.specular.rgb * spec * vec3(texture(material.specular, TexCoords));
 
     ambient  *= attenuation;
     diffuse  *= attenuation;
@@ -137,7 +141,7 @@ void main()
     // phase 1: Directional lighting
     vec3 result = ComputeDirectionalLight(dirLight, norm, viewDir);
     // phase 2: Point lights
-    for(int i = 0; i < NUM_POINT_LIGHTS; i++)
+    for(uint i = 0; i < pointLightCount; i++)
         result += ComputePointLight(pointLights[i], norm, FragPos, viewDir);    
     // phase 3: Spot light
     result += ComputeSpotLight(spotLight, norm, FragPos, viewDir);    
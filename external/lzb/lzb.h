@@ -0,0 +1,307 @@
+/* lzb - v0.1 - public domain LZ77 block codec
+
+   Single-file compressor/decompressor for the LZ4 block format: greedy
+   matching on a 4-byte hash, no frame, no checksum, no dictionary carried
+   between blocks. Every call to lzb_compress produces a block that
+   lzb_decompress can decode on its own.
+
+   Do this:
+      #define LZB_IMPLEMENTATION
+   before you include this file in *one* C or C++ file to create the implementation.
+
+   API:
+      int lzb_compress_bound(int srcSize);
+         Worst case output size for srcSize bytes of input.
+
+      int lzb_compress(const void* src, int srcSize, void* dst, int dstCapacity);
+         Returns the compressed size, or -1 if dstCapacity is too small.
+         Passing lzb_compress_bound(srcSize) as capacity never fails.
+
+      int lzb_decompress(const void* src, int srcSize, void* dst, int dstCapacity);
+         Returns the decompressed size, or -1 if the input is malformed or
+         would overrun dstCapacity. Safe on untrusted input.
+
+   FORMAT:
+      A block is a list of sequences. Each sequence is a token byte (high
+      nibble literal count, low nibble match length - 4), extra literal
+      count bytes when the nibble is 15, the literals, a 2-byte little
+      endian match offset and extra match length bytes. The last sequence
+      carries literals only. The last 5 bytes of a block are always
+      literals and the last match starts at least 12 bytes before the end.
+
+LICENSE
+
+   This software is released into the public domain. See the LICENSE file at
+   the root of this repository.
+*/
+
+#ifndef LZB_H_INCLUDED
+#define LZB_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int lzb_compress_bound(int srcSize);
+int lzb_compress(const void* src, int srcSize, void* dst, int dstCapacity);
+int lzb_decompress(const void* src, int srcSize, void* dst, int dstCapacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LZB_H_INCLUDED
+
+#ifdef LZB_IMPLEMENTATION
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LZB__MIN_MATCH 4
+#define LZB__LAST_LITERALS 5
+#define LZB__MATCH_LIMIT 12
+#define LZB__MAX_OFFSET 65535
+#define LZB__HASH_LOG 12
+
+static uint32_t lzb__read32(const uint8_t* p)
+{
+	uint32_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static uint32_t lzb__hash(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - LZB__HASH_LOG);
+}
+
+// Writes the 255-run continuation of a length whose nibble saturated at 15.
+static uint8_t* lzb__write_length(uint8_t* op, size_t length)
+{
+	while (length >= 255)
+	{
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = (uint8_t)length;
+	return op;
+}
+
+static uint8_t* lzb__write_sequence(uint8_t* op, const uint8_t* opEnd, const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength)
+{
+	// Worst case: token, literal run, literals, offset, match run.
+	const size_t needed = 1 + literalLength / 255 + 1 + literalLength + 2 + matchLength / 255 + 1;
+	if ((size_t)(opEnd - op) < needed)
+	{
+		return NULL;
+	}
+
+	uint8_t* token = op++;
+	const size_t literalNibble = literalLength < 15 ? literalLength : 15;
+	*token = (uint8_t)(literalNibble << 4);
+	if (literalLength >= 15)
+	{
+		op = lzb__write_length(op, literalLength - 15);
+	}
+
+	memcpy(op, literals, literalLength);
+	op += literalLength;
+
+	if (matchLength == 0)
+	{
+		return op;
+	}
+
+	*op++ = (uint8_t)(offset & 0xff);
+	*op++ = (uint8_t)(offset >> 8);
+
+	const size_t matchCode = matchLength - LZB__MIN_MATCH;
+	*token = (uint8_t)(*token | (matchCode < 15 ? matchCode : 15));
+	if (matchCode >= 15)
+	{
+		op = lzb__write_length(op, matchCode - 15);
+	}
+
+	return op;
+}
+
+int lzb_compress_bound(int srcSize)
+{
+	return srcSize < 0 ? 0 : srcSize + srcSize / 255 + 16;
+}
+
+int lzb_compress(const void* src, int srcSize, void* dst, int dstCapacity)
+{
+	if (srcSize < 0 || dstCapacity < 0)
+	{
+		return -1;
+	}
+
+	const uint8_t* const base = (const uint8_t*)src;
+	const uint8_t* const end = base + srcSize;
+	uint8_t* const out = (uint8_t*)dst;
+	const uint8_t* const outEnd = out + dstCapacity;
+
+	uint8_t* op = out;
+	const uint8_t* anchor = base;
+
+	if (srcSize > LZB__MATCH_LIMIT)
+	{
+		const uint8_t* const matchLimit = end - LZB__MATCH_LIMIT;
+		const uint8_t* const literalsStart = end - LZB__LAST_LITERALS;
+		uint32_t table[1 << LZB__HASH_LOG];
+		memset(table, 0, sizeof(table));
+
+		const uint8_t* ip = base + 1;
+		while (ip < matchLimit)
+		{
+			const uint32_t hash = lzb__hash(lzb__read32(ip));
+			const uint8_t* ref = base + table[hash];
+			table[hash] = (uint32_t)(ip - base);
+
+			if ((size_t)(ip - ref) > LZB__MAX_OFFSET || lzb__read32(ref) != lzb__read32(ip))
+			{
+				++ip;
+				continue;
+			}
+
+			while (ip > anchor && ref > base && ip[-1] == ref[-1])
+			{
+				--ip;
+				--ref;
+			}
+
+			const uint8_t* matchEnd = ip + LZB__MIN_MATCH;
+			const uint8_t* refEnd = ref + LZB__MIN_MATCH;
+			while (matchEnd < literalsStart && *matchEnd == *refEnd)
+			{
+				++matchEnd;
+				++refEnd;
+			}
+
+			op = lzb__write_sequence(op, outEnd, anchor, (size_t)(ip - anchor), (size_t)(ip - ref), (size_t)(matchEnd - ip));
+			if (!op)
+			{
+				return -1;
+			}
+
+			ip = matchEnd;
+			anchor = ip;
+			if (ip - 2 > base && ip < matchLimit)
+			{
+				table[lzb__hash(lzb__read32(ip - 2))] = (uint32_t)(ip - 2 - base);
+			}
+		}
+	}
+
+	op = lzb__write_sequence(op, outEnd, anchor, (size_t)(end - anchor), 0, 0);
+	return op ? (int)(op - out) : -1;
+}
+
+// Reads a 255-run continuation; returns 0 if the input ends inside it.
+static int lzb__read_length(const uint8_t** ip, const uint8_t* ipEnd, size_t* length)
+{
+	uint8_t byte;
+	do
+	{
+		if (*ip >= ipEnd)
+		{
+			return 0;
+		}
+		byte = *(*ip)++;
+		*length += byte;
+	} while (byte == 255);
+	return 1;
+}
+
+int lzb_decompress(const void* src, int srcSize, void* dst, int dstCapacity)
+{
+	if (srcSize <= 0 || dstCapacity < 0)
+	{
+		return -1;
+	}
+
+	const uint8_t* ip = (const uint8_t*)src;
+	const uint8_t* const ipEnd = ip + srcSize;
+	uint8_t* const out = (uint8_t*)dst;
+	uint8_t* op = out;
+	uint8_t* const opEnd = out + dstCapacity;
+
+	for (;;)
+	{
+		const uint8_t token = *ip++;
+
+		size_t literalLength = (size_t)(token >> 4);
+		if (literalLength == 15 && !lzb__read_length(&ip, ipEnd, &literalLength))
+		{
+			return -1;
+		}
+
+		if (literalLength > (size_t)(ipEnd - ip) || literalLength > (size_t)(opEnd - op))
+		{
+			return -1;
+		}
+
+		memcpy(op, ip, literalLength);
+		op += literalLength;
+		ip += literalLength;
+
+		if (ip == ipEnd)
+		{
+			return (int)(op - out);
+		}
+
+		if (ipEnd - ip < 2)
+		{
+			return -1;
+		}
+
+		const size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (size_t)(op - out))
+		{
+			return -1;
+		}
+
+		size_t matchLength = (size_t)(token & 15);
+		if (matchLength == 15 && !lzb__read_length(&ip, ipEnd, &matchLength))
+		{
+			return -1;
+		}
+		matchLength += LZB__MIN_MATCH;
+
+		if (matchLength > (size_t)(opEnd - op))
+		{
+			return -1;
+		}
+
+		// Overlapping matches repeat the last offset bytes, so copy forwards.
+		const uint8_t* match = op - offset;
+		if (offset >= matchLength)
+		{
+			memcpy(op, match, matchLength);
+			op += matchLength;
+		}
+		else
+		{
+			for (size_t i = 0; i < matchLength; ++i)
+			{
+				*op++ = *match++;
+			}
+		}
+
+		if (ip >= ipEnd)
+		{
+			return -1;
+		}
+	}
+}
+
+#undef LZB__MIN_MATCH
+#undef LZB__LAST_LITERALS
+#undef LZB__MATCH_LIMIT
+#undef LZB__MAX_OFFSET
+#undef LZB__HASH_LOG
+
+#endif // LZB_IMPLEMENTATION
@@ -0,0 +1,222 @@
+#include "pch.h"
+#include "indirect_draws.h"
+#include "frustum_culling.h"
+#include "occlusion_culling.h"
+
+#include <cstdio>
+#include <random>
+
+// Times the CPU side of the renderer, no GL context needed.
+//
+//   learn-opengl-bench [--filter text]
+//
+// Every scenario runs at several object counts and prints objects/ms for
+// the best of a few runs.
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int RUNS = 5;
+constexpr uint32_t MESH_COUNT = 16;
+
+struct Options
+{
+	std::string filter;
+};
+
+struct Scene
+{
+	std::vector<wmcv::MeshRange> meshes;
+	std::vector<uint32_t> objectMeshes;
+	std::vector<wmcv::MeshInstance> objectInstances;
+	wmcv::CullingBounds bounds;
+	wmcv::Frustum frustum;
+	glm::mat4 viewProjection;
+	std::vector<glm::mat4> occluders;
+	std::vector<uint32_t> inFrustum;
+};
+
+// Output buffers reused across runs so only the work itself is timed.
+struct Workspace
+{
+	wmcv::IndirectDrawBuilder draws;
+	std::vector<uint32_t> visible;
+	wmcv::OcclusionBuffer occlusion{256, 128};
+	wmcv::OcclusionBuffer threadedOcclusion{256, 128, 4};
+};
+
+struct Scenario
+{
+	const char* name;
+	// Runs once over the scene and returns something derived from the work.
+	size_t (*run)(const Scene& scene, Workspace& workspace);
+	// Skipped when this returns false, e.g. for instruction sets the CPU lacks.
+	bool (*supported)() = nullptr;
+};
+
+template <typename T>
+void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static_cast<void>(*static_cast<const volatile char*>(static_cast<const volatile void*>(&value)));
+#endif
+}
+
+Scene MakeScene(size_t objects)
+{
+	Scene scene;
+	uint32_t firstIndex = 0;
+	for (uint32_t mesh = 0; mesh < MESH_COUNT; ++mesh)
+	{
+		const uint32_t indexCount = 36 * (mesh + 1);
+		scene.meshes.push_back(wmcv::MeshRange{indexCount, firstIndex, 0});
+		firstIndex += indexCount;
+	}
+
+	std::mt19937 random{1234};
+	std::uniform_real_distribution<float> position{-500.f, 500.f};
+	scene.objectMeshes.reserve(objects);
+	scene.objectInstances.reserve(objects);
+	scene.bounds.reserve(objects);
+	for (size_t object = 0; object < objects; ++object)
+	{
+		scene.objectMeshes.push_back(static_cast<uint32_t>(random() % MESH_COUNT));
+		const glm::vec3 at{position(random), position(random), position(random)};
+		const glm::mat4 model = glm::translate(glm::mat4{1.f}, at);
+		scene.objectInstances.push_back(wmcv::MakeMeshInstance(model));
+		scene.bounds.addTransformedBox(model, glm::vec3{0.5f});
+	}
+
+	// Looking into the middle of the field, so roughly a tenth is visible.
+	const glm::mat4 projection = glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 1000.f);
+	const glm::mat4 view = glm::lookAt(glm::vec3{0.f}, glm::vec3{0.f, 0.f, -1.f}, glm::vec3{0.f, 1.f, 0.f});
+	scene.viewProjection = projection * view;
+	scene.frustum = wmcv::ExtractFrustum(scene.viewProjection);
+	wmcv::CullFrustum(scene.frustum, scene.bounds, scene.inFrustum);
+
+	// A row of walls part way into the view.
+	for (int wall = -4; wall < 4; ++wall)
+	{
+		const glm::vec3 at{static_cast<float>(wall) * 60.f + 30.f, 0.f, -100.f};
+		scene.occluders.push_back(glm::scale(glm::translate(glm::mat4{1.f}, at), glm::vec3{50.f, 80.f, 2.f}));
+	}
+	return scene;
+}
+
+size_t AddInSceneOrder(const Scene& scene, Workspace& workspace)
+{
+	wmcv::IndirectDrawBuilder& draws = workspace.draws;
+	draws.reset();
+	for (size_t object = 0; object < scene.objectInstances.size(); ++object)
+		draws.add(scene.meshes[scene.objectMeshes[object]], scene.objectInstances[object]);
+	return draws.commands().size();
+}
+
+size_t BuildByMesh(const Scene& scene, Workspace& workspace)
+{
+	wmcv::IndirectDrawBuilder& draws = workspace.draws;
+	draws.reset();
+	draws.build(scene.meshes, scene.objectMeshes, scene.objectInstances);
+	return draws.commands().size();
+}
+
+template <wmcv::CullingPath Path>
+size_t CullFrustum(const Scene& scene, Workspace& workspace)
+{
+	wmcv::CullFrustum(scene.frustum, scene.bounds, workspace.visible, Path);
+	return workspace.visible.size();
+}
+
+template <wmcv::OcclusionBuffer Workspace::*Buffer>
+size_t CullOccluded(const Scene& scene, Workspace& workspace)
+{
+	wmcv::OcclusionBuffer& occlusion = workspace.*Buffer;
+	occlusion.begin(scene.viewProjection);
+	for (const glm::mat4& model : scene.occluders)
+		occlusion.addOccluderBox(model, glm::vec3{0.5f});
+	occlusion.rasterize();
+
+	workspace.visible.assign(scene.inFrustum.begin(), scene.inFrustum.end());
+	occlusion.cull(scene.bounds, workspace.visible);
+	return workspace.visible.size();
+}
+
+template <wmcv::CullingPath Path>
+bool CullingSupported()
+{
+	return wmcv::CullingPathSupported(Path);
+}
+
+const Scenario SCENARIOS[] = {
+	{"indirect add, scene order", &AddInSceneOrder},
+	{"indirect build, bucketed by mesh", &BuildByMesh},
+	{"frustum cull, scalar", &CullFrustum<wmcv::CullingPath::Scalar>},
+	{"frustum cull, sse", &CullFrustum<wmcv::CullingPath::SSE>, &CullingSupported<wmcv::CullingPath::SSE>},
+	{"frustum cull, avx", &CullFrustum<wmcv::CullingPath::AVX>, &CullingSupported<wmcv::CullingPath::AVX>},
+	{"occlusion cull, 1 thread", &CullOccluded<&Workspace::occlusion>},
+	{"occlusion cull, 4 threads", &CullOccluded<&Workspace::threadedOcclusion>},
+};
+
+bool ParseOptions(int argc, char** argv, Options& options)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view arg = argv[i];
+		if (arg == "--filter" && i + 1 < argc)
+		{
+			options.filter = argv[++i];
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--filter text]\n", argv[0]);
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+		return 1;
+
+	std::printf("%-40s %10s %14s %10s\n", "scenario", "objects", "objects/ms", "output");
+
+	Workspace workspace;
+	for (const size_t objects : {size_t{10'000}, size_t{100'000}, size_t{1'000'000}})
+	{
+		const Scene scene = MakeScene(objects);
+		workspace.draws.reserve(objects, objects);
+		workspace.visible.reserve(objects);
+
+		for (const Scenario& scenario : SCENARIOS)
+		{
+			if (!options.filter.empty() && std::string_view{scenario.name}.find(options.filter) == std::string_view::npos)
+				continue;
+			if (scenario.supported != nullptr && !scenario.supported())
+				continue;
+
+			double bestMs = 0.0;
+			size_t output = 0;
+			for (int run = 0; run < RUNS; ++run)
+			{
+				const auto start = Clock::now();
+				output = scenario.run(scene, workspace);
+				DoNotOptimize(output);
+				const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+				bestMs = run == 0 ? ms : std::min(bestMs, ms);
+			}
+
+			std::printf("%-40s %10zu %14.0f %10zu\n", scenario.name, objects, static_cast<double>(objects) / bestMs, output);
+		}
+	}
+
+	return 0;
+}
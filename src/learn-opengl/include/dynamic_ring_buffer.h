@@ -0,0 +1,139 @@
+#ifndef DYNAMIC_RING_BUFFER_H_INCLUDED
+#define DYNAMIC_RING_BUFFER_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <span>
+#include <vector>
+
+namespace wmcv
+{
+
+using FenceHandle = void*;
+
+// Source of GPU fences, so the frame bookkeeping can run against a fake.
+class FenceProvider
+{
+public:
+	virtual ~FenceProvider() = default;
+
+	// Fence that signals once every command issued so far has completed.
+	virtual FenceHandle insert() = 0;
+	virtual bool signaled(FenceHandle fence) = 0;
+	// Blocks until the fence signals.
+	virtual void wait(FenceHandle fence) = 0;
+	virtual void release(FenceHandle fence) = 0;
+};
+
+class GLFenceProvider final : public FenceProvider
+{
+public:
+	FenceHandle insert() override;
+	bool signaled(FenceHandle fence) override;
+	void wait(FenceHandle fence) override;
+	void release(FenceHandle fence) override;
+};
+
+struct FrameRegionStats
+{
+	uint32_t frames = 0;
+	// Frames that had to block on the GPU before reusing their region.
+	uint32_t stalls = 0;
+};
+
+// Splits a buffer into regionCount equal regions, one per frame in flight.
+// beginFrame() moves to the next region and waits for the fence the GPU
+// signals when it has finished reading that region; endFrame() fences it.
+class FrameRegionRing
+{
+public:
+	static constexpr size_t INVALID_OFFSET = SIZE_MAX;
+
+	FrameRegionRing(size_t regionSize, uint32_t regionCount, FenceProvider& fences);
+	~FrameRegionRing();
+
+	FrameRegionRing(const FrameRegionRing&) = delete;
+	FrameRegionRing& operator=(const FrameRegionRing&) = delete;
+
+	void beginFrame();
+	void endFrame();
+
+	// Offset from the start of the buffer, or INVALID_OFFSET once the
+	// current region is full.
+	size_t allocate(size_t size, size_t alignment);
+
+	inline uint32_t currentRegion() const { return m_region; }
+	inline size_t regionSize() const { return m_regionSize; }
+	inline uint32_t regionCount() const { return static_cast<uint32_t>(m_fences.size()); }
+	inline size_t used() const { return m_offset; }
+	inline FrameRegionStats stats() const { return m_stats; }
+
+private:
+	FenceProvider& m_fenceProvider;
+	std::vector<FenceHandle> m_fences;
+	size_t m_regionSize;
+	size_t m_offset = 0;
+	uint32_t m_region = 0;
+	FrameRegionStats m_stats;
+};
+
+struct DynamicAllocation
+{
+	std::byte* data = nullptr;
+	size_t offset = 0;
+	size_t size = 0;
+
+	inline bool valid() const { return data != nullptr; }
+};
+
+// Persistently and coherently mapped buffer (ARB_buffer_storage) for data
+// rewritten every frame. Writes land directly in memory the GPU reads, and
+// the region fences keep the CPU from overwriting a frame still in flight.
+class DynamicRingBuffer
+{
+public:
+	DynamicRingBuffer(size_t regionSize, uint32_t framesInFlight, FenceProvider& fences);
+	~DynamicRingBuffer();
+
+	DynamicRingBuffer(const DynamicRingBuffer&) = delete;
+	DynamicRingBuffer& operator=(const DynamicRingBuffer&) = delete;
+
+	// The GL caps both range offset alignments at 256 bytes.
+	static constexpr size_t MAX_ALIGNMENT = 256;
+
+	// Region size that fits one allocation of each size, in order, under any
+	// alignment the GL may report.
+	static size_t RegionSizeFor(std::initializer_list<size_t> sizes);
+
+	void beginFrame();
+	void endFrame();
+
+	// Aligned for binding as a uniform or shader storage range.
+	DynamicAllocation allocate(size_t size);
+
+	template <typename T>
+	DynamicAllocation write(std::span<const T> values)
+	{
+		const DynamicAllocation allocation = allocate(values.size_bytes());
+		if (allocation.valid() && !values.empty())
+			std::memcpy(allocation.data, values.data(), values.size_bytes());
+		return allocation;
+	}
+
+	void bindRange(uint32_t target, uint32_t index, const DynamicAllocation& allocation) const;
+
+	inline uint32_t bufferId() const { return m_bufferId; }
+	inline const FrameRegionRing& regions() const { return m_regions; }
+
+private:
+	FrameRegionRing m_regions;
+	uint32_t m_bufferId = 0;
+	std::byte* m_mapped = nullptr;
+	size_t m_alignment = 1;
+};
+
+} // namespace wmcv
+
+#endif // DYNAMIC_RING_BUFFER_H_INCLUDED
@@ -0,0 +1,68 @@
+#ifndef FRUSTUM_CULLING_H_INCLUDED
+#define FRUSTUM_CULLING_H_INCLUDED
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace wmcv
+{
+
+// Left, right, bottom, top, near and far planes as (normal, distance) with
+// unit normals pointing inwards, so p is inside when dot(normal, p) +
+// distance >= 0.
+struct Frustum
+{
+	std::array<glm::vec4, 6> planes;
+};
+
+// Gribb/Hartmann extraction from an OpenGL projection * view matrix.
+Frustum ExtractFrustum(const glm::mat4& viewProjection);
+
+// Axis aligned boxes as centre and half extents, one array per component.
+// The arrays are padded to a whole number of 8 wide lanes so the SIMD
+// paths never read past the end.
+class CullingBounds
+{
+public:
+	static constexpr size_t LANES = 8;
+
+	void clear();
+	void reserve(size_t count);
+
+	uint32_t add(const glm::vec3& center, const glm::vec3& extents);
+	// Box around a local box of the given half extents moved by model.
+	uint32_t addTransformedBox(const glm::mat4& model, const glm::vec3& halfExtents);
+
+	glm::vec3 boxCenter(uint32_t index) const;
+	glm::vec3 boxExtents(uint32_t index) const;
+
+	inline size_t size() const { return m_count; }
+	// Component axis (0 = x) of every box, padded as described above.
+	inline const float* centers(uint32_t axis) const { return m_centers[axis].data(); }
+	inline const float* extents(uint32_t axis) const { return m_extents[axis].data(); }
+
+private:
+	std::array<std::vector<float>, 3> m_centers;
+	std::array<std::vector<float>, 3> m_extents;
+	size_t m_count = 0;
+};
+
+enum class CullingPath : uint8_t
+{
+	Scalar,
+	SSE,
+	AVX,
+};
+
+// Widest path this CPU can run.
+CullingPath BestCullingPath();
+bool CullingPathSupported(CullingPath path);
+
+// Replaces visible with the indices of the boxes that touch the frustum, in
+// ascending order.
+void CullFrustum(const Frustum& frustum, const CullingBounds& bounds, std::vector<uint32_t>& visible, CullingPath path = BestCullingPath());
+
+} // namespace wmcv
+
+#endif // FRUSTUM_CULLING_H_INCLUDED
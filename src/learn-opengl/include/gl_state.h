@@ -0,0 +1,62 @@
+#ifndef GL_STATE_H_INCLUDED
+#define GL_STATE_H_INCLUDED
+
+#include <array>
+#include <cstdint>
+
+namespace wmcv
+{
+
+struct GLStateStats
+{
+	uint32_t issued = 0;
+	uint32_t elided = 0;
+};
+
+// Shadow of the binding state of the current context. Shader, Texture and
+// the renderer bind through here so calls that would not change anything
+// never reach the driver. Anything that binds behind its back must call
+// invalidate().
+class GLStateCache
+{
+public:
+	static constexpr uint32_t MAX_TEXTURE_UNITS = 32;
+
+	GLStateCache();
+
+	void useProgram(uint32_t program);
+	void bindVertexArray(uint32_t vertexArray);
+	// unit is an index, not GL_TEXTURE0 + index.
+	void activeTexture(uint32_t unit);
+	// Binds a GL_TEXTURE_2D to unit, switching the active unit only if the
+	// binding changes. unit must be below MAX_TEXTURE_UNITS.
+	void bindTexture(uint32_t unit, uint32_t texture);
+
+	// Deleted names can be handed out again, so drop any binding to them.
+	void forgetProgram(uint32_t program);
+	void forgetVertexArray(uint32_t vertexArray);
+	void forgetTexture(uint32_t texture);
+
+	void invalidate();
+
+	inline GLStateStats stats() const { return m_stats; }
+	inline void resetStats() { m_stats = {}; }
+
+private:
+	static constexpr uint32_t UNKNOWN = UINT32_MAX;
+
+	bool update(uint32_t& current, uint32_t value);
+
+	uint32_t m_program;
+	uint32_t m_vertexArray;
+	uint32_t m_activeUnit;
+	std::array<uint32_t, MAX_TEXTURE_UNITS> m_textures;
+	GLStateStats m_stats;
+};
+
+// The cache for the one context this app renders with.
+GLStateCache& GetGLState();
+
+} // namespace wmcv
+
+#endif // GL_STATE_H_INCLUDED
@@ -0,0 +1,63 @@
+#ifndef INDIRECT_DRAWS_H_INCLUDED
+#define INDIRECT_DRAWS_H_INCLUDED
+
+#include "instance_buffer.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace wmcv
+{
+
+// Layout glMultiDrawElementsIndirect reads from GL_DRAW_INDIRECT_BUFFER.
+struct DrawElementsIndirectCommand
+{
+	uint32_t count;
+	uint32_t instanceCount;
+	uint32_t firstIndex;
+	int32_t baseVertex;
+	uint32_t baseInstance;
+};
+
+static_assert(sizeof(DrawElementsIndirectCommand) == 20);
+
+// Where a mesh's indices and vertices live in the shared buffers.
+struct MeshRange
+{
+	uint32_t indexCount;
+	uint32_t firstIndex;
+	int32_t baseVertex;
+
+	friend bool operator==(const MeshRange&, const MeshRange&) = default;
+};
+
+// Builds the command array for one multi-draw and the instance stream it
+// draws from. Each command's baseInstance points at its first instance, so
+// the per-instance attributes pick up the right data without gl_DrawID.
+class IndirectDrawBuilder
+{
+public:
+	void reset();
+	void reserve(size_t commands, size_t instances);
+
+	// Extends the previous command when it draws the same mesh.
+	void add(const MeshRange& mesh, const MeshInstance& instance);
+	void add(const MeshRange& mesh, std::span<const MeshInstance> instances);
+
+	// Buckets objects by mesh first, giving one command per mesh used.
+	// objectMeshes[i] indexes meshes for objectInstances[i].
+	void build(std::span<const MeshRange> meshes, std::span<const uint32_t> objectMeshes, std::span<const MeshInstance> objectInstances);
+
+	inline std::span<const DrawElementsIndirectCommand> commands() const { return m_commands; }
+	inline std::span<const MeshInstance> instances() const { return m_instances; }
+
+private:
+	std::vector<DrawElementsIndirectCommand> m_commands;
+	std::vector<MeshInstance> m_instances;
+	std::vector<uint32_t> m_meshOffsets;
+};
+
+} // namespace wmcv
+
+#endif // INDIRECT_DRAWS_H_INCLUDED
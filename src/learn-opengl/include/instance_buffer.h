@@ -0,0 +1,42 @@
+#ifndef INSTANCE_BUFFER_H_INCLUDED
+#define INSTANCE_BUFFER_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wmcv
+{
+
+// Per-instance vertex data. The model matrix feeds attributes 3-6 and the
+// normal matrix attributes 7-9 of basic_lighting.vs and light_cube.vs.
+struct MeshInstance
+{
+	glm::mat4 model;
+	glm::mat3 normal;
+};
+
+static_assert(offsetof(MeshInstance, model) == 0);
+static_assert(offsetof(MeshInstance, normal) == 64);
+static_assert(sizeof(MeshInstance) == 100, "MeshInstance is read as a tightly packed vertex stream");
+
+MeshInstance MakeMeshInstance(const glm::mat4& model);
+
+constexpr uint32_t INSTANCE_MODEL_ATTRIBUTE = 3;
+constexpr uint32_t INSTANCE_NORMAL_ATTRIBUTE = 7;
+// Vertex buffer binding every instance attribute reads through. Kept clear of
+// the mesh attributes, whose glVertexAttribPointer bindings match their
+// attribute index.
+constexpr uint32_t INSTANCE_BINDING = 15;
+
+// Describes the instance attributes of a vertex array once, with a divisor of
+// one so a single instanced draw walks the whole stream. No buffer is
+// attached until BindInstanceStream.
+void SetupInstanceAttributes(uint32_t vertexArray);
+
+// Points the instance attributes of vertexArray at MeshInstances starting at
+// offset in buffer, so each frame draws straight from the data it wrote.
+void BindInstanceStream(uint32_t vertexArray, uint32_t buffer, size_t offset);
+
+} // namespace wmcv
+
+#endif // INSTANCE_BUFFER_H_INCLUDED
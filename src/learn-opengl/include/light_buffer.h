@@ -0,0 +1,56 @@
+#ifndef LIGHT_BUFFER_H_INCLUDED
+#define LIGHT_BUFFER_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace wmcv
+{
+
+// Mirrors PointLight in basic_lighting.fs under std430. Colours and position
+// are padded out to vec4 so the layout is identical under std140 as well.
+struct PointLight
+{
+	glm::vec4 position;
+	glm::vec4 ambient;
+	glm::vec4 diffuse;
+	glm::vec4 specular;
+	float constant;
+	float linear;
+	float quadratic;
+	float padding;
+};
+
+static_assert(offsetof(PointLight, position) == 0);
+static_assert(offsetof(PointLight, ambient) == 16);
+static_assert(offsetof(PointLight, diffuse) == 32);
+static_assert(offsetof(PointLight, specular) == 48);
+static_assert(offsetof(PointLight, constant) == 64);
+static_assert(offsetof(PointLight, linear) == 68);
+static_assert(offsetof(PointLight, quadratic) == 72);
+static_assert(sizeof(PointLight) == 80, "array stride of PointLight in std430 is 80 bytes");
+
+// Header of the PointLightBuffer block: the count, then the light array at
+// the next 16 byte boundary.
+struct PointLightBufferHeader
+{
+	uint32_t count;
+	uint32_t padding[3];
+};
+
+static_assert(sizeof(PointLightBufferHeader) == 16);
+
+// Shader storage binding of the PointLightBuffer block in basic_lighting.fs.
+constexpr uint32_t POINT_LIGHT_BUFFER_BINDING = 0;
+
+// Bytes taken by the PointLightBuffer block holding count lights.
+size_t PointLightBufferSize(size_t count);
+
+// Writes the header and lights laid out as the PointLightBuffer block.
+// destination must hold PointLightBufferSize(lights.size()) bytes.
+void WritePointLightBuffer(std::span<const PointLight> lights, std::byte* destination);
+
+} // namespace wmcv
+
+#endif // LIGHT_BUFFER_H_INCLUDED
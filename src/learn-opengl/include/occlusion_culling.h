@@ -0,0 +1,101 @@
+#ifndef OCCLUSION_CULLING_H_INCLUDED
+#define OCCLUSION_CULLING_H_INCLUDED
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace wmcv
+{
+
+class CullingBounds;
+
+struct OcclusionStats
+{
+	uint32_t triangles = 0;
+	uint32_t tested = 0;
+	uint32_t occluded = 0;
+};
+
+// Low resolution depth buffer drawn on the CPU from a few large occluders,
+// used to drop boxes that are hidden behind them before they are drawn.
+// Depth is NDC z, so -1 is the near plane and 1 the far plane.
+class OcclusionBuffer
+{
+public:
+	// The buffer is split into square tiles that are rasterized in parallel.
+	static constexpr uint32_t TILE_SIZE = 32;
+
+	// Rounded up to a whole number of tiles. threadCount includes the thread
+	// calling rasterize; the rest are started here and live as long as the
+	// buffer.
+	OcclusionBuffer(uint32_t width, uint32_t height, uint32_t threadCount = 1);
+	~OcclusionBuffer();
+
+	OcclusionBuffer(const OcclusionBuffer&) = delete;
+	OcclusionBuffer& operator=(const OcclusionBuffer&) = delete;
+
+	// Drops the previous frame's occluders and starts a new frame.
+	void begin(const glm::mat4& viewProjection);
+
+	// Indexed triangle list in model space.
+	void addOccluder(const glm::mat4& model, std::span<const glm::vec3> vertices, std::span<const uint32_t> indices);
+	void addOccluderBox(const glm::mat4& model, const glm::vec3& halfExtents);
+
+	// Clears the buffer and draws every occluder, handing tiles out to the
+	// workers and the caller until none are left.
+	void rasterize();
+
+	// True when every pixel the box covers already holds something nearer.
+	// Boxes crossing the near plane or off screen are never occluded.
+	bool occluded(const glm::vec3& center, const glm::vec3& extents) const;
+
+	// Removes the occluded boxes from an index list, keeping the order.
+	void cull(const CullingBounds& bounds, std::vector<uint32_t>& visible);
+
+	inline float depth(uint32_t x, uint32_t y) const { return m_depth[y * m_width + x]; }
+	inline uint32_t width() const { return m_width; }
+	inline uint32_t height() const { return m_height; }
+	inline uint32_t tileCount() const { return m_tilesX * m_tilesY; }
+	inline uint32_t threadCount() const { return static_cast<uint32_t>(m_workers.size()) + 1; }
+	inline OcclusionStats stats() const { return m_stats; }
+
+private:
+	// Edge functions are a * x + b * y + c, inside when all three are >= 0.
+	struct ScreenTriangle
+	{
+		std::array<glm::vec3, 3> edges;
+		glm::vec3 depth;
+		float minX, minY, maxX, maxY;
+	};
+
+	void addClipTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+	void addScreenTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+	void rasterizeTile(uint32_t tile);
+	void rasterizeTiles();
+	void runWorker(std::stop_token stop);
+
+	uint32_t m_width;
+	uint32_t m_height;
+	uint32_t m_tilesX;
+	uint32_t m_tilesY;
+	glm::mat4 m_viewProjection{1.f};
+	std::vector<float> m_depth;
+	std::vector<ScreenTriangle> m_triangles;
+	OcclusionStats m_stats;
+
+	// Each rasterize bumps m_generation to wake the workers, who take tiles
+	// from m_nextTile and count m_busyWorkers down when they run out.
+	std::atomic<uint32_t> m_generation{0};
+	std::atomic<uint32_t> m_nextTile{0};
+	std::atomic<uint32_t> m_busyWorkers{0};
+	std::vector<std::jthread> m_workers;
+};
+
+} // namespace wmcv
+
+#endif // OCCLUSION_CULLING_H_INCLUDED
@@ -1,8 +1,11 @@
 #pragma once
 
-#include <GL/GL.h>
-#include "GL/glext.h"
+#include "opengl_functions.h"
+#include "render_commands.h"
+
+#ifdef _WIN32
 #include "GL/wglext.h"
+#endif
 
 namespace wmcv
 {
@@ -16,8 +19,6 @@ struct OpenGLCreateParams
 	int versionMinor;
 };
 
-using RenderCommand = std::function<void()>;
-
 class OpenGL
 {
 public:
@@ -28,7 +29,9 @@ public:
 	virtual void DrawScene() = 0;
 	virtual void Destroy() = 0;
 	virtual void SetClearColor(float, float, float) = 0;
-	virtual void PushCommand(RenderCommand&&) = 0;
+	virtual void PushCommand(uint64_t sortKey, const DrawArraysCommand&) = 0;
+	virtual void PushCommand(uint64_t sortKey, const DrawArraysInstancedCommand&) = 0;
+	virtual void PushCommand(uint64_t sortKey, const MultiDrawElementsIndirectCommand&) = 0;
 
 	virtual void SetOpacity(float) = 0;
 	virtual void SetModelTransform(const glm::mat4&) = 0;
@@ -47,50 +50,8 @@ using OpenGLPtr = std::unique_ptr<OpenGL>;
 
 } // namespace ogl_starter
 
+#ifdef _WIN32
 extern PFNWGLGETEXTENSIONSSTRINGEXTPROC wglGetExtensionsStringEXT;
 extern PFNWGLCHOOSEPIXELFORMATARBPROC wglChoosePixelFormatARB;
 extern PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB;
-extern PFNGLDEBUGMESSAGECALLBACKPROC glDebugMessageCallback;
-extern PFNGLCREATEPROGRAMPROC glCreateProgram;
-extern PFNGLDELETEPROGRAMPROC glDeleteProgram;
-extern PFNGLATTACHSHADERPROC glAttachShader;
-extern PFNGLLINKPROGRAMPROC glLinkProgram;
-extern PFNGLUSEPROGRAMPROC glUseProgram;
-extern PFNGLGETPROGRAMIVPROC glGetProgramiv;
-extern PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog;
-extern PFNGLCREATESHADERPROC glCreateShader;
-extern PFNGLDELETESHADERPROC glDeleteShader;
-extern PFNGLCOMPILESHADERPROC glCompileShader;
-extern PFNGLSHADERSOURCEPROC glShaderSource;
-extern PFNGLGETSHADERIVPROC glGetShaderiv;
-extern PFNGLGETSHADERINFOLOGPROC glGetShaderInfoLog;
-extern PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation;
-extern PFNGLUNIFORM1FPROC glUniform1f;
-extern PFNGLUNIFORM2FPROC glUniform2f;
-extern PFNGLUNIFORM3FPROC glUniform3f;
-extern PFNGLUNIFORM4FPROC glUniform4f;
-extern PFNGLUNIFORM1IPROC glUniform1i;
-extern PFNGLUNIFORM2IPROC glUniform2i;
-extern PFNGLUNIFORM3IPROC glUniform3i;
-extern PFNGLUNIFORM4IPROC glUniform4i;
-extern PFNGLUNIFORM1FVPROC glUniform1fv;
-extern PFNGLUNIFORM2FVPROC glUniform2fv;
-extern PFNGLUNIFORM3FVPROC glUniform3fv;
-extern PFNGLUNIFORM4FVPROC glUniform4fv;
-extern PFNGLUNIFORM1IVPROC glUniform1iv;
-extern PFNGLUNIFORM2IVPROC glUniform2iv;
-extern PFNGLUNIFORM3IVPROC glUniform3iv;
-extern PFNGLUNIFORM4IVPROC glUniform4iv;
-extern PFNGLUNIFORMMATRIX2FVPROC glUniformMatrix2fv;
-extern PFNGLUNIFORMMATRIX3FVPROC glUniformMatrix3fv;
-extern PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv;
-extern PFNGLGENVERTEXARRAYSPROC glGenVertexArrays;
-extern PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays;
-extern PFNGLBINDVERTEXARRAYPROC glBindVertexArray;
-extern PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer;
-extern PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray;
-extern PFNGLGENBUFFERSPROC glGenBuffers;
-extern PFNGLBINDBUFFERPROC glBindBuffer;
-extern PFNGLBUFFERDATAPROC glBufferData;
-extern PFNGLGENERATEMIPMAPPROC glGenerateMipmap;
-extern PFNGLACTIVETEXTUREPROC glActiveTexture;
+#endif
@@ -0,0 +1,95 @@
+#ifndef OPENGL_FUNCTIONS_H_INCLUDED
+#define OPENGL_FUNCTIONS_H_INCLUDED
+
+#include <GL/glcorearb.h>
+
+// Every GL entry point the renderer calls, including the GL 1.1 ones, goes
+// through a function pointer so the table can be pointed at a fake in tests.
+#define WMCV_OPENGL_FUNCTIONS(X) \
+	X(PFNGLCLEARPROC, glClear) \
+	X(PFNGLCLEARCOLORPROC, glClearColor) \
+	X(PFNGLENABLEPROC, glEnable) \
+	X(PFNGLGETINTEGERVPROC, glGetIntegerv) \
+	X(PFNGLDRAWARRAYSPROC, glDrawArrays) \
+	X(PFNGLDRAWARRAYSINSTANCEDPROC, glDrawArraysInstanced) \
+	X(PFNGLMULTIDRAWELEMENTSINDIRECTPROC, glMultiDrawElementsIndirect) \
+	X(PFNGLGENTEXTURESPROC, glGenTextures) \
+	X(PFNGLBINDTEXTUREPROC, glBindTexture) \
+	X(PFNGLTEXIMAGE2DPROC, glTexImage2D) \
+	X(PFNGLTEXPARAMETERIPROC, glTexParameteri) \
+	X(PFNGLDEBUGMESSAGECALLBACKPROC, glDebugMessageCallback) \
+	X(PFNGLCREATEPROGRAMPROC, glCreateProgram) \
+	X(PFNGLDELETEPROGRAMPROC, glDeleteProgram) \
+	X(PFNGLATTACHSHADERPROC, glAttachShader) \
+	X(PFNGLLINKPROGRAMPROC, glLinkProgram) \
+	X(PFNGLUSEPROGRAMPROC, glUseProgram) \
+	X(PFNGLGETPROGRAMIVPROC, glGetProgramiv) \
+	X(PFNGLGETPROGRAMINFOLOGPROC, glGetProgramInfoLog) \
+	X(PFNGLCREATESHADERPROC, glCreateShader) \
+	X(PFNGLDELETESHADERPROC, glDeleteShader) \
+	X(PFNGLCOMPILESHADERPROC, glCompileShader) \
+	X(PFNGLSHADERSOURCEPROC, glShaderSource) \
+	X(PFNGLGETSHADERIVPROC, glGetShaderiv) \
+	X(PFNGLGETSHADERINFOLOGPROC, glGetShaderInfoLog) \
+	X(PFNGLGETACTIVEUNIFORMPROC, glGetActiveUniform) \
+	X(PFNGLGETUNIFORMLOCATIONPROC, glGetUniformLocation) \
+	X(PFNGLUNIFORM1FPROC, glUniform1f) \
+	X(PFNGLUNIFORM2FPROC, glUniform2f) \
+	X(PFNGLUNIFORM3FPROC, glUniform3f) \
+	X(PFNGLUNIFORM4FPROC, glUniform4f) \
+	X(PFNGLUNIFORM1IPROC, glUniform1i) \
+	X(PFNGLUNIFORM2IPROC, glUniform2i) \
+	X(PFNGLUNIFORM3IPROC, glUniform3i) \
+	X(PFNGLUNIFORM4IPROC, glUniform4i) \
+	X(PFNGLUNIFORM1FVPROC, glUniform1fv) \
+	X(PFNGLUNIFORM2FVPROC, glUniform2fv) \
+	X(PFNGLUNIFORM3FVPROC, glUniform3fv) \
+	X(PFNGLUNIFORM4FVPROC, glUniform4fv) \
+	X(PFNGLUNIFORM1IVPROC, glUniform1iv) \
+	X(PFNGLUNIFORM2IVPROC, glUniform2iv) \
+	X(PFNGLUNIFORM3IVPROC, glUniform3iv) \
+	X(PFNGLUNIFORM4IVPROC, glUniform4iv) \
+	X(PFNGLUNIFORMMATRIX2FVPROC, glUniformMatrix2fv) \
+	X(PFNGLUNIFORMMATRIX3FVPROC, glUniformMatrix3fv) \
+	X(PFNGLUNIFORMMATRIX4FVPROC, glUniformMatrix4fv) \
+	X(PFNGLGENVERTEXARRAYSPROC, glGenVertexArrays) \
+	X(PFNGLDELETEVERTEXARRAYSPROC, glDeleteVertexArrays) \
+	X(PFNGLBINDVERTEXARRAYPROC, glBindVertexArray) \
+	X(PFNGLVERTEXATTRIBPOINTERPROC, glVertexAttribPointer) \
+	X(PFNGLENABLEVERTEXATTRIBARRAYPROC, glEnableVertexAttribArray) \
+	X(PFNGLVERTEXATTRIBFORMATPROC, glVertexAttribFormat) \
+	X(PFNGLVERTEXATTRIBBINDINGPROC, glVertexAttribBinding) \
+	X(PFNGLVERTEXBINDINGDIVISORPROC, glVertexBindingDivisor) \
+	X(PFNGLBINDVERTEXBUFFERPROC, glBindVertexBuffer) \
+	X(PFNGLGENBUFFERSPROC, glGenBuffers) \
+	X(PFNGLBINDBUFFERPROC, glBindBuffer) \
+	X(PFNGLBUFFERDATAPROC, glBufferData) \
+	X(PFNGLBUFFERSUBDATAPROC, glBufferSubData) \
+	X(PFNGLBINDBUFFERBASEPROC, glBindBufferBase) \
+	X(PFNGLBINDBUFFERRANGEPROC, glBindBufferRange) \
+	X(PFNGLDELETEBUFFERSPROC, glDeleteBuffers) \
+	X(PFNGLBUFFERSTORAGEPROC, glBufferStorage) \
+	X(PFNGLMAPBUFFERRANGEPROC, glMapBufferRange) \
+	X(PFNGLUNMAPBUFFERPROC, glUnmapBuffer) \
+	X(PFNGLFENCESYNCPROC, glFenceSync) \
+	X(PFNGLCLIENTWAITSYNCPROC, glClientWaitSync) \
+	X(PFNGLDELETESYNCPROC, glDeleteSync) \
+	X(PFNGLGENERATEMIPMAPPROC, glGenerateMipmap) \
+	X(PFNGLACTIVETEXTUREPROC, glActiveTexture)
+
+#define WMCV_DECLARE_OPENGL_FUNCTION(type, name) extern type name;
+WMCV_OPENGL_FUNCTIONS(WMCV_DECLARE_OPENGL_FUNCTION)
+#undef WMCV_DECLARE_OPENGL_FUNCTION
+
+namespace wmcv
+{
+
+using OpenGLProcLoader = void* (*)(const char* name);
+
+// Resolves every entry of the table through loader and returns how many came
+// back null.
+int LoadOpenGLFunctions(OpenGLProcLoader loader);
+
+} // namespace wmcv
+
+#endif // OPENGL_FUNCTIONS_H_INCLUDED
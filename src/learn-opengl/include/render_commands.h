@@ -0,0 +1,198 @@
+#ifndef RENDER_COMMANDS_H_INCLUDED
+#define RENDER_COMMANDS_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace wmcv
+{
+
+enum class RenderPass : uint8_t
+{
+	Opaque,
+	Emissive,
+	Transparent,
+	Overlay,
+};
+
+// Fields of a 64 bit sort key, most significant first:
+// pass (4) | depth (24) | shader (12) | material (12) | mesh (12).
+struct RenderSortKey
+{
+	RenderPass pass = RenderPass::Opaque;
+	uint32_t depth = 0;
+	uint16_t shader = 0;
+	uint16_t material = 0;
+	uint16_t mesh = 0;
+};
+
+namespace sort_key
+{
+constexpr uint32_t PASS_BITS = 4;
+constexpr uint32_t DEPTH_BITS = 24;
+constexpr uint32_t SHADER_BITS = 12;
+constexpr uint32_t MATERIAL_BITS = 12;
+constexpr uint32_t MESH_BITS = 12;
+
+constexpr uint32_t MESH_SHIFT = 0;
+constexpr uint32_t MATERIAL_SHIFT = MESH_SHIFT + MESH_BITS;
+constexpr uint32_t SHADER_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+constexpr uint32_t DEPTH_SHIFT = SHADER_SHIFT + SHADER_BITS;
+constexpr uint32_t PASS_SHIFT = DEPTH_SHIFT + DEPTH_BITS;
+
+static_assert(PASS_SHIFT + PASS_BITS == 64);
+
+constexpr uint64_t Mask(uint32_t bits) { return (uint64_t{1} << bits) - 1; }
+
+constexpr uint32_t MAX_DEPTH = static_cast<uint32_t>(Mask(DEPTH_BITS));
+} // namespace sort_key
+
+// Fields wider than their slot are truncated to the low bits.
+constexpr uint64_t EncodeSortKey(const RenderSortKey& key)
+{
+	using namespace sort_key;
+	return ((static_cast<uint64_t>(key.pass) & Mask(PASS_BITS)) << PASS_SHIFT) |
+		((key.depth & Mask(DEPTH_BITS)) << DEPTH_SHIFT) |
+		((key.shader & Mask(SHADER_BITS)) << SHADER_SHIFT) |
+		((key.material & Mask(MATERIAL_BITS)) << MATERIAL_SHIFT) |
+		((key.mesh & Mask(MESH_BITS)) << MESH_SHIFT);
+}
+
+constexpr RenderSortKey DecodeSortKey(uint64_t key)
+{
+	using namespace sort_key;
+	return RenderSortKey{
+		.pass = static_cast<RenderPass>((key >> PASS_SHIFT) & Mask(PASS_BITS)),
+		.depth = static_cast<uint32_t>((key >> DEPTH_SHIFT) & Mask(DEPTH_BITS)),
+		.shader = static_cast<uint16_t>((key >> SHADER_SHIFT) & Mask(SHADER_BITS)),
+		.material = static_cast<uint16_t>((key >> MATERIAL_SHIFT) & Mask(MATERIAL_BITS)),
+		.mesh = static_cast<uint16_t>((key >> MESH_SHIFT) & Mask(MESH_BITS))};
+}
+
+// Maps a view space distance in [nearPlane, farPlane] onto the depth field so
+// nearer draws sort first. Back to front passes use MAX_DEPTH minus this.
+uint32_t QuantizeDepth(float distance, float nearPlane, float farPlane);
+
+enum class RenderCommandType : uint8_t
+{
+	DrawArrays,
+	DrawArraysInstanced,
+	MultiDrawElementsIndirect,
+};
+
+struct DrawArraysCommand
+{
+	static constexpr RenderCommandType TYPE = RenderCommandType::DrawArrays;
+
+	uint32_t vertexArray;
+	int32_t first;
+	int32_t count;
+};
+
+struct DrawArraysInstancedCommand
+{
+	static constexpr RenderCommandType TYPE = RenderCommandType::DrawArraysInstanced;
+
+	uint32_t vertexArray;
+	int32_t first;
+	int32_t count;
+	int32_t instanceCount;
+};
+
+// drawCount DrawElementsIndirectCommands read from indirectBuffer at
+// indirectOffset, with 32 bit indices.
+struct MultiDrawElementsIndirectCommand
+{
+	static constexpr RenderCommandType TYPE = RenderCommandType::MultiDrawElementsIndirect;
+
+	uint32_t vertexArray;
+	uint32_t indirectBuffer;
+	uint64_t indirectOffset;
+	int32_t drawCount;
+};
+
+// Linear allocator reset once per frame. A frame that runs out of room chains
+// another block, and the next reset folds everything into one block so a
+// steady frame never allocates.
+class FrameArena
+{
+public:
+	explicit FrameArena(size_t capacity);
+
+	void* allocate(size_t size, size_t alignment);
+	void reset();
+
+	inline size_t used() const { return m_used; }
+	size_t capacity() const;
+	inline size_t blockCount() const { return m_blocks.size(); }
+
+private:
+	struct Block
+	{
+		std::unique_ptr<std::byte[]> memory;
+		size_t size;
+	};
+
+	std::vector<Block> m_blocks;
+	size_t m_offset = 0;
+	size_t m_used = 0;
+};
+
+struct RenderCommandEntry
+{
+	uint64_t key;
+	const void* command;
+	RenderCommandType type;
+};
+
+// Sorts entries by key, stable for equal keys. scratch must be at least as
+// large as entries.
+void RadixSortByKey(std::span<RenderCommandEntry> entries, std::span<RenderCommandEntry> scratch);
+
+// POD draw commands for one frame. Commands are copied into the arena and
+// referenced from a key/pointer list, which is all that sort() moves.
+class RenderCommandBuffer
+{
+public:
+	explicit RenderCommandBuffer(size_t arenaBytes = 64 * 1024);
+
+	template <typename T>
+	void push(uint64_t key, const T& command)
+	{
+		static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>);
+		void* memory = m_arena.allocate(sizeof(T), alignof(T));
+		std::memcpy(memory, &command, sizeof(T));
+		m_entries.push_back(RenderCommandEntry{key, memory, T::TYPE});
+	}
+
+	void sort();
+	void reset();
+
+	inline std::span<const RenderCommandEntry> commands() const { return m_entries; }
+	inline size_t size() const { return m_entries.size(); }
+	inline const FrameArena& arena() const { return m_arena; }
+
+private:
+	FrameArena m_arena;
+	std::vector<RenderCommandEntry> m_entries;
+	std::vector<RenderCommandEntry> m_scratch;
+};
+
+// Callers switch on entry.type before reading the command back.
+template <typename T>
+const T& CommandAs(const RenderCommandEntry& entry)
+{
+	return *static_cast<const T*>(entry.command);
+}
+
+// Issues the GL draw for a single command.
+void ExecuteRenderCommand(const RenderCommandEntry& entry);
+
+} // namespace wmcv
+
+#endif // RENDER_COMMANDS_H_INCLUDED
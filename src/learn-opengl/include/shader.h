@@ -7,31 +7,143 @@
 namespace wmcv
 {
 
+// FNV-1a; 0 is reserved for empty slots in UniformLocationTable.
+constexpr uint64_t HashUniformName(std::string_view name)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (const char c : name)
+	{
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash != 0 ? hash : 1;
+}
+
+// A resolved uniform. Only valid for the Shader that produced it.
+template <typename T>
+struct UniformHandle
+{
+	int32_t location = -1;
+	int32_t slot = -1;
+
+	constexpr bool valid() const { return slot >= 0; }
+};
+
+// Open addressed map from uniform name hash to the shader's uniform slot,
+// filled once after the program links so lookups never go back to the driver.
+class UniformNameTable
+{
+public:
+	void clear();
+	void insert(uint64_t hash, int32_t value);
+
+	inline int32_t find(uint64_t hash) const
+	{
+		if (m_slots.empty())
+			return -1;
+
+		const size_t mask = m_slots.size() - 1;
+		for (size_t i = hash & mask;; i = (i + 1) & mask)
+		{
+			const Slot& slot = m_slots[i];
+			if (slot.hash == hash)
+				return slot.value;
+			if (slot.hash == 0)
+				return -1;
+		}
+	}
+
+	inline size_t size() const { return m_count; }
+
+private:
+	struct Slot
+	{
+		uint64_t hash = 0;
+		int32_t value = -1;
+	};
+
+	void grow();
+
+	std::vector<Slot> m_slots;
+	size_t m_count = 0;
+};
+
+struct UniformUploadStats
+{
+	uint32_t uploaded = 0;
+	uint32_t skipped = 0;
+};
+
 struct Shader
 {
 	Shader() = default;
 	Shader(const std::filesystem::path& vertexPath, const std::filesystem::path& fragmentPath);
 	~Shader();
 
-	Shader(Shader&&) = default;
-	Shader& operator=(Shader&&) = default;
+	Shader(Shader&& other) noexcept;
+	Shader& operator=(Shader&& other) noexcept;
 	Shader(const Shader&) = delete;
 	Shader& operator=(const Shader&) = delete;
 
 	void on();
 	void off();
 
-	void setBool(const std::string_view name, bool value) const;
-	void setInt(const std::string_view name, int value) const;
-	void setFloat(const std::string_view name, float value) const;
-	void setVec2(const std::string_view name, glm::vec2 value) const;
-	void setVec3(const std::string_view name, glm::vec3 value) const;
-	void setVec4(const std::string_view name, glm::vec4 value) const;
+	template <typename T>
+	inline UniformHandle<T> uniform(const std::string_view name) const
+	{
+		const int32_t slot = m_names.find(HashUniformName(name));
+		if (slot < 0)
+			return {};
+
+		return UniformHandle<T>{m_slots[static_cast<size_t>(slot)].location, slot};
+	}
+
+	inline size_t uniformCount() const { return m_names.size(); }
+
+	// Setters keep the last value sent for every uniform and only call
+	// glUniform* when the bytes change. The shader must be bound.
+	inline UniformUploadStats uploadStats() const { return m_uploadStats; }
+	inline void resetUploadStats() { m_uploadStats = {}; }
+
+	void set(UniformHandle<bool> handle, bool value);
+	void set(UniformHandle<int> handle, int value);
+	void set(UniformHandle<float> handle, float value);
+	void set(UniformHandle<glm::vec2> handle, glm::vec2 value);
+	void set(UniformHandle<glm::vec3> handle, glm::vec3 value);
+	void set(UniformHandle<glm::vec4> handle, glm::vec4 value);
+	void set(UniformHandle<glm::mat2> handle, const glm::mat2& value);
+	void set(UniformHandle<glm::mat3> handle, const glm::mat3& value);
+	void set(UniformHandle<glm::mat4> handle, const glm::mat4& value);
+
+	void setBool(const std::string_view name, bool value);
+	void setInt(const std::string_view name, int value);
+	void setFloat(const std::string_view name, float value);
+	void setVec2(const std::string_view name, glm::vec2 value);
+	void setVec3(const std::string_view name, glm::vec3 value);
+	void setVec4(const std::string_view name, glm::vec4 value);
 	void setMat2(const std::string_view name, const glm::mat2& mat);
 	void setMat3(const std::string_view name, const glm::mat3& mat);
 	void setMat4(const std::string_view name, const glm::mat4& mat);
 
-	unsigned int m_programId;
+	unsigned int m_programId = 0;
+
+private:
+	struct UniformSlot
+	{
+		int32_t location = -1;
+		uint32_t offset = 0;
+		uint32_t size = 0;
+		bool written = false;
+	};
+
+	void buildUniformTable();
+	void addUniform(std::string_view name, int32_t location, uint32_t size);
+	bool changed(int32_t slot, const void* value, uint32_t size);
+
+	UniformNameTable m_names;
+	std::vector<UniformSlot> m_slots;
+	std::vector<std::byte> m_shadow;
+	UniformUploadStats m_uploadStats;
 };
 
 } // namespace wmcv
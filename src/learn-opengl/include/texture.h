@@ -11,9 +11,9 @@ namespace wmcv
 		Texture(const std::filesystem::path& path, bool flip);
 
 		void on(uint32_t slot);
-		void off();
+		void off(uint32_t slot);
 
-		uint32_t m_textureId;
+		uint32_t m_textureId = 0;
 	};
 }
 
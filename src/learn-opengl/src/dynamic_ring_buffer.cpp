@@ -0,0 +1,160 @@
+#include "pch.h"
+#include "dynamic_ring_buffer.h"
+#include "opengl_functions.h"
+
+namespace wmcv
+{
+
+namespace
+{
+
+GLsync AsSync(FenceHandle fence)
+{
+	return static_cast<GLsync>(fence);
+}
+
+constexpr GLbitfield MAP_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+} // namespace
+
+FenceHandle GLFenceProvider::insert()
+{
+	return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool GLFenceProvider::signaled(FenceHandle fence)
+{
+	const GLenum result = glClientWaitSync(AsSync(fence), 0, 0);
+	return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+
+void GLFenceProvider::wait(FenceHandle fence)
+{
+	constexpr GLuint64 ONE_SECOND = 1'000'000'000;
+	GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	for (;;)
+	{
+		const GLenum result = glClientWaitSync(AsSync(fence), flags, ONE_SECOND);
+		if (result != GL_TIMEOUT_EXPIRED)
+			return;
+		flags = 0;
+	}
+}
+
+void GLFenceProvider::release(FenceHandle fence)
+{
+	glDeleteSync(AsSync(fence));
+}
+
+FrameRegionRing::FrameRegionRing(size_t regionSize, uint32_t regionCount, FenceProvider& fences)
+	: m_fenceProvider(fences)
+	, m_fences(std::max(regionCount, 1u), nullptr)
+	, m_regionSize(regionSize)
+	, m_region(static_cast<uint32_t>(m_fences.size()) - 1)
+{
+}
+
+FrameRegionRing::~FrameRegionRing()
+{
+	for (FenceHandle fence : m_fences)
+	{
+		if (fence)
+			m_fenceProvider.release(fence);
+	}
+}
+
+void FrameRegionRing::beginFrame()
+{
+	m_region = (m_region + 1) % regionCount();
+	m_offset = 0;
+	++m_stats.frames;
+
+	if (FenceHandle& fence = m_fences[m_region]; fence)
+	{
+		if (!m_fenceProvider.signaled(fence))
+		{
+			++m_stats.stalls;
+			m_fenceProvider.wait(fence);
+		}
+		m_fenceProvider.release(fence);
+		fence = nullptr;
+	}
+}
+
+void FrameRegionRing::endFrame()
+{
+	FenceHandle& fence = m_fences[m_region];
+	if (fence)
+		m_fenceProvider.release(fence);
+	fence = m_fenceProvider.insert();
+}
+
+size_t FrameRegionRing::allocate(size_t size, size_t alignment)
+{
+	const size_t offset = (m_offset + alignment - 1) / alignment * alignment;
+	if (offset + size > m_regionSize)
+		return INVALID_OFFSET;
+
+	m_offset = offset + size;
+	return m_region * m_regionSize + offset;
+}
+
+DynamicRingBuffer::DynamicRingBuffer(size_t regionSize, uint32_t framesInFlight, FenceProvider& fences)
+	: m_regions(regionSize, framesInFlight, fences)
+{
+	GLint uniformAlignment = 1;
+	GLint storageAlignment = 1;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+	m_alignment = static_cast<size_t>(std::max({uniformAlignment, storageAlignment, 1}));
+
+	const auto size = static_cast<GLsizeiptr>(regionSize * m_regions.regionCount());
+	glGenBuffers(1, &m_bufferId);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, m_bufferId);
+	glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, MAP_FLAGS);
+	m_mapped = static_cast<std::byte*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, MAP_FLAGS));
+}
+
+DynamicRingBuffer::~DynamicRingBuffer()
+{
+	if (m_bufferId != 0)
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, m_bufferId);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		glDeleteBuffers(1, &m_bufferId);
+	}
+}
+
+void DynamicRingBuffer::beginFrame()
+{
+	m_regions.beginFrame();
+}
+
+void DynamicRingBuffer::endFrame()
+{
+	m_regions.endFrame();
+}
+
+size_t DynamicRingBuffer::RegionSizeFor(std::initializer_list<size_t> sizes)
+{
+	size_t total = 0;
+	for (const size_t size : sizes)
+		total += (size + MAX_ALIGNMENT - 1) / MAX_ALIGNMENT * MAX_ALIGNMENT;
+	return total;
+}
+
+DynamicAllocation DynamicRingBuffer::allocate(size_t size)
+{
+	const size_t offset = m_regions.allocate(size, m_alignment);
+	if (offset == FrameRegionRing::INVALID_OFFSET || !m_mapped)
+		return {};
+
+	return DynamicAllocation{m_mapped + offset, offset, size};
+}
+
+void DynamicRingBuffer::bindRange(uint32_t target, uint32_t index, const DynamicAllocation& allocation) const
+{
+	glBindBufferRange(target, index, m_bufferId, static_cast<GLintptr>(allocation.offset), static_cast<GLsizeiptr>(allocation.size));
+}
+
+} // namespace wmcv
@@ -0,0 +1,263 @@
+#include "pch.h"
+#include "frustum_culling.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define WMCV_CULLING_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define WMCV_TARGET_AVX
+#else
+#define WMCV_TARGET_AVX __attribute__((target("avx")))
+#endif
+#else
+#define WMCV_CULLING_X86 0
+#endif
+
+namespace wmcv
+{
+
+namespace
+{
+
+void CullScalar(const Frustum& frustum, const CullingBounds& bounds, uint32_t* out, size_t& written)
+{
+	for (size_t i = 0; i < bounds.size(); ++i)
+	{
+		// Same operation order as the SIMD paths so all three agree exactly.
+		bool inside = true;
+		for (const glm::vec4& plane : frustum.planes)
+		{
+			const float distance = (bounds.centers(0)[i] * plane.x + bounds.centers(1)[i] * plane.y) + (bounds.centers(2)[i] * plane.z + plane.w);
+			const float radius = (bounds.extents(0)[i] * std::abs(plane.x) + bounds.extents(1)[i] * std::abs(plane.y)) + bounds.extents(2)[i] * std::abs(plane.z);
+			inside = inside && distance + radius >= 0.f;
+		}
+
+		if (inside)
+			out[written++] = static_cast<uint32_t>(i);
+	}
+}
+
+// Appends base + the index of every set bit below count - base.
+inline void EmitLanes(uint32_t mask, size_t base, size_t count, uint32_t* out, size_t& written)
+{
+	if (count - base < 32)
+		mask &= (1u << (count - base)) - 1;
+
+	while (mask != 0)
+	{
+		out[written++] = static_cast<uint32_t>(base) + static_cast<uint32_t>(std::countr_zero(mask));
+		mask &= mask - 1;
+	}
+}
+
+#if WMCV_CULLING_X86
+
+void CullSSE(const Frustum& frustum, const CullingBounds& bounds, uint32_t* out, size_t& written)
+{
+	const __m128 zero = _mm_setzero_ps();
+	for (size_t base = 0; base < bounds.size(); base += 4)
+	{
+		const __m128 cx = _mm_loadu_ps(bounds.centers(0) + base);
+		const __m128 cy = _mm_loadu_ps(bounds.centers(1) + base);
+		const __m128 cz = _mm_loadu_ps(bounds.centers(2) + base);
+		const __m128 ex = _mm_loadu_ps(bounds.extents(0) + base);
+		const __m128 ey = _mm_loadu_ps(bounds.extents(1) + base);
+		const __m128 ez = _mm_loadu_ps(bounds.extents(2) + base);
+
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (const glm::vec4& plane : frustum.planes)
+		{
+			__m128 distance = _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane.x)), _mm_mul_ps(cy, _mm_set1_ps(plane.y)));
+			distance = _mm_add_ps(distance, _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+			__m128 radius = _mm_add_ps(_mm_mul_ps(ex, _mm_set1_ps(std::abs(plane.x))), _mm_mul_ps(ey, _mm_set1_ps(std::abs(plane.y))));
+			radius = _mm_add_ps(radius, _mm_mul_ps(ez, _mm_set1_ps(std::abs(plane.z))));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+		}
+
+		EmitLanes(static_cast<uint32_t>(_mm_movemask_ps(inside)), base, bounds.size(), out, written);
+	}
+}
+
+WMCV_TARGET_AVX void CullAVX(const Frustum& frustum, const CullingBounds& bounds, uint32_t* out, size_t& written)
+{
+	const __m256 zero = _mm256_setzero_ps();
+	for (size_t base = 0; base < bounds.size(); base += 8)
+	{
+		const __m256 cx = _mm256_loadu_ps(bounds.centers(0) + base);
+		const __m256 cy = _mm256_loadu_ps(bounds.centers(1) + base);
+		const __m256 cz = _mm256_loadu_ps(bounds.centers(2) + base);
+		const __m256 ex = _mm256_loadu_ps(bounds.extents(0) + base);
+		const __m256 ey = _mm256_loadu_ps(bounds.extents(1) + base);
+		const __m256 ez = _mm256_loadu_ps(bounds.extents(2) + base);
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (const glm::vec4& plane : frustum.planes)
+		{
+			__m256 distance = _mm256_add_ps(_mm256_mul_ps(cx, _mm256_set1_ps(plane.x)), _mm256_mul_ps(cy, _mm256_set1_ps(plane.y)));
+			distance = _mm256_add_ps(distance, _mm256_add_ps(_mm256_mul_ps(cz, _mm256_set1_ps(plane.z)), _mm256_set1_ps(plane.w)));
+			__m256 radius = _mm256_add_ps(_mm256_mul_ps(ex, _mm256_set1_ps(std::abs(plane.x))), _mm256_mul_ps(ey, _mm256_set1_ps(std::abs(plane.y))));
+			radius = _mm256_add_ps(radius, _mm256_mul_ps(ez, _mm256_set1_ps(std::abs(plane.z))));
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+		}
+
+		EmitLanes(static_cast<uint32_t>(_mm256_movemask_ps(inside)), base, bounds.size(), out, written);
+	}
+}
+
+bool CpuHasAVX()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+	return osSavesYmm && (info[2] & (1 << 28)) != 0;
+#else
+	return __builtin_cpu_supports("avx");
+#endif
+}
+
+#endif
+
+} // namespace
+
+Frustum ExtractFrustum(const glm::mat4& viewProjection)
+{
+	const auto row = [&viewProjection](int i)
+	{
+		return glm::vec4{viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]};
+	};
+
+	const glm::vec4 x = row(0);
+	const glm::vec4 y = row(1);
+	const glm::vec4 z = row(2);
+	const glm::vec4 w = row(3);
+
+	Frustum frustum{{w + x, w - x, w + y, w - y, w + z, w - z}};
+	for (glm::vec4& plane : frustum.planes)
+		plane /= glm::length(glm::vec3{plane});
+	return frustum;
+}
+
+void CullingBounds::clear()
+{
+	for (uint32_t axis = 0; axis < 3; ++axis)
+	{
+		m_centers[axis].clear();
+		m_extents[axis].clear();
+	}
+	m_count = 0;
+}
+
+void CullingBounds::reserve(size_t count)
+{
+	const size_t padded = (count + LANES - 1) / LANES * LANES;
+	for (uint32_t axis = 0; axis < 3; ++axis)
+	{
+		m_centers[axis].reserve(padded);
+		m_extents[axis].reserve(padded);
+	}
+}
+
+uint32_t CullingBounds::add(const glm::vec3& center, const glm::vec3& extents)
+{
+	const auto index = static_cast<uint32_t>(m_count++);
+	if (index % LANES == 0)
+	{
+		for (uint32_t axis = 0; axis < 3; ++axis)
+		{
+			m_centers[axis].resize(index + LANES, 0.f);
+			m_extents[axis].resize(index + LANES, 0.f);
+		}
+	}
+
+	for (uint32_t axis = 0; axis < 3; ++axis)
+	{
+		m_centers[axis][index] = center[static_cast<int>(axis)];
+		m_extents[axis][index] = extents[static_cast<int>(axis)];
+	}
+	return index;
+}
+
+uint32_t CullingBounds::addTransformedBox(const glm::mat4& model, const glm::vec3& halfExtents)
+{
+	// Each world axis takes the absolute contribution of every local axis.
+	glm::vec3 extents{0.f};
+	for (int local = 0; local < 3; ++local)
+		extents += glm::abs(glm::vec3{model[local]}) * halfExtents[local];
+
+	return add(glm::vec3{model[3]}, extents);
+}
+
+glm::vec3 CullingBounds::boxCenter(uint32_t index) const
+{
+	return glm::vec3{m_centers[0][index], m_centers[1][index], m_centers[2][index]};
+}
+
+glm::vec3 CullingBounds::boxExtents(uint32_t index) const
+{
+	return glm::vec3{m_extents[0][index], m_extents[1][index], m_extents[2][index]};
+}
+
+bool CullingPathSupported(CullingPath path)
+{
+	switch (path)
+	{
+	case CullingPath::Scalar:
+		return true;
+#if WMCV_CULLING_X86
+	case CullingPath::SSE:
+		return true;
+	case CullingPath::AVX:
+		return CpuHasAVX();
+#else
+	case CullingPath::SSE:
+	case CullingPath::AVX:
+		return false;
+#endif
+	}
+	return false;
+}
+
+CullingPath BestCullingPath()
+{
+	static const CullingPath best = []
+	{
+		if (CullingPathSupported(CullingPath::AVX))
+			return CullingPath::AVX;
+		if (CullingPathSupported(CullingPath::SSE))
+			return CullingPath::SSE;
+		return CullingPath::Scalar;
+	}();
+	return best;
+}
+
+void CullFrustum(const Frustum& frustum, const CullingBounds& bounds, std::vector<uint32_t>& visible, CullingPath path)
+{
+	// Sized for everything passing, then trimmed to what did.
+	visible.resize(bounds.size());
+	size_t written = 0;
+
+	switch (CullingPathSupported(path) ? path : CullingPath::Scalar)
+	{
+	case CullingPath::Scalar:
+		CullScalar(frustum, bounds, visible.data(), written);
+		break;
+#if WMCV_CULLING_X86
+	case CullingPath::SSE:
+		CullSSE(frustum, bounds, visible.data(), written);
+		break;
+	case CullingPath::AVX:
+		CullAVX(frustum, bounds, visible.data(), written);
+		break;
+#else
+	case CullingPath::SSE:
+	case CullingPath::AVX:
+		break;
+#endif
+	}
+
+	visible.resize(written);
+}
+
+} // namespace wmcv
@@ -0,0 +1,94 @@
+#include "pch.h"
+#include "gl_state.h"
+#include "opengl_functions.h"
+
+namespace wmcv
+{
+
+GLStateCache::GLStateCache()
+{
+	invalidate();
+}
+
+void GLStateCache::useProgram(uint32_t program)
+{
+	if (update(m_program, program))
+		glUseProgram(program);
+}
+
+void GLStateCache::bindVertexArray(uint32_t vertexArray)
+{
+	if (update(m_vertexArray, vertexArray))
+		glBindVertexArray(vertexArray);
+}
+
+void GLStateCache::activeTexture(uint32_t unit)
+{
+	if (update(m_activeUnit, unit))
+		glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GLStateCache::bindTexture(uint32_t unit, uint32_t texture)
+{
+	assert(unit < MAX_TEXTURE_UNITS);
+	if (m_textures[unit] == texture)
+	{
+		++m_stats.elided;
+		return;
+	}
+
+	activeTexture(unit);
+	m_textures[unit] = texture;
+	++m_stats.issued;
+	glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void GLStateCache::forgetProgram(uint32_t program)
+{
+	if (m_program == program)
+		m_program = UNKNOWN;
+}
+
+void GLStateCache::forgetVertexArray(uint32_t vertexArray)
+{
+	if (m_vertexArray == vertexArray)
+		m_vertexArray = UNKNOWN;
+}
+
+void GLStateCache::forgetTexture(uint32_t texture)
+{
+	for (uint32_t& bound : m_textures)
+	{
+		if (bound == texture)
+			bound = UNKNOWN;
+	}
+}
+
+void GLStateCache::invalidate()
+{
+	m_program = UNKNOWN;
+	m_vertexArray = UNKNOWN;
+	m_activeUnit = UNKNOWN;
+	m_textures.fill(UNKNOWN);
+}
+
+bool GLStateCache::update(uint32_t& current, uint32_t value)
+{
+	if (current == value)
+	{
+		++m_stats.elided;
+		return false;
+	}
+
+	current = value;
+	++m_stats.issued;
+	return true;
+}
+
+GLStateCache& GetGLState()
+{
+	static GLStateCache s_state;
+	return s_state;
+}
+
+} // namespace wmcv
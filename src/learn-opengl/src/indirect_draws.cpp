@@ -0,0 +1,78 @@
+#include "pch.h"
+#include "indirect_draws.h"
+
+namespace wmcv
+{
+
+void IndirectDrawBuilder::reset()
+{
+	m_commands.clear();
+	m_instances.clear();
+}
+
+void IndirectDrawBuilder::reserve(size_t commands, size_t instances)
+{
+	m_commands.reserve(commands);
+	m_instances.reserve(instances);
+}
+
+void IndirectDrawBuilder::add(const MeshRange& mesh, const MeshInstance& instance)
+{
+	add(mesh, std::span{&instance, 1});
+}
+
+void IndirectDrawBuilder::add(const MeshRange& mesh, std::span<const MeshInstance> instances)
+{
+	if (instances.empty())
+		return;
+
+	// Instances are only ever appended, so the last command always ends at
+	// the end of the stream and can simply grow.
+	if (!m_commands.empty())
+	{
+		DrawElementsIndirectCommand& last = m_commands.back();
+		if (MeshRange{last.count, last.firstIndex, last.baseVertex} == mesh)
+		{
+			last.instanceCount += static_cast<uint32_t>(instances.size());
+			m_instances.insert(m_instances.end(), instances.begin(), instances.end());
+			return;
+		}
+	}
+
+	m_commands.push_back(DrawElementsIndirectCommand{
+		.count = mesh.indexCount,
+		.instanceCount = static_cast<uint32_t>(instances.size()),
+		.firstIndex = mesh.firstIndex,
+		.baseVertex = mesh.baseVertex,
+		.baseInstance = static_cast<uint32_t>(m_instances.size())});
+	m_instances.insert(m_instances.end(), instances.begin(), instances.end());
+}
+
+void IndirectDrawBuilder::build(std::span<const MeshRange> meshes, std::span<const uint32_t> objectMeshes, std::span<const MeshInstance> objectInstances)
+{
+	m_meshOffsets.assign(meshes.size() + 1, 0);
+	for (const uint32_t mesh : objectMeshes)
+		++m_meshOffsets[mesh + 1];
+
+	const auto base = static_cast<uint32_t>(m_instances.size());
+	for (size_t mesh = 0; mesh < meshes.size(); ++mesh)
+	{
+		const uint32_t count = m_meshOffsets[mesh + 1];
+		m_meshOffsets[mesh + 1] = m_meshOffsets[mesh] + count;
+		if (count == 0)
+			continue;
+
+		m_commands.push_back(DrawElementsIndirectCommand{
+			.count = meshes[mesh].indexCount,
+			.instanceCount = count,
+			.firstIndex = meshes[mesh].firstIndex,
+			.baseVertex = meshes[mesh].baseVertex,
+			.baseInstance = base + m_meshOffsets[mesh]});
+	}
+
+	m_instances.resize(base + objectInstances.size());
+	for (size_t object = 0; object < objectInstances.size(); ++object)
+		m_instances[base + m_meshOffsets[objectMeshes[object]]++] = objectInstances[object];
+}
+
+} // namespace wmcv
@@ -0,0 +1,44 @@
+#include "pch.h"
+#include "instance_buffer.h"
+#include "opengl_functions.h"
+#include "gl_state.h"
+
+namespace wmcv
+{
+
+MeshInstance MakeMeshInstance(const glm::mat4& model)
+{
+	return MeshInstance{model, glm::transpose(glm::inverse(glm::mat3(model)))};
+}
+
+void SetupInstanceAttributes(uint32_t vertexArray)
+{
+	GetGLState().bindVertexArray(vertexArray);
+
+	for (uint32_t column = 0; column < 4; ++column)
+	{
+		const auto offset = static_cast<GLuint>(offsetof(MeshInstance, model) + sizeof(glm::vec4) * column);
+		glVertexAttribFormat(INSTANCE_MODEL_ATTRIBUTE + column, 4, GL_FLOAT, GL_FALSE, offset);
+		glVertexAttribBinding(INSTANCE_MODEL_ATTRIBUTE + column, INSTANCE_BINDING);
+		glEnableVertexAttribArray(INSTANCE_MODEL_ATTRIBUTE + column);
+	}
+
+	for (uint32_t column = 0; column < 3; ++column)
+	{
+		const auto offset = static_cast<GLuint>(offsetof(MeshInstance, normal) + sizeof(glm::vec3) * column);
+		glVertexAttribFormat(INSTANCE_NORMAL_ATTRIBUTE + column, 3, GL_FLOAT, GL_FALSE, offset);
+		glVertexAttribBinding(INSTANCE_NORMAL_ATTRIBUTE + column, INSTANCE_BINDING);
+		glEnableVertexAttribArray(INSTANCE_NORMAL_ATTRIBUTE + column);
+	}
+
+	glVertexBindingDivisor(INSTANCE_BINDING, 1);
+	GetGLState().bindVertexArray(0);
+}
+
+void BindInstanceStream(uint32_t vertexArray, uint32_t buffer, size_t offset)
+{
+	GetGLState().bindVertexArray(vertexArray);
+	glBindVertexBuffer(INSTANCE_BINDING, buffer, static_cast<GLintptr>(offset), static_cast<GLsizei>(sizeof(MeshInstance)));
+}
+
+} // namespace wmcv
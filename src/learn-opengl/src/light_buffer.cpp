@@ -0,0 +1,20 @@
+#include "pch.h"
+#include "light_buffer.h"
+
+namespace wmcv
+{
+
+size_t PointLightBufferSize(size_t count)
+{
+	return sizeof(PointLightBufferHeader) + sizeof(PointLight) * count;
+}
+
+void WritePointLightBuffer(std::span<const PointLight> lights, std::byte* destination)
+{
+	const PointLightBufferHeader header{static_cast<uint32_t>(lights.size()), {}};
+	std::memcpy(destination, &header, sizeof(header));
+	if (!lights.empty())
+		std::memcpy(destination + sizeof(header), lights.data(), lights.size_bytes());
+}
+
+} // namespace wmcv
@@ -2,12 +2,18 @@
 #include "application.h"
 
 #include "wmcv_log\wmcv_log.h"
+#include "wmcv_log\wmcv_async_log_system.h"
 #include "wmcv_log\sinks\wmcv_sink_outputdbgstring.h"
+#include "wmcv_log\sinks\wmcv_sink_mappedfile.h"
+#include "wmcv_log\sinks\wmcv_sink_flightrecorder.h"
 
 auto main() -> int
 {
-	wmcv::CreateDefaultLogSystem();
+	wmcv::AsyncLogSystem logSystem;
+	wmcv::SetLogSystem(&logSystem);
 	wmcv::GetLogSystem().PushSink(wmcv::LogSinkOutputDebugString{});
+	wmcv::GetLogSystem().PushSink(wmcv::LogSinkMappedFile{{.path = "learn-opengl.log"}});
+	wmcv::GetLogSystem().PushSink(wmcv::LogSinkFlightRecorder{{.path = "learn-opengl.flight"}});
 
 	auto app = wmcv::IApplication::Create();
 	return app->run();
@@ -0,0 +1,322 @@
+#include "pch.h"
+#include "occlusion_culling.h"
+#include "frustum_culling.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define WMCV_OCCLUSION_SSE 1
+#include <immintrin.h>
+#else
+#define WMCV_OCCLUSION_SSE 0
+#endif
+
+namespace wmcv
+{
+
+namespace
+{
+
+constexpr float FAR_DEPTH = 1.f;
+
+constexpr std::array<glm::vec3, 8> BOX_CORNERS = {
+	glm::vec3{-1.f, -1.f, -1.f}, glm::vec3{1.f, -1.f, -1.f}, glm::vec3{1.f, 1.f, -1.f}, glm::vec3{-1.f, 1.f, -1.f},
+	glm::vec3{-1.f, -1.f, 1.f}, glm::vec3{1.f, -1.f, 1.f}, glm::vec3{1.f, 1.f, 1.f}, glm::vec3{-1.f, 1.f, 1.f},
+};
+
+constexpr std::array<uint32_t, 36> BOX_INDICES = {
+	0, 2, 1, 0, 3, 2,	// -z
+	4, 5, 6, 4, 6, 7,	// +z
+	0, 4, 7, 0, 7, 3,	// -x
+	1, 2, 6, 1, 6, 5,	// +x
+	0, 1, 5, 0, 5, 4,	// -y
+	3, 7, 6, 3, 6, 2,	// +y
+};
+
+// Signed distance to the GL near plane, z >= -w.
+inline float NearDistance(const glm::vec4& v)
+{
+	return v.z + v.w;
+}
+
+} // namespace
+
+OcclusionBuffer::OcclusionBuffer(uint32_t width, uint32_t height, uint32_t threadCount)
+	: m_width((width + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE)
+	, m_height((height + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE)
+	, m_tilesX(m_width / TILE_SIZE)
+	, m_tilesY(m_height / TILE_SIZE)
+	, m_depth(static_cast<size_t>(m_width) * m_height, FAR_DEPTH)
+{
+	const uint32_t workers = std::clamp(threadCount, 1u, tileCount()) - 1;
+	m_workers.reserve(workers);
+	for (uint32_t i = 0; i < workers; ++i)
+		m_workers.emplace_back([this](std::stop_token stop) { runWorker(stop); });
+}
+
+OcclusionBuffer::~OcclusionBuffer()
+{
+	for (std::jthread& worker : m_workers)
+		worker.request_stop();
+	m_generation.fetch_add(1, std::memory_order_release);
+	m_generation.notify_all();
+}
+
+void OcclusionBuffer::begin(const glm::mat4& viewProjection)
+{
+	m_viewProjection = viewProjection;
+	m_triangles.clear();
+	m_stats = OcclusionStats{};
+}
+
+void OcclusionBuffer::addOccluder(const glm::mat4& model, std::span<const glm::vec3> vertices, std::span<const uint32_t> indices)
+{
+	const glm::mat4 modelViewProjection = m_viewProjection * model;
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		addClipTriangle(
+			modelViewProjection * glm::vec4{vertices[indices[i]], 1.f},
+			modelViewProjection * glm::vec4{vertices[indices[i + 1]], 1.f},
+			modelViewProjection * glm::vec4{vertices[indices[i + 2]], 1.f});
+	}
+}
+
+void OcclusionBuffer::addOccluderBox(const glm::mat4& model, const glm::vec3& halfExtents)
+{
+	std::array<glm::vec3, 8> corners;
+	for (size_t i = 0; i < corners.size(); ++i)
+		corners[i] = BOX_CORNERS[i] * halfExtents;
+
+	addOccluder(model, corners, BOX_INDICES);
+}
+
+void OcclusionBuffer::addClipTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+{
+	// Clip against the near plane so every vertex has w > 0, the other
+	// planes are handled by bounding the triangle to the screen.
+	const std::array<glm::vec4, 3> in{a, b, c};
+	std::array<glm::vec4, 4> clipped;
+	size_t count = 0;
+	for (size_t i = 0; i < in.size(); ++i)
+	{
+		const glm::vec4& from = in[i];
+		const glm::vec4& to = in[(i + 1) % in.size()];
+		const float fromDistance = NearDistance(from);
+		const float toDistance = NearDistance(to);
+
+		if (fromDistance >= 0.f)
+			clipped[count++] = from;
+		if ((fromDistance >= 0.f) != (toDistance >= 0.f))
+			clipped[count++] = from + (to - from) * (fromDistance / (fromDistance - toDistance));
+	}
+
+	const auto toScreen = [this](const glm::vec4& v)
+	{
+		return glm::vec3{
+			(v.x / v.w * 0.5f + 0.5f) * static_cast<float>(m_width),
+			(v.y / v.w * 0.5f + 0.5f) * static_cast<float>(m_height),
+			v.z / v.w};
+	};
+
+	for (size_t i = 2; i < count; ++i)
+		addScreenTriangle(toScreen(clipped[0]), toScreen(clipped[i - 1]), toScreen(clipped[i]));
+}
+
+void OcclusionBuffer::addScreenTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+{
+	// Both windings are drawn, so flip clockwise triangles around.
+	const float area = (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+	if (std::abs(area) < 1e-6f)
+		return;
+
+	const glm::vec3& v0 = a;
+	const glm::vec3& v1 = area > 0.f ? b : c;
+	const glm::vec3& v2 = area > 0.f ? c : b;
+	const float signedArea = std::abs(area);
+
+	ScreenTriangle triangle;
+	triangle.minX = std::max(std::min({v0.x, v1.x, v2.x}), 0.f);
+	triangle.minY = std::max(std::min({v0.y, v1.y, v2.y}), 0.f);
+	triangle.maxX = std::min(std::max({v0.x, v1.x, v2.x}), static_cast<float>(m_width));
+	triangle.maxY = std::min(std::max({v0.y, v1.y, v2.y}), static_cast<float>(m_height));
+	if (triangle.minX >= triangle.maxX || triangle.minY >= triangle.maxY)
+		return;
+
+	const auto edge = [](const glm::vec3& from, const glm::vec3& to)
+	{
+		return glm::vec3{from.y - to.y, to.x - from.x, from.x * to.y - from.y * to.x};
+	};
+	triangle.edges = {edge(v0, v1), edge(v1, v2), edge(v2, v0)};
+
+	// NDC z is affine in screen space, so depth is a plane over the triangle.
+	const float dx1 = v1.x - v0.x, dy1 = v1.y - v0.y, dz1 = v1.z - v0.z;
+	const float dx2 = v2.x - v0.x, dy2 = v2.y - v0.y, dz2 = v2.z - v0.z;
+	const float depthX = (dz1 * dy2 - dz2 * dy1) / signedArea;
+	const float depthY = (dx1 * dz2 - dx2 * dz1) / signedArea;
+	triangle.depth = glm::vec3{depthX, depthY, v0.z - depthX * v0.x - depthY * v0.y};
+
+	m_triangles.push_back(triangle);
+	++m_stats.triangles;
+}
+
+void OcclusionBuffer::rasterize()
+{
+	m_nextTile.store(0, std::memory_order_relaxed);
+	if (!m_workers.empty())
+	{
+		m_busyWorkers.store(static_cast<uint32_t>(m_workers.size()), std::memory_order_relaxed);
+		m_generation.fetch_add(1, std::memory_order_release);
+		m_generation.notify_all();
+	}
+
+	rasterizeTiles();
+
+	for (uint32_t busy = m_busyWorkers.load(std::memory_order_acquire); busy != 0; busy = m_busyWorkers.load(std::memory_order_acquire))
+		m_busyWorkers.wait(busy, std::memory_order_acquire);
+}
+
+void OcclusionBuffer::rasterizeTiles()
+{
+	// Tiles never share pixels, so threads only need to agree on who takes
+	// which tile.
+	for (uint32_t tile = m_nextTile++; tile < tileCount(); tile = m_nextTile++)
+		rasterizeTile(tile);
+}
+
+void OcclusionBuffer::runWorker(std::stop_token stop)
+{
+	uint32_t seen = 0;
+	for (;;)
+	{
+		m_generation.wait(seen, std::memory_order_acquire);
+		if (stop.stop_requested())
+			return;
+
+		seen = m_generation.load(std::memory_order_acquire);
+		rasterizeTiles();
+		if (m_busyWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			m_busyWorkers.notify_one();
+	}
+}
+
+void OcclusionBuffer::rasterizeTile(uint32_t tile)
+{
+	const uint32_t tileX = tile % m_tilesX * TILE_SIZE;
+	const uint32_t tileY = tile / m_tilesX * TILE_SIZE;
+	for (uint32_t y = tileY; y < tileY + TILE_SIZE; ++y)
+		std::fill_n(m_depth.begin() + y * m_width + tileX, TILE_SIZE, FAR_DEPTH);
+
+	for (const ScreenTriangle& triangle : m_triangles)
+	{
+		// Pixels whose centres can be inside the triangle, with x widened to
+		// whole groups of four. Tile edges are multiples of four as well.
+		const uint32_t x0 = std::max(tileX, static_cast<uint32_t>(triangle.minX) & ~3u);
+		const uint32_t y0 = std::max(tileY, static_cast<uint32_t>(triangle.minY));
+		const uint32_t x1 = std::min(tileX + TILE_SIZE, (static_cast<uint32_t>(std::ceil(triangle.maxX)) + 3u) & ~3u);
+		const uint32_t y1 = std::min(tileY + TILE_SIZE, static_cast<uint32_t>(std::ceil(triangle.maxY)));
+
+		for (uint32_t y = y0; y < y1; ++y)
+		{
+			const float py = static_cast<float>(y) + 0.5f;
+			const glm::vec3 rowEdges{
+				triangle.edges[0].y * py + triangle.edges[0].z,
+				triangle.edges[1].y * py + triangle.edges[1].z,
+				triangle.edges[2].y * py + triangle.edges[2].z};
+			const float rowDepth = triangle.depth.y * py + triangle.depth.z;
+			float* row = m_depth.data() + y * m_width;
+
+#if WMCV_OCCLUSION_SSE
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+			for (uint32_t x = x0; x < x1; x += 4)
+			{
+				const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+				const __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edges[0].x), px), _mm_set1_ps(rowEdges.x));
+				const __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edges[1].x), px), _mm_set1_ps(rowEdges.y));
+				const __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edges[2].x), px), _mm_set1_ps(rowEdges.z));
+				const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+				if (_mm_movemask_ps(inside) == 0)
+					continue;
+
+				const __m128 depth = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.depth.x), px), _mm_set1_ps(rowDepth));
+				const __m128 old = _mm_loadu_ps(row + x);
+				const __m128 nearer = _mm_min_ps(old, depth);
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+			}
+#else
+			for (uint32_t x = x0; x < x1; ++x)
+			{
+				const float px = static_cast<float>(x) + 0.5f;
+				const bool inside =
+					triangle.edges[0].x * px + rowEdges.x >= 0.f &&
+					triangle.edges[1].x * px + rowEdges.y >= 0.f &&
+					triangle.edges[2].x * px + rowEdges.z >= 0.f;
+				if (inside)
+					row[x] = std::min(row[x], triangle.depth.x * px + rowDepth);
+			}
+#endif
+		}
+	}
+}
+
+bool OcclusionBuffer::occluded(const glm::vec3& center, const glm::vec3& extents) const
+{
+	float minX = static_cast<float>(m_width), minY = static_cast<float>(m_height), minZ = FAR_DEPTH;
+	float maxX = 0.f, maxY = 0.f;
+	for (const glm::vec3& corner : BOX_CORNERS)
+	{
+		const glm::vec4 clip = m_viewProjection * glm::vec4{center + corner * extents, 1.f};
+		if (NearDistance(clip) <= 0.f || clip.w <= 0.f)
+			return false;
+
+		const float x = (clip.x / clip.w * 0.5f + 0.5f) * static_cast<float>(m_width);
+		const float y = (clip.y / clip.w * 0.5f + 0.5f) * static_cast<float>(m_height);
+		minX = std::min(minX, x);
+		minY = std::min(minY, y);
+		maxX = std::max(maxX, x);
+		maxY = std::max(maxY, y);
+		minZ = std::min(minZ, clip.z / clip.w);
+	}
+
+	// Every pixel the screen rectangle touches, compared against the nearest
+	// point of the box.
+	const auto x0 = static_cast<uint32_t>(std::max(minX, 0.f));
+	const auto y0 = static_cast<uint32_t>(std::max(minY, 0.f));
+	const auto x1 = static_cast<uint32_t>(std::min(std::ceil(maxX), static_cast<float>(m_width)));
+	const auto y1 = static_cast<uint32_t>(std::min(std::ceil(maxY), static_cast<float>(m_height)));
+	if (x0 >= x1 || y0 >= y1)
+		return false;
+
+	for (uint32_t y = y0; y < y1; ++y)
+	{
+		const float* row = m_depth.data() + y * m_width;
+		uint32_t x = x0;
+#if WMCV_OCCLUSION_SSE
+		const __m128 boxDepth = _mm_set1_ps(minZ);
+		for (; x + 4 <= x1; x += 4)
+		{
+			if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(row + x), boxDepth)) != 0)
+				return false;
+		}
+#endif
+		for (; x < x1; ++x)
+		{
+			if (row[x] >= minZ)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+void OcclusionBuffer::cull(const CullingBounds& bounds, std::vector<uint32_t>& visible)
+{
+	const size_t before = visible.size();
+	std::erase_if(visible, [this, &bounds](uint32_t index)
+	{
+		return occluded(bounds.boxCenter(index), bounds.boxExtents(index));
+	});
+
+	m_stats.tested += static_cast<uint32_t>(before);
+	m_stats.occluded += static_cast<uint32_t>(before - visible.size());
+}
+
+} // namespace wmcv
@@ -0,0 +1,25 @@
+#include "pch.h"
+#include "opengl_functions.h"
+
+#define WMCV_DEFINE_OPENGL_FUNCTION(type, name) type name = nullptr;
+WMCV_OPENGL_FUNCTIONS(WMCV_DEFINE_OPENGL_FUNCTION)
+#undef WMCV_DEFINE_OPENGL_FUNCTION
+
+namespace wmcv
+{
+
+int LoadOpenGLFunctions(OpenGLProcLoader loader)
+{
+	int missing = 0;
+
+#define WMCV_LOAD_OPENGL_FUNCTION(type, name) \
+	name = reinterpret_cast<type>(loader(#name)); \
+	missing += (name == nullptr) ? 1 : 0;
+
+	WMCV_OPENGL_FUNCTIONS(WMCV_LOAD_OPENGL_FUNCTION)
+#undef WMCV_LOAD_OPENGL_FUNCTION
+
+	return missing;
+}
+
+} // namespace wmcv
@@ -8,11 +8,21 @@
 #include <chrono>
 #include <thread>
 #include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
 #include <cinttypes>
+#include <charconv>
 #include <span>
 #include <algorithm>
+#include <numeric>
 #include <functional>
+#include <source_location>
+#include <filesystem>
 #include <queue>
+#include <utility>
+#include <cstring>
+#include <cassert>
 
 #ifdef _WIN32
 #ifndef WIN32_LEAN_AND_MEAN
@@ -24,6 +34,9 @@
 #include <Windows.h>
 #include <Windowsx.h>
 #include <hidusage.h>
+#else
+#include <csignal>
+inline void DebugBreak() { std::raise(SIGTRAP); }
 #endif
 
 #pragma warning(push)
@@ -4,6 +4,8 @@
 
 namespace wmcv
 {
+	static LogCategory s_inputLog{"input"};
+
 	static bool CreateRawInput()
 	{
 		std::array<RAWINPUTDEVICE, 2> devices =
@@ -272,7 +274,7 @@ namespace wmcv
 			{
 				if (GetRawInputData(hraw, RID_INPUT, lpb.get(), &dwSize, sizeof(RAWINPUTHEADER)) != dwSize)
 				{
-					wmcv::LogMessage("GetRawInputData does not return correct size !\n");
+					wmcv::LogWarning(s_inputLog, "GetRawInputData does not return correct size !\n");
 					return false;
 				}
 
@@ -3,6 +3,13 @@
 #include "shader.h"
 #include "texture.h"
 #include "camera.h"
+#include "light_buffer.h"
+#include "instance_buffer.h"
+#include "gl_state.h"
+#include "dynamic_ring_buffer.h"
+#include "indirect_draws.h"
+#include "frustum_culling.h"
+#include "occlusion_culling.h"
 
 #include "wmcv_log/wmcv_log.h"
 
@@ -24,54 +31,12 @@ static T LoadGLProc(const char* functionName)
 PFNWGLGETEXTENSIONSSTRINGEXTPROC wglGetExtensionsStringEXT = nullptr;
 PFNWGLCHOOSEPIXELFORMATARBPROC wglChoosePixelFormatARB = nullptr;
 PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB = nullptr;
-PFNGLDEBUGMESSAGECALLBACKPROC glDebugMessageCallback = nullptr;
-PFNGLCREATEPROGRAMPROC glCreateProgram = nullptr;
-PFNGLDELETEPROGRAMPROC glDeleteProgram = nullptr;
-PFNGLATTACHSHADERPROC glAttachShader = nullptr;
-PFNGLLINKPROGRAMPROC glLinkProgram = nullptr;
-PFNGLUSEPROGRAMPROC glUseProgram = nullptr;
-PFNGLGETPROGRAMIVPROC glGetProgramiv = nullptr;
-PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog = nullptr;
-PFNGLCREATESHADERPROC glCreateShader = nullptr;
-PFNGLDELETESHADERPROC glDeleteShader = nullptr;
-PFNGLCOMPILESHADERPROC glCompileShader = nullptr;
-PFNGLSHADERSOURCEPROC glShaderSource = nullptr;
-PFNGLGETSHADERIVPROC glGetShaderiv = nullptr;
-PFNGLGETSHADERINFOLOGPROC glGetShaderInfoLog = nullptr;
-PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation = nullptr;
-PFNGLUNIFORM1FPROC glUniform1f = nullptr;
-PFNGLUNIFORM2FPROC glUniform2f = nullptr;
-PFNGLUNIFORM3FPROC glUniform3f = nullptr;
-PFNGLUNIFORM4FPROC glUniform4f = nullptr;
-PFNGLUNIFORM1IPROC glUniform1i = nullptr;
-PFNGLUNIFORM2IPROC glUniform2i = nullptr;
-PFNGLUNIFORM3IPROC glUniform3i = nullptr;
-PFNGLUNIFORM4IPROC glUniform4i = nullptr;
-PFNGLUNIFORM1FVPROC glUniform1fv = nullptr;
-PFNGLUNIFORM2FVPROC glUniform2fv = nullptr;
-PFNGLUNIFORM3FVPROC glUniform3fv = nullptr;
-PFNGLUNIFORM4FVPROC glUniform4fv = nullptr;
-PFNGLUNIFORM1IVPROC glUniform1iv = nullptr;
-PFNGLUNIFORM2IVPROC glUniform2iv = nullptr;
-PFNGLUNIFORM3IVPROC glUniform3iv = nullptr;
-PFNGLUNIFORM4IVPROC glUniform4iv = nullptr;
-PFNGLUNIFORMMATRIX2FVPROC glUniformMatrix2fv = nullptr;
-PFNGLUNIFORMMATRIX3FVPROC glUniformMatrix3fv = nullptr;
-PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv = nullptr;
-PFNGLGENVERTEXARRAYSPROC glGenVertexArrays = nullptr;
-PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays = nullptr;
-PFNGLBINDVERTEXARRAYPROC glBindVertexArray = nullptr;
-PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer = nullptr;
-PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArray = nullptr;
-PFNGLGENBUFFERSPROC glGenBuffers = nullptr;
-PFNGLBINDBUFFERPROC glBindBuffer = nullptr;
-PFNGLBUFFERDATAPROC glBufferData = nullptr;
-PFNGLGENERATEMIPMAPPROC glGenerateMipmap = nullptr;
-PFNGLACTIVETEXTUREPROC glActiveTexture = nullptr;
 
 namespace wmcv
 {
 
+static LogCategory s_renderLog{"render"};
+
 static std::array<glm::vec3, 10> cubePositions = {
 	glm::vec3(0.0f, 0.0f, 0.0f),
 	glm::vec3(2.0f, 5.0f, -15.0f),
@@ -92,62 +57,105 @@ static std::array<glm::vec3, 4> pointLightPositions = {
 	glm::vec3(0.0f, 0.0f, -3.0f)
 };
 
+// Mirrors the FrameTransforms block of basic_lighting.vs and light_cube.vs.
+struct FrameTransforms
+{
+	glm::mat4 projection;
+	glm::mat4 view;
+};
+
+constexpr uint32_t FRAME_TRANSFORMS_BINDING = 1;
+constexpr uint32_t FRAMES_IN_FLIGHT = 3;
+
+// The nearest few visible cubes are drawn into a small CPU depth buffer to
+// hide whatever is behind them.
+constexpr uint32_t OCCLUSION_WIDTH = 256;
+constexpr uint32_t OCCLUSION_HEIGHT = 128;
+constexpr uint32_t OCCLUSION_THREADS = 4;
+constexpr size_t MAX_OCCLUDERS = 4;
+
+// Ids packed into the sort key of each draw.
+enum SceneShader : uint16_t
+{
+	LIT_SHADER,
+	LAMP_SHADER,
+};
+
+enum SceneMaterial : uint16_t
+{
+	CONTAINER_MATERIAL,
+	NO_MATERIAL,
+};
+
+enum SceneMesh : uint16_t
+{
+	CUBE_MESH,
+	LAMP_MESH,
+};
+
+// Cubes and lamps share the vertex and index buffers.
+constexpr MeshRange CUBE_MESH_RANGE{36, 0, 0};
+
+static std::vector<MeshInstance> BuildCubeInstances()
+{
+	std::vector<MeshInstance> instances;
+	instances.reserve(cubePositions.size());
+	for (size_t i = 0; i < cubePositions.size(); ++i)
+	{
+		glm::mat4 transform = glm::translate(glm::mat4(1.0f), cubePositions[i]);
+		const float angle = 20.0f * static_cast<float>(i);
+		transform = glm::rotate(transform, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+		instances.push_back(MakeMeshInstance(transform));
+	}
+	return instances;
+}
+
+static std::vector<MeshInstance> BuildLightInstances()
+{
+	std::vector<MeshInstance> instances;
+	instances.reserve(pointLightPositions.size());
+	for (const auto& lightPos : pointLightPositions)
+	{
+		glm::mat4 transform = glm::translate(glm::identity<glm::mat4>(), lightPos);
+		transform = glm::scale(transform, glm::vec3{0.2f});
+		instances.push_back(MakeMeshInstance(transform));
+	}
+	return instances;
+}
+
+// Room for everything one frame writes to the ring, in the worst case of
+// every object visible and each in a command of its own.
+static size_t FrameDataSize(size_t cubes, size_t lamps)
+{
+	return DynamicRingBuffer::RegionSizeFor({
+		sizeof(FrameTransforms),
+		PointLightBufferSize(pointLightPositions.size()),
+		cubes * sizeof(DrawElementsIndirectCommand),
+		cubes * sizeof(MeshInstance),
+		lamps * sizeof(DrawElementsIndirectCommand),
+		lamps * sizeof(MeshInstance)});
+}
+
+// wglGetProcAddress only resolves entry points added after GL 1.1, the rest
+// are exported by opengl32.dll itself.
+static void* GetGLProcAddress(const char* functionName)
+{
+	PROC proc = wglGetProcAddress(functionName);
+	const auto value = reinterpret_cast<intptr_t>(proc);
+	if (value == 0 || value == 1 || value == 2 || value == 3 || value == -1)
+	{
+		static HMODULE opengl32 = LoadLibraryA("opengl32.dll");
+		proc = GetProcAddress(opengl32, functionName);
+	}
+	return reinterpret_cast<void*>(proc);
+}
+
 static void LoadGLFunctions()
 {
-	glDebugMessageCallback = LoadGLProc<PFNGLDEBUGMESSAGECALLBACKPROC>("glDebugMessageCallback");
-
-	glCreateProgram = LoadGLProc<PFNGLCREATEPROGRAMPROC>("glCreateProgram");
-	glDeleteProgram = LoadGLProc<PFNGLDELETEPROGRAMPROC>("glDeleteProgram");
-	glAttachShader = LoadGLProc<PFNGLATTACHSHADERPROC>("glAttachShader");
-	glLinkProgram = LoadGLProc<PFNGLLINKPROGRAMPROC>("glLinkProgram");
-	glUseProgram = LoadGLProc<PFNGLUSEPROGRAMPROC>("glUseProgram");
-	glGetProgramiv = LoadGLProc<PFNGLGETPROGRAMIVPROC>("glGetProgramiv");
-	glGetProgramInfoLog = LoadGLProc<PFNGLGETPROGRAMINFOLOGPROC>("glGetProgramInfoLog");
-
-	glCreateShader = LoadGLProc<PFNGLCREATESHADERPROC>("glCreateShader");
-	glDeleteShader = LoadGLProc<PFNGLDELETESHADERPROC>("glDeleteShader");
-	glCompileShader = LoadGLProc<PFNGLCOMPILESHADERPROC>("glCompileShader");
-	glShaderSource = LoadGLProc<PFNGLSHADERSOURCEPROC>("glShaderSource");
-	glGetShaderiv = LoadGLProc<PFNGLGETSHADERIVPROC>("glGetShaderiv");
-	glGetShaderInfoLog = LoadGLProc<PFNGLGETSHADERINFOLOGPROC>("glGetShaderInfoLog");
-	glGetUniformLocation = LoadGLProc<PFNGLGETUNIFORMLOCATIONPROC>("glGetUniformLocation");
-
-	glUniform1f = LoadGLProc<PFNGLUNIFORM1FPROC>("glUniform1f");
-	glUniform2f = LoadGLProc<PFNGLUNIFORM2FPROC>("glUniform2f");
-	glUniform3f = LoadGLProc<PFNGLUNIFORM3FPROC>("glUniform3f"); 
-	glUniform4f = LoadGLProc<PFNGLUNIFORM4FPROC>("glUniform4f");
-
-	glUniform1i = LoadGLProc<PFNGLUNIFORM1IPROC>("glUniform1i"); 
-	glUniform2i = LoadGLProc<PFNGLUNIFORM2IPROC>("glUniform2i"); 
-	glUniform3i = LoadGLProc<PFNGLUNIFORM3IPROC>("glUniform3i"); 
-	glUniform4i = LoadGLProc<PFNGLUNIFORM4IPROC>("glUniform4i"); 
-
-	glUniform1fv = LoadGLProc<PFNGLUNIFORM1FVPROC>("glUniform1fv");
-	glUniform2fv = LoadGLProc<PFNGLUNIFORM2FVPROC>("glUniform2fv");
-	glUniform3fv = LoadGLProc<PFNGLUNIFORM3FVPROC>("glUniform3fv");
-	glUniform4fv = LoadGLProc<PFNGLUNIFORM4FVPROC>("glUniform4fv");
-
-	glUniform1iv = LoadGLProc<PFNGLUNIFORM1IVPROC>("glUniform1iv");
-	glUniform2iv = LoadGLProc<PFNGLUNIFORM2IVPROC>("glUniform2iv");
-	glUniform3iv = LoadGLProc<PFNGLUNIFORM3IVPROC>("glUniform3iv");
-	glUniform4iv = LoadGLProc<PFNGLUNIFORM4IVPROC>("glUniform4iv");
-
-	glUniformMatrix2fv = LoadGLProc<PFNGLUNIFORMMATRIX2FVPROC>("glUniformMatrix2fv");
-	glUniformMatrix3fv = LoadGLProc<PFNGLUNIFORMMATRIX3FVPROC>("glUniformMatrix3fv");
-	glUniformMatrix4fv = LoadGLProc<PFNGLUNIFORMMATRIX4FVPROC>("glUniformMatrix4fv");
-
-	glGenVertexArrays = LoadGLProc<PFNGLGENVERTEXARRAYSPROC>("glGenVertexArrays");
-	glDeleteVertexArrays = LoadGLProc<PFNGLDELETEVERTEXARRAYSPROC>("glDeleteVertexArrays");
-	glBindVertexArray = LoadGLProc<PFNGLBINDVERTEXARRAYPROC>("glBindVertexArray");
-	glVertexAttribPointer = LoadGLProc<PFNGLVERTEXATTRIBPOINTERPROC>("glVertexAttribPointer");
-	glEnableVertexAttribArray = LoadGLProc<PFNGLENABLEVERTEXATTRIBARRAYPROC>("glEnableVertexAttribArray");
-
-	glGenBuffers = LoadGLProc<PFNGLGENBUFFERSPROC>("glGenBuffers");
-	glBindBuffer = LoadGLProc<PFNGLBINDBUFFERPROC>("glBindBuffer");
-	glBufferData = LoadGLProc<PFNGLBUFFERDATAPROC>("glBufferData");
-
-	glGenerateMipmap = LoadGLProc<PFNGLGENERATEMIPMAPPROC>("glGenerateMipmap");
-	glActiveTexture = LoadGLProc<PFNGLACTIVETEXTUREPROC>("glActiveTexture");
+	if (wmcv::LoadOpenGLFunctions(&GetGLProcAddress) != 0)
+	{
+		MessageBox(NULL, "Failed to load one or more OpenGL functions", "Fatal Error", MB_ICONERROR);
+	}
 }
 
 static std::pair<GLuint, GLuint> InitGPUResources()
@@ -206,7 +214,16 @@ static std::pair<GLuint, GLuint> InitGPUResources()
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-	glBindVertexArray(cubeVAO);
+	// the vertices are already unrolled per triangle, so the indices just count them
+	std::array<uint32_t, 36> indices;
+	std::iota(indices.begin(), indices.end(), 0u);
+
+	unsigned int EBO;
+	glGenBuffers(1, &EBO);
+
+	GetGLState().bindVertexArray(cubeVAO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices.data(), GL_STATIC_DRAW);
 
 	// position attribute
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
@@ -223,7 +240,8 @@ static std::pair<GLuint, GLuint> InitGPUResources()
 	// second, configure the light's VAO (VBO stays the same; the vertices are the same for the light object which is also a 3D cube)
 	unsigned int lightCubeVAO;
 	glGenVertexArrays(1, &lightCubeVAO);
-	glBindVertexArray(lightCubeVAO);
+	GetGLState().bindVertexArray(lightCubeVAO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
 
 	// we only need to bind to the VBO (to link it with glVertexAttribPointer), no need to fill it; the VBO's data already contains all we need (it's already bound, but we do it again for educational purposes)
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
@@ -243,7 +261,9 @@ struct Win32OpenGLImpl final : public OpenGL
 	virtual void DrawScene();
 	virtual void Destroy();
 	virtual void SetClearColor(float, float, float);
-	virtual void PushCommand(RenderCommand&& cmd);
+	virtual void PushCommand(uint64_t sortKey, const DrawArraysCommand& cmd);
+	virtual void PushCommand(uint64_t sortKey, const DrawArraysInstancedCommand& cmd);
+	virtual void PushCommand(uint64_t sortKey, const MultiDrawElementsIndirectCommand& cmd);
 
 	virtual void SetOpacity(float);
 	virtual void SetModelTransform(const glm::mat4&);
@@ -254,11 +274,17 @@ struct Win32OpenGLImpl final : public OpenGL
 	virtual void SetLightColor(const glm::vec3&);
 	virtual void SetCamera(Camera*);
 
+	void bindShader(uint16_t shader);
+	void bindMaterial(uint16_t material);
+	void cullOccluded(const glm::mat4& viewProjection);
+	void addVisible(std::span<const uint32_t> visible, std::span<const MeshInstance> field, IndirectDrawBuilder& draws);
+	bool submitIndirect(uint64_t sortKey, uint32_t vertexArray, const IndirectDrawBuilder& draws);
+
 	HDC m_deviceContext;
 	HGLRC m_renderingContext;
 	HWND m_windowHandle;
 
-	std::queue<RenderCommand> m_commands;
+	RenderCommandBuffer m_commands;
 	Camera* camera;
 
 	GLuint lightVAO;
@@ -270,6 +296,24 @@ struct Win32OpenGLImpl final : public OpenGL
 	wmcv::Texture specularMap;
 	wmcv::Texture emissionMap;
 
+	std::vector<wmcv::MeshInstance> cubeField;
+	std::vector<wmcv::MeshInstance> lampField;
+
+	// Per-frame transforms, lights and draws, written straight into mapped
+	// memory and sized for the fields above.
+	wmcv::GLFenceProvider fences;
+	wmcv::DynamicRingBuffer frameData;
+	std::vector<wmcv::PointLight> pointLights;
+
+	wmcv::CullingBounds cubeBounds;
+	wmcv::CullingBounds lampBounds;
+	std::vector<uint32_t> visibleCubes;
+	std::vector<uint32_t> visibleLamps;
+	std::vector<uint32_t> occluders;
+	wmcv::OcclusionBuffer occlusion;
+	wmcv::IndirectDrawBuilder cubeDraws;
+	wmcv::IndirectDrawBuilder lampDraws;
+
 	glm::mat4 model;
 	glm::mat4 view;
 	glm::mat4 projection;
@@ -287,6 +331,10 @@ Win32OpenGLImpl::Win32OpenGLImpl(HDC hdc, HGLRC rc, HWND hwnd)
 	: m_deviceContext(hdc)
 	, m_renderingContext(rc)
 	, m_windowHandle(hwnd)
+	, cubeField(BuildCubeInstances())
+	, lampField(BuildLightInstances())
+	, frameData(FrameDataSize(cubeField.size(), lampField.size()), FRAMES_IN_FLIGHT, fences)
+	, occlusion(OCCLUSION_WIDTH, OCCLUSION_HEIGHT, OCCLUSION_THREADS)
 {
 	const auto data_path_dir =
 		fs::current_path().root_name() /
@@ -322,6 +370,13 @@ Win32OpenGLImpl::Win32OpenGLImpl(HDC hdc, HGLRC rc, HWND hwnd)
 	diffuseMap = wmcv::Texture(diffuse_map_path, false);
 	specularMap = wmcv::Texture(specular_map_path, false);
 	emissionMap = wmcv::Texture(emission_map_path, false);
+
+	for (const MeshInstance& instance : cubeField)
+		cubeBounds.addTransformedBox(instance.model, glm::vec3{0.5f});
+	for (const MeshInstance& instance : lampField)
+		lampBounds.addTransformedBox(instance.model, glm::vec3{0.5f});
+	SetupInstanceAttributes(cubeVAO);
+	SetupInstanceAttributes(lightVAO);
 }
 
 void Win32OpenGLImpl::ClearBuffers()
@@ -337,89 +392,191 @@ void Win32OpenGLImpl::Present()
 
 void Win32OpenGLImpl::DrawScene()
 {
-	// be sure to activate shader when setting uniforms/drawing objects
-	lightingShader.on();
-	lightingShader.setInt("material.diffuse", 0);
-	lightingShader.setInt("material.specular", 1);
-	//lightingShader.setInt("material.emission", 2);
+	lightingShader.resetUploadStats();
+	lightCubeShader.resetUploadStats();
+	GetGLState().resetStats();
+	frameData.beginFrame();
 
-	//directional light
-	lightingShader.setVec3("dirLight.direction", glm::vec3{-0.2f, -1.f, -0.3f});
-	lightingShader.setVec3("dirLight.ambient", glm::vec3{.05f});
-	lightingShader.setVec3("dirLight.diffuse", glm::vec3{.4f});
-	lightingShader.setVec3("dirLight.specular", glm::vec3{0.5f});
+	const FrameTransforms transforms{projection, view};
+	const DynamicAllocation transformData = frameData.write(std::span{&transforms, 1});
 
 	//point lights
-	for (size_t i = 0; i < pointLightPositions.size(); ++i)
+	pointLights.clear();
+	for (const glm::vec3& position : pointLightPositions)
 	{
-		auto direction = std::stringstream() << "pointLights[" << i << "].position";
-		auto ambient = std::stringstream() << "pointLights[" << i << "].ambient";
-		auto diffuse = std::stringstream() << "pointLights[" << i << "].diffuse";
-		auto specular = std::stringstream() << "pointLights[" << i << "].specular";
-		auto constant = std::stringstream() << "pointLights[" << i << "].constant";
-		auto linear = std::stringstream() << "pointLights[" << i << "].linear";
-		auto quadratic = std::stringstream() << "pointLights[" << i << "].quadratic";
-
-		lightingShader.setVec3(direction.str().c_str(), pointLightPositions[i]);
-		lightingShader.setVec3(ambient.str().c_str(), lightColor * glm::vec3{.05f});
-		lightingShader.setVec3(diffuse.str().c_str(), lightColor * glm::vec3{.8f});
-		lightingShader.setVec3(specular.str().c_str(), glm::vec3{1.f});
-		lightingShader.setFloat(constant.str().c_str(), 1.f);
-		lightingShader.setFloat(linear.str().c_str(), 0.09f);
-		lightingShader.setFloat(quadratic.str().c_str(), 0.032f);
-
+		pointLights.push_back(PointLight{
+			.position = glm::vec4{position, 1.f},
+			.ambient = glm::vec4{lightColor * glm::vec3{.05f}, 0.f},
+			.diffuse = glm::vec4{lightColor * glm::vec3{.8f}, 0.f},
+			.specular = glm::vec4{1.f},
+			.constant = 1.f,
+			.linear = 0.09f,
+			.quadratic = 0.032f,
+			.padding = 0.f});
+	}
+	const DynamicAllocation lightData = frameData.allocate(PointLightBufferSize(pointLights.size()));
+	if (!transformData.valid() || !lightData.valid())
+	{
+		WMCV_LOG_AT_MOST_EVERY(wmcv::LogLevel::Error, s_renderLog, std::chrono::seconds{5}, "per-frame data does not fit in {} bytes", frameData.regions().regionSize());
+		frameData.endFrame();
+		return;
 	}
 
-	lightingShader.setVec3("spotLight.position", camera->position());
-	lightingShader.setVec3("spotLight.direction", camera->front());
-	lightingShader.setVec3("spotLight.ambient", glm::vec3{0.05f});
-	lightingShader.setVec3("spotLight.diffuse", glm::vec3{0.8f});
-	lightingShader.setVec3("spotLight.specular", glm::vec3{1.0f});
-	lightingShader.setFloat("spotLight.constant", 1.0f);
-	lightingShader.setFloat("spotLight.linear", 0.09f);
-	lightingShader.setFloat("spotLight.quadratic", 0.032f);
-	lightingShader.setFloat("spotLight.innerRadius", glm::cos(glm::radians(12.5f)));
-	lightingShader.setFloat("spotLight.outerRadius", glm::cos(glm::radians(17.5f)));
-
-	lightingShader.setVec3("viewPos", camera->position());
-	lightingShader.setFloat("material.shininess", 32.f);
-
-	// view/projection transformations
-	lightingShader.setMat4("projection", projection);
-	lightingShader.setMat4("view", view);
-	//lightingShader.setMat4("model", model);
-
-	//bind diffuse and specular map
-	diffuseMap.on(0);
-	specularMap.on(1);
-	emissionMap.on(2);
-
-	// render the cube
-	glBindVertexArray(cubeVAO);
-
-	for (unsigned int i = 0; i < 10; i++)
+	WritePointLightBuffer(pointLights, lightData.data);
+	frameData.bindRange(GL_UNIFORM_BUFFER, FRAME_TRANSFORMS_BINDING, transformData);
+	frameData.bindRange(GL_SHADER_STORAGE_BUFFER, POINT_LIGHT_BUFFER_BINDING, lightData);
+
+	// each pass is a single multi-draw over every visible object
+	const glm::mat4 viewProjection = projection * view;
+	const Frustum frustum = ExtractFrustum(viewProjection);
+	CullFrustum(frustum, cubeBounds, visibleCubes);
+	CullFrustum(frustum, lampBounds, visibleLamps);
+	cullOccluded(viewProjection);
+	addVisible(visibleCubes, cubeField, cubeDraws);
+	addVisible(visibleLamps, lampField, lampDraws);
+
+	// frameData is sized for every object, so neither pass should run out of room
+	const bool cubesSubmitted = submitIndirect(EncodeSortKey({.pass = RenderPass::Opaque, .shader = LIT_SHADER, .material = CONTAINER_MATERIAL, .mesh = CUBE_MESH}), cubeVAO, cubeDraws);
+	const bool lampsSubmitted = submitIndirect(EncodeSortKey({.pass = RenderPass::Emissive, .shader = LAMP_SHADER, .material = NO_MATERIAL, .mesh = LAMP_MESH}), lightVAO, lampDraws);
+	if (!cubesSubmitted || !lampsSubmitted)
+		WMCV_LOG_AT_MOST_EVERY(wmcv::LogLevel::Error, s_renderLog, std::chrono::seconds{5}, "indirect draws do not fit in {} bytes", frameData.regions().regionSize());
+
+	m_commands.sort();
+
+	uint32_t boundShader = UINT32_MAX;
+	uint32_t boundMaterial = UINT32_MAX;
+	for (const RenderCommandEntry& entry : m_commands.commands())
 	{
-		model = glm::mat4(1.0f);
-		model = glm::translate(model, cubePositions[i]);
-		float angle = 20.0f * i;
-		model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-		lightingShader.setMat4("model", model);
+		const RenderSortKey key = DecodeSortKey(entry.key);
+		if (key.shader != boundShader)
+		{
+			bindShader(key.shader);
+			boundShader = key.shader;
+			boundMaterial = UINT32_MAX;
+		}
 
-		glDrawArrays(GL_TRIANGLES, 0, 36);
+		if (key.material != boundMaterial)
+		{
+			bindMaterial(key.material);
+			boundMaterial = key.material;
+		}
+
+		ExecuteRenderCommand(entry);
 	}
 
-	// also draw the lamp object
-	lightCubeShader.on();
-	glBindVertexArray(lightVAO);
-	lightCubeShader.setMat4("projection", projection);
-	lightCubeShader.setMat4("view", view);
+	m_commands.reset();
+	frameData.endFrame();
 
-	for (const auto& lightPos : pointLightPositions)
+	const UniformUploadStats litStats = lightingShader.uploadStats();
+	const UniformUploadStats lampStats = lightCubeShader.uploadStats();
+	WMCV_LOG_AT_MOST_EVERY(wmcv::LogLevel::Debug, s_renderLog, std::chrono::seconds{5}, "uniform uploads per frame: {} issued, {} skipped",
+		litStats.uploaded + lampStats.uploaded, litStats.skipped + lampStats.skipped);
+
+	const GLStateStats stateStats = GetGLState().stats();
+	WMCV_LOG_AT_MOST_EVERY(wmcv::LogLevel::Debug, s_renderLog, std::chrono::seconds{5}, "state changes per frame: {} issued, {} elided",
+		stateStats.issued, stateStats.elided);
+
+	const OcclusionStats occlusionStats = occlusion.stats();
+	WMCV_LOG_AT_MOST_EVERY(wmcv::LogLevel::Debug, s_renderLog, std::chrono::seconds{5}, "occlusion culling per frame: {} of {} objects hidden by {} triangles",
+		occlusionStats.occluded, occlusionStats.tested, occlusionStats.triangles);
+}
+
+void Win32OpenGLImpl::cullOccluded(const glm::mat4& viewProjection)
+{
+	const glm::vec3 eye = camera->position();
+	const auto nearer = [this, &eye](uint32_t a, uint32_t b)
+	{
+		return glm::length(cubeBounds.boxCenter(a) - eye) < glm::length(cubeBounds.boxCenter(b) - eye);
+	};
+
+	occluders.assign(visibleCubes.begin(), visibleCubes.end());
+	const size_t occluderCount = std::min(occluders.size(), MAX_OCCLUDERS);
+	std::partial_sort(occluders.begin(), occluders.begin() + static_cast<std::ptrdiff_t>(occluderCount), occluders.end(), nearer);
+
+	occlusion.begin(viewProjection);
+	for (size_t i = 0; i < occluderCount; ++i)
+		occlusion.addOccluderBox(cubeField[occluders[i]].model, glm::vec3{0.5f});
+	occlusion.rasterize();
+
+	occlusion.cull(cubeBounds, visibleCubes);
+	occlusion.cull(lampBounds, visibleLamps);
+}
+
+void Win32OpenGLImpl::addVisible(std::span<const uint32_t> visible, std::span<const MeshInstance> field, IndirectDrawBuilder& draws)
+{
+	draws.reset();
+	for (const uint32_t object : visible)
+		draws.add(CUBE_MESH_RANGE, field[object]);
+}
+
+bool Win32OpenGLImpl::submitIndirect(uint64_t sortKey, uint32_t vertexArray, const IndirectDrawBuilder& draws)
+{
+	if (draws.commands().empty())
+		return true;
+
+	// the instances sit next to their commands, so nothing syncs on a buffer the GPU may still be reading
+	const DynamicAllocation commands = frameData.write(draws.commands());
+	const DynamicAllocation instances = frameData.write(draws.instances());
+	if (!commands.valid() || !instances.valid())
+		return false;
+
+	BindInstanceStream(vertexArray, frameData.bufferId(), instances.offset);
+	m_commands.push(sortKey, MultiDrawElementsIndirectCommand{
+		.vertexArray = vertexArray,
+		.indirectBuffer = frameData.bufferId(),
+		.indirectOffset = commands.offset,
+		.drawCount = static_cast<int32_t>(draws.commands().size())});
+	return true;
+}
+
+void Win32OpenGLImpl::bindShader(uint16_t shader)
+{
+	switch (shader)
+	{
+	case LIT_SHADER:
+		lightingShader.on();
+		lightingShader.setInt("material.diffuse", 0);
+		lightingShader.setInt("material.specular", 1);
+		//lightingShader.setInt("material.emission", 2);
+
+		//directional light
+		lightingShader.setVec3("dirLight.direction", glm::vec3{-0.2f, -1.f, -0.3f});
+		lightingShader.setVec3("dirLight.ambient", glm::vec3{.05f});
+		lightingShader.setVec3("dirLight.diffuse", glm::vec3{.4f});
+		lightingShader.setVec3("dirLight.specular", glm::vec3{0.5f});
+
+		lightingShader.setVec3("spotLight.position", camera->position());
+		lightingShader.setVec3("spotLight.direction", camera->front());
+		lightingShader.setVec3("spotLight.ambient", glm::vec3{0.05f});
+		lightingShader.setVec3("spotLight.diffuse", glm::vec3{0.8f});
+		lightingShader.setVec3("spotLight.specular", glm::vec3{1.0f});
+		lightingShader.setFloat("spotLight.constant", 1.0f);
+		lightingShader.setFloat("spotLight.linear", 0.09f);
+		lightingShader.setFloat("spotLight.quadratic", 0.032f);
+		lightingShader.setFloat("spotLight.innerRadius", glm::cos(glm::radians(12.5f)));
+		lightingShader.setFloat("spotLight.outerRadius", glm::cos(glm::radians(17.5f)));
+
+		lightingShader.setVec3("viewPos", camera->position());
+		lightingShader.setFloat("material.shininess", 32.f);
+		break;
+	case LAMP_SHADER:
+		lightCubeShader.on();
+		break;
+	}
+}
+
+void Win32OpenGLImpl::bindMaterial(uint16_t material)
+{
+	switch (material)
 	{
-		lightTransform = glm::translate(glm::identity<glm::mat4>(), lightPos);
-		lightTransform = glm::scale(lightTransform, glm::vec3{0.2f});
-		lightCubeShader.setMat4("model", lightTransform);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
+	case CONTAINER_MATERIAL:
+		//bind diffuse and specular map
+		diffuseMap.on(0);
+		specularMap.on(1);
+		emissionMap.on(2);
+		break;
+	case NO_MATERIAL:
+		break;
 	}
 }
 
@@ -436,9 +593,19 @@ void Win32OpenGLImpl::SetClearColor( float _r, float _g, float _b)
 	b = _b;
 }
 
-void Win32OpenGLImpl::PushCommand(RenderCommand&& cmd)
+void Win32OpenGLImpl::PushCommand(uint64_t sortKey, const DrawArraysCommand& cmd)
+{
+	m_commands.push(sortKey, cmd);
+}
+
+void Win32OpenGLImpl::PushCommand(uint64_t sortKey, const DrawArraysInstancedCommand& cmd)
+{
+	m_commands.push(sortKey, cmd);
+}
+
+void Win32OpenGLImpl::PushCommand(uint64_t sortKey, const MultiDrawElementsIndirectCommand& cmd)
 {
-	m_commands.push(std::move(cmd));
+	m_commands.push(sortKey, cmd);
 }
 
 void Win32OpenGLImpl::SetOpacity( float opacity)
@@ -607,42 +774,9 @@ std::unique_ptr<OpenGL> OpenGL::Create(wmcv::OpenGLCreateParams params)
 
 	glEnable(GL_DEPTH_TEST);
 
-	const auto data_path_dir =
-		fs::current_path().root_name() /
-		fs::current_path().root_directory() /
-		fs::path("Users") /
-		fs::path("dev") /
-		fs::path("git") /
-		fs::path("learn-opengl") /
-		fs::path("data");
-
-	const auto shader_path_dir =
-		data_path_dir /
-		fs::path("shaders");
-
-	const auto cube_vs_path = (shader_path_dir / fs::path("basic_lighting.vs")).make_preferred();
-	const auto cube_fs_path = (shader_path_dir / fs::path("basic_lighting.fs")).make_preferred();
-	const auto light_vs_path = (shader_path_dir / fs::path("light_cube.vs")).make_preferred();
-	const auto light_fs_path = (shader_path_dir / fs::path("light_cube.fs")).make_preferred();
-
-	const auto texture_path_dir =
-		data_path_dir /
-		fs::path("textures");
-
-	const auto diffuse_map_path = (texture_path_dir / fs::path("container2_diffuse.png"));
-	const auto specular_map_path = (texture_path_dir / fs::path("container2_specular.png"));
-	const auto emission_map_path = (texture_path_dir / fs::path("matrix.jpg"));
-
-	auto [cubeVAO, lightVAO] = wmcv::InitGPUResources();
-
+	// The constructor creates every GPU resource, including the per-frame
+	// ring the instance attributes of its VAOs read from.
 	auto result = std::make_unique<Win32OpenGLImpl>(deviceContext, renderingContext, hWnd);
-	result->lightVAO = lightVAO;
-	result->cubeVAO = cubeVAO;
-	result->lightingShader = std::move(wmcv::Shader(cube_vs_path, cube_fs_path));
-	result->lightCubeShader = std::move(wmcv::Shader(light_vs_path, light_fs_path));
-	result->diffuseMap = wmcv::Texture(diffuse_map_path, false);
-	result->specularMap = wmcv::Texture(specular_map_path, false);
-	result->emissionMap = wmcv::Texture(emission_map_path, false);
 
 	return result;
 }
@@ -0,0 +1,141 @@
+#include "pch.h"
+#include "render_commands.h"
+#include "opengl_functions.h"
+#include "gl_state.h"
+
+namespace wmcv
+{
+
+uint32_t QuantizeDepth(float distance, float nearPlane, float farPlane)
+{
+	const float t = std::clamp((distance - nearPlane) / (farPlane - nearPlane), 0.f, 1.f);
+	return static_cast<uint32_t>(t * static_cast<float>(sort_key::MAX_DEPTH));
+}
+
+FrameArena::FrameArena(size_t capacity)
+{
+	m_blocks.push_back(Block{std::make_unique<std::byte[]>(capacity), capacity});
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment)
+{
+	const auto align = [alignment](size_t offset) { return (offset + alignment - 1) & ~(alignment - 1); };
+
+	size_t offset = align(m_offset);
+	if (offset + size > m_blocks.back().size)
+	{
+		const size_t blockSize = std::max(size + alignment, m_blocks.back().size * 2);
+		m_blocks.push_back(Block{std::make_unique<std::byte[]>(blockSize), blockSize});
+		offset = 0;
+	}
+
+	m_offset = offset + size;
+	m_used += size;
+	return m_blocks.back().memory.get() + offset;
+}
+
+void FrameArena::reset()
+{
+	if (m_blocks.size() > 1)
+	{
+		const size_t total = capacity();
+		m_blocks.clear();
+		m_blocks.push_back(Block{std::make_unique<std::byte[]>(total), total});
+	}
+
+	m_offset = 0;
+	m_used = 0;
+}
+
+size_t FrameArena::capacity() const
+{
+	size_t total = 0;
+	for (const Block& block : m_blocks)
+		total += block.size;
+	return total;
+}
+
+void RadixSortByKey(std::span<RenderCommandEntry> entries, std::span<RenderCommandEntry> scratch)
+{
+	constexpr size_t PASSES = sizeof(uint64_t);
+	std::array<std::array<uint32_t, 256>, PASSES> histograms{};
+
+	for (const RenderCommandEntry& entry : entries)
+	{
+		for (size_t pass = 0; pass < PASSES; ++pass)
+			++histograms[pass][(entry.key >> (pass * 8)) & 0xff];
+	}
+
+	std::span<RenderCommandEntry> source = entries;
+	std::span<RenderCommandEntry> destination = scratch.first(entries.size());
+	for (size_t pass = 0; pass < PASSES; ++pass)
+	{
+		std::array<uint32_t, 256>& histogram = histograms[pass];
+		const uint32_t firstDigit = static_cast<uint32_t>((entries.empty() ? 0 : source[0].key >> (pass * 8)) & 0xff);
+
+		// Every key shares this byte, so the pass would not move anything.
+		if (histogram[firstDigit] == entries.size())
+			continue;
+
+		uint32_t offset = 0;
+		for (uint32_t& count : histogram)
+			offset += std::exchange(count, offset);
+
+		for (const RenderCommandEntry& entry : source)
+			destination[histogram[(entry.key >> (pass * 8)) & 0xff]++] = entry;
+
+		std::swap(source, destination);
+	}
+
+	if (source.data() != entries.data())
+		std::copy(source.begin(), source.end(), entries.begin());
+}
+
+RenderCommandBuffer::RenderCommandBuffer(size_t arenaBytes)
+	: m_arena(arenaBytes)
+{
+}
+
+void RenderCommandBuffer::sort()
+{
+	m_scratch.resize(m_entries.size());
+	RadixSortByKey(m_entries, m_scratch);
+}
+
+void RenderCommandBuffer::reset()
+{
+	m_arena.reset();
+	m_entries.clear();
+}
+
+void ExecuteRenderCommand(const RenderCommandEntry& entry)
+{
+	switch (entry.type)
+	{
+	case RenderCommandType::DrawArrays:
+	{
+		const auto& draw = CommandAs<DrawArraysCommand>(entry);
+		GetGLState().bindVertexArray(draw.vertexArray);
+		glDrawArrays(GL_TRIANGLES, draw.first, draw.count);
+		break;
+	}
+	case RenderCommandType::DrawArraysInstanced:
+	{
+		const auto& draw = CommandAs<DrawArraysInstancedCommand>(entry);
+		GetGLState().bindVertexArray(draw.vertexArray);
+		glDrawArraysInstanced(GL_TRIANGLES, draw.first, draw.count, draw.instanceCount);
+		break;
+	}
+	case RenderCommandType::MultiDrawElementsIndirect:
+	{
+		const auto& draw = CommandAs<MultiDrawElementsIndirectCommand>(entry);
+		GetGLState().bindVertexArray(draw.vertexArray);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, draw.indirectBuffer);
+		const auto offset = static_cast<uintptr_t>(draw.indirectOffset);
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(offset), draw.drawCount, 0);
+		break;
+	}
+	}
+}
+
+} // namespace wmcv
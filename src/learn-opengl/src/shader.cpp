@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "shader.h"
-#include "opengl.h"
+#include "opengl_functions.h"
+#include "gl_state.h"
 
 #include "wmcv_log/wmcv_log.h"
 
@@ -10,6 +11,91 @@
 namespace wmcv
 {
 
+namespace
+{
+LogCategory s_shaderLog{"shader"};
+
+uint32_t UniformTypeSize(GLenum type)
+{
+	switch (type)
+	{
+	case GL_FLOAT_VEC2:
+	case GL_INT_VEC2:
+	case GL_UNSIGNED_INT_VEC2:
+	case GL_BOOL_VEC2:
+		return 8;
+	case GL_FLOAT_VEC3:
+	case GL_INT_VEC3:
+	case GL_UNSIGNED_INT_VEC3:
+	case GL_BOOL_VEC3:
+		return 12;
+	case GL_FLOAT_VEC4:
+	case GL_INT_VEC4:
+	case GL_UNSIGNED_INT_VEC4:
+	case GL_BOOL_VEC4:
+	case GL_FLOAT_MAT2:
+		return 16;
+	case GL_FLOAT_MAT3:
+		return 36;
+	case GL_FLOAT_MAT4:
+		return 64;
+	case GL_FLOAT_MAT2x3:
+	case GL_FLOAT_MAT3x2:
+		return 24;
+	case GL_FLOAT_MAT2x4:
+	case GL_FLOAT_MAT4x2:
+		return 32;
+	case GL_FLOAT_MAT3x4:
+	case GL_FLOAT_MAT4x3:
+		return 48;
+	default:
+		// Scalars, bools and every sampler/image type are a single 32 bit value.
+		return 4;
+	}
+}
+}
+
+void UniformNameTable::clear()
+{
+	m_slots.clear();
+	m_count = 0;
+}
+
+void UniformNameTable::insert(uint64_t hash, int32_t value)
+{
+	if ((m_count + 1) * 2 > m_slots.size())
+		grow();
+
+	const size_t mask = m_slots.size() - 1;
+	for (size_t i = hash & mask;; i = (i + 1) & mask)
+	{
+		Slot& slot = m_slots[i];
+		if (slot.hash == hash)
+		{
+			slot.value = value;
+			return;
+		}
+
+		if (slot.hash == 0)
+		{
+			slot = Slot{hash, value};
+			++m_count;
+			return;
+		}
+	}
+}
+
+void UniformNameTable::grow()
+{
+	std::vector<Slot> previous = std::exchange(m_slots, std::vector<Slot>(std::max<size_t>(16, m_slots.size() * 2)));
+	m_count = 0;
+	for (const Slot& slot : previous)
+	{
+		if (slot.hash != 0)
+			insert(slot.hash, slot.value);
+	}
+}
+
 Shader::Shader(const std::filesystem::path& vertexPath, const std::filesystem::path& fragmentPath)
 {
 	std::string vertexCode;
@@ -34,10 +120,10 @@ Shader::Shader(const std::filesystem::path& vertexPath, const std::filesystem::p
 		vertexCode = vShaderStream.str();
 		fragmentCode = fShaderStream.str();
 	}
-	catch (std::ifstream::failure e)
+	catch (const std::ifstream::failure&)
 	{
 		DebugBreak();
-		wmcv::LogMessage("ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ");
+		wmcv::LogError(s_shaderLog, "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ");
 	}
 
 	const char* vShaderCode = vertexCode.c_str();
@@ -55,7 +141,7 @@ Shader::Shader(const std::filesystem::path& vertexPath, const std::filesystem::p
 	if (!success)
 	{
 		glGetShaderInfoLog(vertex, 512, NULL, infoLog);
-		wmcv::LogMessage("ERROR::SHADER::VERTEX::COMPILATION_FAILED\n{}", infoLog); 
+		wmcv::LogError(s_shaderLog, "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n{}", infoLog); 
 		DebugBreak();
 	};
 
@@ -67,7 +153,7 @@ Shader::Shader(const std::filesystem::path& vertexPath, const std::filesystem::p
 	if (!success)
 	{
 		glGetShaderInfoLog(fragment, 512, NULL, infoLog);
-		wmcv::LogMessage("ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n{}", infoLog); 
+		wmcv::LogError(s_shaderLog, "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n{}", infoLog); 
 		DebugBreak();
 	};
 
@@ -80,81 +166,248 @@ Shader::Shader(const std::filesystem::path& vertexPath, const std::filesystem::p
 	if (!success)
 	{
 		glGetProgramInfoLog(m_programId, 512, NULL, infoLog);
-		wmcv::LogMessage("ERROR::SHADER::PROGRAM::LINKING_FAILED\n{}", infoLog);
+		wmcv::LogError(s_shaderLog, "ERROR::SHADER::PROGRAM::LINKING_FAILED\n{}", infoLog);
 		DebugBreak();
 	}
 
 	glDeleteShader(vertex);
 	glDeleteShader(fragment);
+
+	if (success)
+		buildUniformTable();
 }
 
 Shader::~Shader()
 {
-	glDeleteShader(m_programId);
+	if (m_programId != 0)
+	{
+		GetGLState().forgetProgram(m_programId);
+		glDeleteProgram(m_programId);
+	}
+}
+
+Shader::Shader(Shader&& other) noexcept
+	: m_programId(std::exchange(other.m_programId, 0u))
+	, m_names(std::move(other.m_names))
+	, m_slots(std::move(other.m_slots))
+	, m_shadow(std::move(other.m_shadow))
+	, m_uploadStats(std::exchange(other.m_uploadStats, {}))
+{
+	other.m_names.clear();
+	other.m_slots.clear();
+	other.m_shadow.clear();
+}
+
+Shader& Shader::operator=(Shader&& other) noexcept
+{
+	if (this != &other)
+	{
+		if (m_programId != 0)
+		{
+			GetGLState().forgetProgram(m_programId);
+			glDeleteProgram(m_programId);
+		}
+
+		m_programId = std::exchange(other.m_programId, 0u);
+		m_names = std::move(other.m_names);
+		m_slots = std::move(other.m_slots);
+		m_shadow = std::move(other.m_shadow);
+		m_uploadStats = std::exchange(other.m_uploadStats, {});
+		other.m_names.clear();
+		other.m_slots.clear();
+		other.m_shadow.clear();
+	}
+	return *this;
+}
+
+void Shader::buildUniformTable()
+{
+	m_names.clear();
+	m_slots.clear();
+	m_shadow.clear();
+
+	GLint count = 0;
+	GLint maxLength = 0;
+	glGetProgramiv(m_programId, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(m_programId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+	std::string name(static_cast<size_t>(std::max(maxLength, 1)), '\0');
+	std::string element;
+	for (GLint i = 0; i < count; ++i)
+	{
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(m_programId, static_cast<GLuint>(i), static_cast<GLsizei>(name.size()), &length, &size, &type, name.data());
+		const std::string_view activeName{name.data(), static_cast<size_t>(length)};
+
+		// Arrays of plain types are reported once as "name[0]", but every
+		// element and the bare name are valid lookups too.
+		if (size > 1 && activeName.ends_with("[0]"))
+		{
+			const std::string_view base = activeName.substr(0, activeName.size() - 3);
+			for (GLint e = 0; e < size; ++e)
+			{
+				element.assign(base).append("[").append(std::to_string(e)).append("]");
+				const GLint location = glGetUniformLocation(m_programId, element.c_str());
+				if (location < 0)
+					continue;
+
+				addUniform(element, location, UniformTypeSize(type));
+				if (e == 0)
+					m_names.insert(HashUniformName(base), static_cast<int32_t>(m_slots.size() - 1));
+			}
+			continue;
+		}
+
+		// Members of uniform blocks have no location.
+		const GLint location = glGetUniformLocation(m_programId, name.data());
+		if (location >= 0)
+			addUniform(activeName, location, UniformTypeSize(type));
+	}
+
+	wmcv::LogDebug(s_shaderLog, "program {} has {} uniform locations", m_programId, m_names.size());
+}
+
+void Shader::addUniform(std::string_view name, int32_t location, uint32_t size)
+{
+	const auto offset = static_cast<uint32_t>(m_shadow.size());
+	m_shadow.resize(m_shadow.size() + size);
+	m_names.insert(HashUniformName(name), static_cast<int32_t>(m_slots.size()));
+	m_slots.push_back(UniformSlot{location, offset, size, false});
+}
+
+bool Shader::changed(int32_t slotIndex, const void* value, uint32_t size)
+{
+	UniformSlot& slot = m_slots[static_cast<size_t>(slotIndex)];
+	if (size > slot.size)
+	{
+		// Set through a handle of the wrong type, nothing sensible to compare against.
+		++m_uploadStats.uploaded;
+		return true;
+	}
+
+	std::byte* shadow = m_shadow.data() + slot.offset;
+	if (slot.written && std::memcmp(shadow, value, size) == 0)
+	{
+		++m_uploadStats.skipped;
+		return false;
+	}
+
+	std::memcpy(shadow, value, size);
+	slot.written = true;
+	++m_uploadStats.uploaded;
+	return true;
 }
 
 void Shader::on()
 {
-	glUseProgram(m_programId);
+	GetGLState().useProgram(m_programId);
 }
 
 void Shader::off()
 {
-	glUseProgram(0);
+	GetGLState().useProgram(0);
+}
+
+void Shader::set(UniformHandle<bool> handle, bool value)
+{
+	const int asInt = static_cast<int>(value);
+	if (handle.valid() && changed(handle.slot, &asInt, sizeof(asInt)))
+		glUniform1i(handle.location, asInt);
+}
+
+void Shader::set(UniformHandle<int> handle, int value)
+{
+	if (handle.valid() && changed(handle.slot, &value, sizeof(value)))
+		glUniform1i(handle.location, value);
+}
+
+void Shader::set(UniformHandle<float> handle, float value)
+{
+	if (handle.valid() && changed(handle.slot, &value, sizeof(value)))
+		glUniform1f(handle.location, value);
+}
+
+void Shader::set(UniformHandle<glm::vec2> handle, glm::vec2 value)
+{
+	if (handle.valid() && changed(handle.slot, &value, sizeof(value)))
+		glUniform2fv(handle.location, 1, glm::value_ptr(value));
+}
+
+void Shader::set(UniformHandle<glm::vec3> handle, glm::vec3 value)
+{
+	if (handle.valid() && changed(handle.slot, &value, sizeof(value)))
+		glUniform3fv(handle.location, 1, glm::value_ptr(value));
+}
+
+void Shader::set(UniformHandle<glm::vec4> handle, glm::vec4 value)
+{
+	if (handle.valid() && changed(handle.slot, &value, sizeof(value)))
+		glUniform4fv(handle.location, 1, glm::value_ptr(value));
+}
+
+void Shader::set(UniformHandle<glm::mat2> handle, const glm::mat2& value)
+{
+	if (handle.valid() && changed(handle.slot, &value, sizeof(value)))
+		glUniformMatrix2fv(handle.location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::set(UniformHandle<glm::mat3> handle, const glm::mat3& value)
+{
+	if (handle.valid() && changed(handle.slot, &value, sizeof(value)))
+		glUniformMatrix3fv(handle.location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::set(UniformHandle<glm::mat4> handle, const glm::mat4& value)
+{
+	if (handle.valid() && changed(handle.slot, &value, sizeof(value)))
+		glUniformMatrix4fv(handle.location, 1, GL_FALSE, glm::value_ptr(value));
 }
 
-void Shader::setBool(const std::string_view name, bool value) const
+void Shader::setBool(const std::string_view name, bool value)
 {
-	const GLint location = glGetUniformLocation(m_programId, name.data());
-	glUniform1i(location, static_cast<int>(value));
+	set(uniform<bool>(name), value);
 }
 
-void Shader::setInt(const std::string_view name, int value) const
+void Shader::setInt(const std::string_view name, int value)
 {
-	const GLint location = glGetUniformLocation(m_programId, name.data());
-	glUniform1i(location, value);
+	set(uniform<int>(name), value);
 }
 
-void Shader::setFloat(const std::string_view name, float value) const
+void Shader::setFloat(const std::string_view name, float value)
 {
-	const GLint location = glGetUniformLocation(m_programId, name.data());
-	glUniform1f(location, value);
+	set(uniform<float>(name), value);
 }
 
-void Shader::setVec2(const std::string_view name, glm::vec2 value) const
+void Shader::setVec2(const std::string_view name, glm::vec2 value)
 {
-	const GLint location = glGetUniformLocation(m_programId, name.data());
-	glUniform2fv(location, 1, glm::value_ptr(value));
+	set(uniform<glm::vec2>(name), value);
 }
 
-void Shader::setVec3(const std::string_view name, glm::vec3 value) const
+void Shader::setVec3(const std::string_view name, glm::vec3 value)
 {
-	const GLint location = glGetUniformLocation(m_programId, name.data());
-	glUniform3fv(location, 1, glm::value_ptr(value));
+	set(uniform<glm::vec3>(name), value);
 }
 
-void Shader::setVec4(const std::string_view name, glm::vec4 value) const
+void Shader::setVec4(const std::string_view name, glm::vec4 value)
 {
-	const GLint location = glGetUniformLocation(m_programId, name.data());
-	glUniform4fv(location, 1, glm::value_ptr(value));
+	set(uniform<glm::vec4>(name), value);
 }
 
 void Shader::setMat2(const std::string_view name, const glm::mat2& value)
 {
-	const GLint location = glGetUniformLocation(m_programId, name.data());
-	glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+	set(uniform<glm::mat2>(name), value);
 }
 
 void Shader::setMat3(const std::string_view name, const glm::mat3& value)
 {
-	const GLint location = glGetUniformLocation(m_programId, name.data());
-	glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+	set(uniform<glm::mat3>(name), value);
 }
 
 void Shader::setMat4(const std::string_view name, const glm::mat4& value)
 {
-	const GLint location = glGetUniformLocation(m_programId, name.data());
-	glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+	set(uniform<glm::mat4>(name), value);
 }
 
 }
\ No newline at end of file
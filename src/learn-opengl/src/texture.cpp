@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "texture.h"
 #include "opengl.h"
+#include "gl_state.h"
 
 #include "wmcv_log/wmcv_log.h"
 
@@ -10,6 +11,11 @@
 namespace wmcv
 {
 
+namespace
+{
+LogCategory s_textureLog{"texture"};
+}
+
 Texture::Texture(const std::filesystem::path& path, bool flip)
 {
 	stbi_set_flip_vertically_on_load(static_cast<int>(flip));
@@ -32,7 +38,7 @@ Texture::Texture(const std::filesystem::path& path, bool flip)
 
 		}(nrChannels);
 
-		glBindTexture(GL_TEXTURE_2D, m_textureId);
+		GetGLState().bindTexture(0, m_textureId);
 		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, raw);
 		glGenerateMipmap(GL_TEXTURE_2D);
 
@@ -45,19 +51,18 @@ Texture::Texture(const std::filesystem::path& path, bool flip)
 	}
 	else
 	{
-		wmcv::LogMessage("Failed to load image: {}", path.string().c_str());
+		wmcv::LogWarning(s_textureLog, "Failed to load image: {}", path.string().c_str());
 	}
 }
 
 void Texture::on(uint32_t slot)
 {
-	glActiveTexture(GL_TEXTURE0 + slot);
-	glBindTexture(GL_TEXTURE_2D, m_textureId);
+	GetGLState().bindTexture(slot, m_textureId);
 }
 
-void Texture::off()
+void Texture::off(uint32_t slot)
 {
-	glActiveTexture(0);
+	GetGLState().bindTexture(slot, 0);
 }
 
 } // namespace wmcv
@@ -0,0 +1,487 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <source_location>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "wmcv_log/wmcv_log.h"
+#include "wmcv_log/wmcv_async_log_system.h"
+#include "wmcv_log/sinks/wmcv_sink_mappedfile.h"
+#include "wmcv_log/sinks/wmcv_sink_compressedfile.h"
+
+// Measures the cost of a LogMessage call as seen by the calling thread.
+//
+//   wmcv-log-bench [--messages N] [--filter text] [--label text] [--json path]
+//
+// Every scenario prints messages/sec over the whole run and the p50/p99/p99.9
+// latency of individual calls. The file sinks are then driven directly and
+// report input bytes/sec, including the time to get everything on disk, and
+// the size of what they wrote. --json writes the same numbers for comparing
+// runs between commits.
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+enum class SystemKind
+{
+	Default,
+	Async
+};
+
+enum class ArgumentMix
+{
+	None,
+	Integers,
+	Mixed,
+	LongString
+};
+
+struct Scenario
+{
+	SystemKind system;
+	ArgumentMix args;
+	size_t threads;
+	size_t sinks;
+};
+
+struct Result
+{
+	std::string name;
+	Scenario scenario;
+	size_t messages;
+	double messagesPerSec;
+	uint64_t p50Ns;
+	uint64_t p99Ns;
+	uint64_t p999Ns;
+};
+
+enum class SinkKind
+{
+	MappedFile,
+	CompressedFile
+};
+
+struct SinkResult
+{
+	std::string name;
+	size_t messages;
+	uint64_t inputBytes;
+	uint64_t outputBytes;
+	double bytesPerSec;
+};
+
+struct Options
+{
+	size_t messagesPerThread = 200000;
+	std::string filter;
+	std::string label;
+	std::filesystem::path jsonPath;
+};
+
+auto ToString(SystemKind kind) -> std::string_view
+{
+	return kind == SystemKind::Default ? "default" : "async";
+}
+
+auto ToString(ArgumentMix mix) -> std::string_view
+{
+	switch (mix)
+	{
+		case ArgumentMix::None: return "none";
+		case ArgumentMix::Integers: return "integers";
+		case ArgumentMix::Mixed: return "mixed";
+		case ArgumentMix::LongString: return "long_string";
+	}
+	return "unknown";
+}
+
+// Consumes the text so the formatting work cannot be optimized away.
+struct NullSink
+{
+	std::atomic<size_t>* bytes;
+};
+
+auto Log(NullSink& sink, const std::string_view message) noexcept -> void
+{
+	sink.bytes->fetch_add(message.length(), std::memory_order_relaxed);
+}
+
+const std::string LongText(400, 'x');
+
+void LogOne(ArgumentMix mix, size_t i)
+{
+	switch (mix)
+	{
+		case ArgumentMix::None:
+			wmcv::LogMessage("ERROR::SHADER::PROGRAM::LINKING_FAILED");
+			break;
+		case ArgumentMix::Integers:
+			wmcv::LogMessage("frame {} draw calls {} triangles {}", i, 1024, int64_t{-7});
+			break;
+		case ArgumentMix::Mixed:
+			wmcv::LogMessage("Failed to load image: {} ({}x{}) in {} ms", "container2_diffuse.png", 512, 512, 16.6f);
+			break;
+		case ArgumentMix::LongString:
+			wmcv::LogMessage("shader info log: {}", LongText.c_str());
+			break;
+	}
+}
+
+auto ScenarioName(const Scenario& scenario) -> std::string
+{
+	return std::string{ToString(scenario.system)} + "/" + std::string{ToString(scenario.args)} + "/threads:" +
+		   std::to_string(scenario.threads) + "/sinks:" + std::to_string(scenario.sinks);
+}
+
+auto Percentile(const std::vector<uint32_t>& sorted, double percentile) -> uint64_t
+{
+	if (sorted.empty())
+	{
+		return 0;
+	}
+
+	const auto index = static_cast<size_t>(percentile * static_cast<double>(sorted.size() - 1));
+	return sorted[index];
+}
+
+auto Run(const Scenario& scenario, size_t messagesPerThread) -> Result
+{
+	std::atomic<size_t> bytes = 0;
+	std::unique_ptr<wmcv::AsyncLogSystem> asyncSystem;
+	if (scenario.system == SystemKind::Async)
+	{
+		asyncSystem = std::make_unique<wmcv::AsyncLogSystem>(wmcv::AsyncLogSystemParams{.capacity = 8192, .overflowPolicy = wmcv::LogOverflowPolicy::Block});
+		wmcv::SetLogSystem(asyncSystem.get());
+	}
+	else
+	{
+		wmcv::CreateDefaultLogSystem();
+	}
+
+	for (size_t i = 0; i < scenario.sinks; ++i)
+	{
+		wmcv::GetLogSystem().PushSink(NullSink{&bytes});
+	}
+
+	std::vector<std::vector<uint32_t>> latencies(scenario.threads);
+	std::vector<std::thread> threads;
+	std::atomic<size_t> ready = 0;
+	std::atomic<bool> start = false;
+
+	for (size_t t = 0; t < scenario.threads; ++t)
+	{
+		threads.emplace_back([&, t]
+			{
+				auto& samples = latencies[t];
+				samples.resize(messagesPerThread);
+				ready.fetch_add(1);
+				while (!start.load(std::memory_order_acquire))
+				{
+					std::this_thread::yield();
+				}
+
+				for (size_t i = 0; i < messagesPerThread; ++i)
+				{
+					const auto before = Clock::now();
+					LogOne(scenario.args, i);
+					const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - before).count();
+					samples[i] = static_cast<uint32_t>(std::min<int64_t>(elapsed, UINT32_MAX));
+				}
+			});
+	}
+
+	while (ready.load() < scenario.threads)
+	{
+		std::this_thread::yield();
+	}
+
+	const auto begin = Clock::now();
+	start.store(true, std::memory_order_release);
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	wmcv::GetLogSystem().Flush();
+	const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+	asyncSystem.reset();
+	wmcv::CreateDefaultLogSystem();
+
+	std::vector<uint32_t> all;
+	all.reserve(scenario.threads * messagesPerThread);
+	for (const auto& samples : latencies)
+	{
+		all.insert(all.end(), samples.begin(), samples.end());
+	}
+	std::sort(all.begin(), all.end());
+
+	Result result;
+	result.name = ScenarioName(scenario);
+	result.scenario = scenario;
+	result.messages = all.size();
+	result.messagesPerSec = static_cast<double>(all.size()) / seconds;
+	result.p50Ns = Percentile(all, 0.50);
+	result.p99Ns = Percentile(all, 0.99);
+	result.p999Ns = Percentile(all, 0.999);
+	return result;
+}
+
+auto ToString(SinkKind kind) -> std::string_view
+{
+	return kind == SinkKind::MappedFile ? "mapped_file" : "compressed_file";
+}
+
+auto SinkScenarioName(SinkKind kind) -> std::string
+{
+	return "sink/" + std::string{ToString(kind)};
+}
+
+// Varied enough that the compressor cannot just repeat one line.
+auto SinkLines() -> std::vector<std::string>
+{
+	std::vector<std::string> lines;
+	for (size_t i = 0; i < 4096; ++i)
+	{
+		wmcv::FormatString line;
+		wmcv::format(line, "[{}.{}] [T{}] Failed to load image: {} ({}x{}) in {} ms", 12 + i / 8, 100003 * i % 1000000, i % 5,
+			i % 3 ? "container2_diffuse.png" : "awesomeface.png", 512 >> (i % 4), 256 + i, 16.6f + static_cast<float>(i) * 0.37f);
+		lines.emplace_back(line.view());
+	}
+	return lines;
+}
+
+template <typename Sink>
+auto DriveSink(Sink sink, const std::vector<std::string>& lines, size_t messages) -> uint64_t
+{
+	uint64_t bytes = 0;
+	for (size_t i = 0; i < messages; ++i)
+	{
+		const std::string& line = lines[i % lines.size()];
+		Log(sink, line);
+		bytes += line.size() + 1;
+	}
+	return bytes;
+}
+
+auto RunSink(SinkKind kind, size_t messages) -> SinkResult
+{
+	const auto directory = std::filesystem::temp_directory_path() / "wmcv-log-bench";
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+	std::filesystem::create_directories(directory, error);
+	const auto path = directory / "bench.log";
+
+	const std::vector<std::string> lines = SinkLines();
+	size_t longest = 0;
+	for (const auto& line : lines)
+	{
+		longest = std::max(longest, line.size() + 1);
+	}
+
+	// The sinks are destroyed inside the timed region so the numbers include
+	// trimming the mapping or compressing and writing the last blocks.
+	const auto begin = Clock::now();
+	uint64_t inputBytes = 0;
+	if (kind == SinkKind::MappedFile)
+	{
+		inputBytes = DriveSink(wmcv::LogSinkMappedFile{{.path = path, .segmentSize = messages * longest + 1}}, lines, messages);
+	}
+	else
+	{
+		inputBytes = DriveSink(wmcv::LogSinkCompressedFile{{.path = path}}, lines, messages);
+	}
+	const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+	SinkResult result;
+	result.name = SinkScenarioName(kind);
+	result.messages = messages;
+	result.inputBytes = inputBytes;
+	result.outputBytes = std::filesystem::file_size(path, error);
+	result.bytesPerSec = static_cast<double>(inputBytes) / seconds;
+	std::filesystem::remove_all(directory, error);
+	return result;
+}
+
+auto Scenarios() -> std::vector<Scenario>
+{
+	std::vector<Scenario> scenarios;
+	const size_t hardwareThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+	for (const SystemKind system : {SystemKind::Default, SystemKind::Async})
+	{
+		for (const ArgumentMix args : {ArgumentMix::None, ArgumentMix::Integers, ArgumentMix::Mixed, ArgumentMix::LongString})
+		{
+			scenarios.push_back({system, args, 1, 1});
+		}
+
+		for (const size_t sinks : {size_t{0}, size_t{4}})
+		{
+			scenarios.push_back({system, ArgumentMix::Mixed, 1, sinks});
+		}
+	}
+
+	// Only the async system is safe to call from several threads at once.
+	for (size_t threads = 2; threads <= std::max<size_t>(hardwareThreads, 4); threads *= 2)
+	{
+		scenarios.push_back({SystemKind::Async, ArgumentMix::Mixed, threads, 1});
+	}
+
+	return scenarios;
+}
+
+auto ParseOptions(int argc, char** argv, Options& options) -> bool
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+		if (arg == "--messages" && hasValue)
+		{
+			const std::string_view value = argv[++i];
+			std::from_chars(value.data(), value.data() + value.size(), options.messagesPerThread);
+		}
+		else if (arg == "--filter" && hasValue)
+		{
+			options.filter = argv[++i];
+		}
+		else if (arg == "--label" && hasValue)
+		{
+			options.label = argv[++i];
+		}
+		else if (arg == "--json" && hasValue)
+		{
+			options.jsonPath = argv[++i];
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--messages N] [--filter text] [--label text] [--json path]\n", argv[0]);
+			return false;
+		}
+	}
+
+	return options.messagesPerThread > 0;
+}
+
+// Quoted JSON string with quotes, backslashes and control characters escaped.
+auto JsonString(std::string_view text) -> std::string
+{
+	std::string out = "\"";
+	for (const char c : text)
+	{
+		if (c == '"' || c == '\\')
+		{
+			out += '\\';
+			out += c;
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			std::array<char, 8> escaped;
+			std::snprintf(escaped.data(), escaped.size(), "\\u%04x", static_cast<unsigned>(c));
+			out += escaped.data();
+		}
+		else
+		{
+			out += c;
+		}
+	}
+	out += '"';
+	return out;
+}
+
+auto WriteJson(const std::filesystem::path& path, const Options& options, const std::vector<Result>& results, const std::vector<SinkResult>& sinkResults) -> bool
+{
+	std::ofstream file{path};
+	if (!file)
+	{
+		return false;
+	}
+
+	file << "{\n  \"benchmark\": \"wmcv-log-bench\",\n  \"label\": " << JsonString(options.label) << ",\n";
+	file << "  \"messages_per_thread\": " << options.messagesPerThread << ",\n  \"results\": [\n";
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const Result& result = results[i];
+		file << "    {\"name\": " << JsonString(result.name) << ", \"system\": \"" << ToString(result.scenario.system)
+			 << "\", \"args\": \"" << ToString(result.scenario.args) << "\", \"threads\": " << result.scenario.threads
+			 << ", \"sinks\": " << result.scenario.sinks << ", \"messages\": " << result.messages
+			 << ", \"messages_per_sec\": " << static_cast<uint64_t>(result.messagesPerSec) << ", \"p50_ns\": " << result.p50Ns
+			 << ", \"p99_ns\": " << result.p99Ns << ", \"p999_ns\": " << result.p999Ns << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	file << "  ],\n  \"sinks\": [\n";
+	for (size_t i = 0; i < sinkResults.size(); ++i)
+	{
+		const SinkResult& result = sinkResults[i];
+		file << "    {\"name\": " << JsonString(result.name) << ", \"messages\": " << result.messages << ", \"input_bytes\": " << result.inputBytes
+			 << ", \"output_bytes\": " << result.outputBytes << ", \"bytes_per_sec\": " << static_cast<uint64_t>(result.bytesPerSec) << "}"
+			 << (i + 1 < sinkResults.size() ? "," : "") << "\n";
+	}
+	file << "  ]\n}\n";
+	return static_cast<bool>(file);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		return 1;
+	}
+
+	std::printf("%-40s %14s %10s %10s %10s\n", "scenario", "msgs/sec", "p50 ns", "p99 ns", "p99.9 ns");
+
+	std::vector<Result> results;
+	for (const Scenario& scenario : Scenarios())
+	{
+		if (!options.filter.empty() && ScenarioName(scenario).find(options.filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		Result result = Run(scenario, options.messagesPerThread);
+
+		std::printf("%-40s %14.0f %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n", result.name.c_str(), result.messagesPerSec, result.p50Ns, result.p99Ns, result.p999Ns);
+		results.push_back(std::move(result));
+	}
+
+	std::printf("\n%-40s %14s %14s %10s\n", "sink", "input MB/s", "output bytes", "ratio");
+
+	std::vector<SinkResult> sinkResults;
+	for (const SinkKind kind : {SinkKind::MappedFile, SinkKind::CompressedFile})
+	{
+		if (!options.filter.empty() && SinkScenarioName(kind).find(options.filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		SinkResult result = RunSink(kind, options.messagesPerThread);
+		const double ratio = result.outputBytes > 0 ? static_cast<double>(result.inputBytes) / static_cast<double>(result.outputBytes) : 0.0;
+		std::printf("%-40s %14.1f %14" PRIu64 " %9.2fx\n", result.name.c_str(), result.bytesPerSec / (1024.0 * 1024.0), result.outputBytes, ratio);
+		sinkResults.push_back(std::move(result));
+	}
+
+	if (!options.jsonPath.empty() && !WriteJson(options.jsonPath, options, results, sinkResults))
+	{
+		std::fprintf(stderr, "failed to write %s\n", options.jsonPath.string().c_str());
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,67 @@
+#ifndef WMCV_SINK_COMPRESSEDFILE_H_INCLUDED
+#define WMCV_SINK_COMPRESSEDFILE_H_INCLUDED
+
+#include "wmcv_log/wmcv_log_record.h"
+
+namespace wmcv
+{
+	struct LogSinkCompressedFileParams
+	{
+		std::filesystem::path path;
+		size_t blockSize = 64 * 1024;
+		size_t maxPendingBlocks = 8;
+		std::chrono::milliseconds flushInterval{1000};
+	};
+
+	// Collects messages, one per line, into blocks of blockSize bytes and hands
+	// each full block to a background thread that compresses it and appends
+	// it to the file. Blocks share no state, so a reader can start at any
+	// block and a torn block at the end costs only that block. A partial block
+	// is written after flushInterval, on Flush() and on destruction. Writers
+	// wait once maxPendingBlocks are queued. Existing files are appended to.
+	// Records from a log system are prefixed with their rendered header.
+	class LogSinkCompressedFile
+	{
+	public:
+		explicit LogSinkCompressedFile(LogSinkCompressedFileParams params);
+		~LogSinkCompressedFile();
+
+		LogSinkCompressedFile(LogSinkCompressedFile&&) noexcept;
+		LogSinkCompressedFile& operator=(LogSinkCompressedFile&&) noexcept;
+		LogSinkCompressedFile(const LogSinkCompressedFile&) = delete;
+		LogSinkCompressedFile& operator=(const LogSinkCompressedFile&) = delete;
+
+		void Write(std::string_view message) noexcept;
+		void Write(const LogRecord& record) noexcept;
+
+		// Returns once everything written so far is on disk.
+		void Flush() noexcept;
+
+		[[nodiscard]] auto IsOpen() const noexcept -> bool;
+		[[nodiscard]] auto BytesWritten() const noexcept -> uint64_t;
+
+	private:
+		struct State;
+		std::unique_ptr<State> m_state;
+	};
+
+	auto Log(LogSinkCompressedFile& sink, const std::string_view message) noexcept -> void;
+	auto Log(LogSinkCompressedFile& sink, std::span<const LogRecord> records) noexcept -> void;
+
+	struct CompressedLogDecodeResult
+	{
+		size_t blocks = 0;
+		size_t bytes = 0;
+		size_t skippedBytes = 0;
+		bool truncated = false;
+	};
+
+	// Calls onBlock with the text of every intact block in order. Bytes that
+	// do not start a valid block are skipped until the next one, so data that
+	// begins mid-block (a tailed copy) or holds a corrupt header still
+	// decodes; a block cut short at the end sets truncated.
+	auto DecodeCompressedLog(std::span<const std::byte> data, const std::function<void(std::string_view text)>& onBlock) -> CompressedLogDecodeResult;
+	auto LoadCompressedLogFile(const std::filesystem::path& path) -> std::vector<std::byte>;
+} // namespace wmcv
+
+#endif
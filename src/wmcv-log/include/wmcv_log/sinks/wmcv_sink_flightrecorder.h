@@ -0,0 +1,52 @@
+#ifndef WMCV_SINK_FLIGHTRECORDER_H_INCLUDED
+#define WMCV_SINK_FLIGHTRECORDER_H_INCLUDED
+
+#include "wmcv_log/wmcv_log_record.h"
+
+namespace wmcv
+{
+	struct LogSinkFlightRecorderParams
+	{
+		std::filesystem::path path;
+		size_t capacity = 256 * 1024;
+		size_t slotSize = 256;
+	};
+
+	// Keeps the most recent records in a fixed ring of slots inside a mapped
+	// file, so they outlive a crash of the process. Each write claims a slot
+	// with one fetch_add and publishes it by storing its sequence number last;
+	// messages longer than a slot are truncated. Records from a log system are
+	// prefixed with their rendered header. A file left by a previous run
+	// is moved to LogSegmentPath(path, 1) before the new ring is created.
+	class LogSinkFlightRecorder
+	{
+	public:
+		explicit LogSinkFlightRecorder(LogSinkFlightRecorderParams params);
+		~LogSinkFlightRecorder();
+
+		LogSinkFlightRecorder(LogSinkFlightRecorder&&) noexcept;
+		LogSinkFlightRecorder& operator=(LogSinkFlightRecorder&&) noexcept;
+		LogSinkFlightRecorder(const LogSinkFlightRecorder&) = delete;
+		LogSinkFlightRecorder& operator=(const LogSinkFlightRecorder&) = delete;
+
+		void Write(std::string_view message) noexcept;
+		void Write(const LogRecord& record) noexcept;
+
+		[[nodiscard]] auto IsOpen() const noexcept -> bool;
+		[[nodiscard]] auto SlotCount() const noexcept -> size_t;
+
+	private:
+		struct State;
+		std::unique_ptr<State> m_state;
+	};
+
+	auto Log(LogSinkFlightRecorder& sink, const std::string_view message) noexcept -> void;
+	auto Log(LogSinkFlightRecorder& sink, std::span<const LogRecord> records) noexcept -> void;
+
+	// Calls onRecord oldest first for every published slot. Returns false if
+	// data is not a flight recorder image.
+	auto ReadFlightRecorder(std::span<const std::byte> data, const std::function<void(uint64_t sequence, std::string_view message)>& onRecord) -> bool;
+	auto LoadFlightRecorderFile(const std::filesystem::path& path) -> std::vector<std::byte>;
+} // namespace wmcv
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef WMCV_SINK_MAPPEDFILE_H_INCLUDED
+#define WMCV_SINK_MAPPEDFILE_H_INCLUDED
+
+#include "wmcv_log/wmcv_log_record.h"
+
+namespace wmcv
+{
+	struct LogSinkMappedFileParams
+	{
+		std::filesystem::path path;
+		size_t segmentSize = 4 * 1024 * 1024;
+		size_t retainedSegments = 4;
+		size_t reopenAfterDrops = 64;
+	};
+
+	// Writes each message plus a newline into a pre-sized, memory-mapped
+	// segment. Records from a log system are prefixed with their rendered
+	// header. A full segment is trimmed and renamed to name.1.ext (older ones
+	// shift up, the oldest beyond retainedSegments is deleted) and a fresh
+	// segment is mapped. Messages that cannot be written, because the sink is
+	// closed or a roll failed, are counted and dropped; a closed sink tries
+	// to reopen its segment after every reopenAfterDrops drops. Not
+	// synchronized, so it asks the sink registry to serialize its calls.
+	class LogSinkMappedFile
+	{
+	public:
+		static constexpr bool SerializeLogCalls = true;
+
+		explicit LogSinkMappedFile(LogSinkMappedFileParams params);
+		~LogSinkMappedFile();
+
+		LogSinkMappedFile(LogSinkMappedFile&&) noexcept;
+		LogSinkMappedFile& operator=(LogSinkMappedFile&&) noexcept;
+		LogSinkMappedFile(const LogSinkMappedFile&) = delete;
+		LogSinkMappedFile& operator=(const LogSinkMappedFile&) = delete;
+
+		void Write(std::string_view message) noexcept;
+		void Write(const LogRecord& record) noexcept;
+		void Flush() noexcept;
+
+		[[nodiscard]] auto IsOpen() const noexcept -> bool;
+		[[nodiscard]] auto Cursor() const noexcept -> size_t;
+		[[nodiscard]] auto DroppedCount() const noexcept -> uint64_t;
+
+	private:
+		struct State;
+		std::unique_ptr<State> m_state;
+	};
+
+	auto Log(LogSinkMappedFile& sink, const std::string_view message) noexcept -> void;
+	auto Log(LogSinkMappedFile& sink, std::span<const LogRecord> records) noexcept -> void;
+
+	// Path of the index'th rotated segment; index 0 is the active segment.
+	auto LogSegmentPath(const std::filesystem::path& path, size_t index) -> std::filesystem::path;
+
+	// Trims the zero padding a crash leaves after the last write in a segment
+	// and returns the recovered length.
+	auto RecoverLogSegment(const std::filesystem::path& path) -> size_t;
+} // namespace wmcv
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef WMCV_ASYNC_LOG_SYSTEM_H_INCLUDED
+#define WMCV_ASYNC_LOG_SYSTEM_H_INCLUDED
+
+#include "wmcv_log_system.h"
+#include "wmcv_log_sink.h"
+#include "wmcv_ring_buffer.h"
+
+namespace wmcv
+{
+
+enum class LogOverflowPolicy : uint8_t
+{
+	Block,
+	DropNewest,
+	DropOldest
+};
+
+struct AsyncLogSystemParams
+{
+	size_t capacity = 4096;
+	LogOverflowPolicy overflowPolicy = LogOverflowPolicy::Block;
+};
+
+// Producers copy each message into a bounded lock-free ring buffer and return;
+// a backend thread drains the ring and is the only thread that calls the sinks.
+class AsyncLogSystem final : public LogSystem
+{
+public:
+	explicit AsyncLogSystem(const AsyncLogSystemParams& params = {});
+	~AsyncLogSystem() override;
+
+	AsyncLogSystem(AsyncLogSystem&&) = delete;
+	AsyncLogSystem& operator=(AsyncLogSystem&&) = delete;
+
+	auto PushSink(LogSink&& sink) -> LogSinkHandle override;
+	auto RemoveSink(LogSinkHandle handle) -> bool override;
+	using LogSystem::LogMessage;
+	void LogMessage(const LogRecordHeader& header, const std::string_view text) override;
+	void Flush() override;
+
+	[[nodiscard]] auto DroppedCount() const noexcept -> uint64_t { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+	struct Record
+	{
+		static constexpr size_t InlineCapacity = 256;
+
+		void assign(const LogRecordHeader& header, std::string_view text);
+		void take(Record& other);
+		[[nodiscard]] auto view() const -> std::string_view;
+		[[nodiscard]] auto header() const -> const LogRecordHeader& { return m_header; }
+
+		std::array<char, InlineCapacity> m_inline = {};
+		std::string m_overflow;
+		LogRecordHeader m_header;
+		uint32_t m_length = 0;
+	};
+
+	auto TryPush(const LogRecordHeader& header, std::string_view text) -> bool;
+	void WakeBackend();
+	void BackendLoop();
+	auto DrainRecords() -> size_t;
+
+	static constexpr size_t MaxBatchSize = 64;
+
+	BoundedRingBuffer<Record> m_queue;
+	LogOverflowPolicy m_overflowPolicy;
+	std::vector<Record> m_batch;
+	std::vector<LogRecord> m_batchRecords;
+
+	LogSinkRegistry m_sinks;
+
+	std::atomic<uint64_t> m_dropped = 0;
+	std::atomic<size_t> m_drained = 0;
+	std::atomic<uint32_t> m_signal = 0;
+	std::atomic<bool> m_backendSleeping = false;
+	std::atomic<bool> m_running = true;
+	std::thread m_backend;
+};
+
+} // namespace wmcv
+
+#endif // WMCV_ASYNC_LOG_SYSTEM_H_INCLUDED
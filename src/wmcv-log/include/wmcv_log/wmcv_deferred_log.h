@@ -0,0 +1,220 @@
+#ifndef WMCV_DEFERRED_LOG_H_INCLUDED
+#define WMCV_DEFERRED_LOG_H_INCLUDED
+
+#include "wmcv_format.h"
+
+namespace wmcv
+{
+
+// Deferred records hold a format-string id and the raw argument bytes; the
+// text is only rendered later by DecodeDeferredLog (see wmcv-log-decode).
+//
+// Stream layout, values in native byte order and unaligned:
+//   definition: u8 DeferredRecordTag::Definition, u64 id, u8 argCount,
+//               u8 type[argCount], u16 length, char format[length]
+//   message:    u8 DeferredRecordTag::Message, u64 id, u16 size, u8 payload[size]
+// A zero tag marks the end of the stream.
+enum class DeferredRecordTag : uint8_t
+{
+	End = 0,
+	Definition = 1,
+	Message = 2
+};
+
+enum class DeferredArgType : uint8_t
+{
+	Bool,
+	Char,
+	Int8,
+	Int16,
+	Int32,
+	Int64,
+	UInt8,
+	UInt16,
+	UInt32,
+	UInt64,
+	Float,
+	Double,
+	Pointer,
+	String
+};
+
+template <typename T>
+concept is_deferred_string = std::is_same_v<T, const char*> || std::is_same_v<T, char*> || std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>;
+
+template <typename T>
+consteval auto deferred_arg_type() -> DeferredArgType
+{
+	if constexpr (std::is_same_v<T, bool>)
+		return DeferredArgType::Bool;
+	else if constexpr (std::is_same_v<T, char>)
+		return DeferredArgType::Char;
+	else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+		return sizeof(T) == 1 ? DeferredArgType::Int8 : sizeof(T) == 2 ? DeferredArgType::Int16 : sizeof(T) == 4 ? DeferredArgType::Int32 : DeferredArgType::Int64;
+	else if constexpr (std::is_integral_v<T>)
+		return sizeof(T) == 1 ? DeferredArgType::UInt8 : sizeof(T) == 2 ? DeferredArgType::UInt16 : sizeof(T) == 4 ? DeferredArgType::UInt32 : DeferredArgType::UInt64;
+	else if constexpr (std::is_same_v<T, float>)
+		return DeferredArgType::Float;
+	else if constexpr (std::is_same_v<T, double>)
+		return DeferredArgType::Double;
+	else if constexpr (is_deferred_string<T>)
+		return DeferredArgType::String;
+	else
+	{
+		static_assert(std::is_pointer_v<T> || std::is_null_pointer_v<T>, "type cannot be recorded by a deferred log");
+		return DeferredArgType::Pointer;
+	}
+}
+
+template <typename... Args>
+constexpr std::array<DeferredArgType, sizeof...(Args)> DeferredSignature = {deferred_arg_type<Args>()...};
+
+template <typename... Args>
+constexpr uint64_t DeferredSignatureHash = []
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (const DeferredArgType type : DeferredSignature<Args...>)
+	{
+		hash = (hash ^ static_cast<uint8_t>(type)) * 0x100000001b3ull;
+	}
+	return hash;
+}();
+
+class DeferredLogWriter
+{
+public:
+	static constexpr size_t MaxStringLength = 0xFFFF;
+
+	explicit DeferredLogWriter(size_t capacity, size_t maxFormats = 1024);
+
+	DeferredLogWriter(const DeferredLogWriter&) = delete;
+	DeferredLogWriter& operator=(const DeferredLogWriter&) = delete;
+
+	// Safe to call from any number of threads; records that do not fit are
+	// counted and dropped.
+	template <typename... Args>
+	void Write(FormatSpec<Args...> fmt, Args&&... args);
+
+	[[nodiscard]] auto Bytes() const -> std::span<const std::byte>;
+	[[nodiscard]] auto DroppedCount() const noexcept -> uint64_t { return m_dropped.load(std::memory_order_relaxed); }
+
+	// Not thread safe; writers must be quiescent.
+	void Reset();
+	auto SaveToFile(const std::filesystem::path& path) const -> bool;
+
+private:
+	template <typename T>
+	static constexpr auto encoded_size(const T& value) -> size_t;
+
+	template <typename T>
+	static auto encode(std::byte* out, const T& value) -> std::byte*;
+
+	auto Reserve(size_t size) -> std::byte*;
+	auto ClaimFormat(uint64_t id) -> bool;
+	void WriteDefinition(uint64_t id, std::string_view format, std::span<const DeferredArgType> signature);
+
+	std::unique_ptr<std::byte[]> m_buffer;
+	size_t m_capacity;
+	std::unique_ptr<std::atomic<uint64_t>[]> m_formats;
+	size_t m_formatMask;
+
+	std::atomic<size_t> m_cursor = 0;
+	std::atomic<uint64_t> m_dropped = 0;
+};
+
+template <typename T>
+constexpr auto DeferredLogWriter::encoded_size(const T& value) -> size_t
+{
+	if constexpr (is_deferred_string<T>)
+		return sizeof(uint16_t) + std::min(std::string_view{value}.length(), MaxStringLength);
+	else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>)
+		return sizeof(uint64_t);
+	else
+		return sizeof(T);
+}
+
+template <typename T>
+auto DeferredLogWriter::encode(std::byte* out, const T& value) -> std::byte*
+{
+	if constexpr (is_deferred_string<T>)
+	{
+		const std::string_view str{value};
+		const auto length = static_cast<uint16_t>(std::min(str.length(), MaxStringLength));
+		std::memcpy(out, &length, sizeof(length));
+		std::memcpy(out + sizeof(length), str.data(), length);
+		return out + sizeof(length) + length;
+	}
+	else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>)
+	{
+		const uint64_t address = reinterpret_cast<uintptr_t>(value);
+		std::memcpy(out, &address, sizeof(address));
+		return out + sizeof(address);
+	}
+	else
+	{
+		std::memcpy(out, &value, sizeof(T));
+		return out + sizeof(T);
+	}
+}
+
+template <typename... Args>
+void DeferredLogWriter::Write(FormatSpec<Args...> fmt, Args&&... args)
+{
+	const uint64_t id = fmt.hash() ^ DeferredSignatureHash<std::decay_t<Args>...>;
+	if (ClaimFormat(id))
+	{
+		WriteDefinition(id, fmt.view(), DeferredSignature<std::decay_t<Args>...>);
+	}
+
+	constexpr size_t HeaderSize = sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint16_t);
+	const size_t payloadSize = (size_t{0} + ... + encoded_size<std::decay_t<Args>>(args));
+	if (payloadSize > 0xFFFF)
+	{
+		m_dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	std::byte* out = Reserve(HeaderSize + payloadSize);
+	if (!out)
+	{
+		return;
+	}
+
+	const auto size = static_cast<uint16_t>(payloadSize);
+	std::memcpy(out + sizeof(uint8_t), &id, sizeof(id));
+	std::memcpy(out + sizeof(uint8_t) + sizeof(id), &size, sizeof(size));
+
+	[[maybe_unused]] std::byte* payload = out + HeaderSize;
+	((payload = encode<std::decay_t<Args>>(payload, args)), ...);
+
+	std::atomic_ref<std::byte>{out[0]}.store(static_cast<std::byte>(DeferredRecordTag::Message), std::memory_order_release);
+}
+
+struct DeferredDecodeResult
+{
+	size_t messages = 0;
+	size_t unknownFormats = 0;
+	bool truncated = false;
+};
+
+// Renders each message through the regular Formatter<> specializations.
+auto DecodeDeferredLog(std::span<const std::byte> data, const std::function<void(std::string_view)>& onMessage) -> DeferredDecodeResult;
+auto LoadDeferredLogFile(const std::filesystem::path& path) -> std::vector<std::byte>;
+
+void SetDeferredLog(DeferredLogWriter* writer) noexcept;
+auto GetDeferredLog() noexcept -> DeferredLogWriter*;
+
+// Deferred counterpart of LogMessage: records the format id and argument
+// bytes into the installed writer without formatting any text.
+template <typename... Args>
+auto LogMessageDeferred(FormatSpec<Args...> fmt, Args&&... args) -> void
+{
+	if (DeferredLogWriter* writer = GetDeferredLog())
+	{
+		writer->Write(fmt, std::forward<Args>(args)...);
+	}
+}
+
+} // namespace wmcv
+
+#endif // WMCV_DEFERRED_LOG_H_INCLUDED
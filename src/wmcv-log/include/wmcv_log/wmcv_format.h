@@ -1,9 +1,112 @@
 #ifndef WMCV_FORMAT_H_INCLUDED
 #define WMCV_FORMAT_H_INCLUDED
 
+#include <source_location>
+
 namespace wmcv
 {
 
+// Deliberately not constexpr: reaching it while evaluating a CompiledFormatString
+// turns a placeholder/argument count mismatch into a compile error.
+inline void format_argument_count_mismatch() {}
+
+// Format string split into literal segments around each "{}" at compile time.
+// Format strings are taken as CompiledFormatString<Args...> in a non-deduced
+// context so the argument count is checked against the call.
+template <typename... Args>
+class CompiledFormatString
+{
+public:
+	static constexpr size_t ArgCount = sizeof...(Args);
+
+	// location defaults to the call site that spelled the format string.
+	consteval CompiledFormatString(const char* str, std::source_location location = std::source_location::current())
+		: CompiledFormatString(std::string_view{str}, location)
+	{
+	}
+
+	consteval CompiledFormatString(std::string_view str, std::source_location location = std::source_location::current())
+		: m_view{str}
+		, m_location{location}
+	{
+		for (const char c : str)
+		{
+			m_hash = (m_hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ull;
+		}
+
+		size_t segment = 0;
+		size_t start = 0;
+		for (size_t i = 0; i + 1 < str.length(); ++i)
+		{
+			if (str[i] == '{' && str[i + 1] == '}')
+			{
+				if (segment == ArgCount)
+				{
+					format_argument_count_mismatch();
+				}
+
+				m_segments[segment++] = str.substr(start, i - start);
+				start = i + 2;
+				++i;
+			}
+		}
+
+		if (segment != ArgCount)
+		{
+			format_argument_count_mismatch();
+		}
+
+		m_segments[segment] = str.substr(start);
+	}
+
+	[[nodiscard]] constexpr auto segment(size_t index) const -> std::string_view { return m_segments[index]; }
+	[[nodiscard]] constexpr auto view() const -> std::string_view { return m_view; }
+	[[nodiscard]] constexpr auto hash() const -> uint64_t { return m_hash; }
+	[[nodiscard]] constexpr auto location() const -> const std::source_location& { return m_location; }
+
+private:
+	std::array<std::string_view, ArgCount + 1> m_segments = {};
+	std::string_view m_view;
+	std::source_location m_location;
+	uint64_t m_hash = 0xcbf29ce484222325ull;
+};
+
+template <typename... Args>
+using FormatSpec = CompiledFormatString<std::decay_t<Args>...>;
+
+// Opt-out for format strings that are only known at runtime; these are
+// scanned for placeholders on every call and ignore surplus arguments.
+struct RuntimeFormatString
+{
+	explicit RuntimeFormatString(std::string_view s, std::source_location loc = std::source_location::current())
+		: str(s)
+		, m_location(loc)
+	{
+	}
+
+	[[nodiscard]] auto location() const -> const std::source_location& { return m_location; }
+
+	std::string_view str;
+
+private:
+	std::source_location m_location;
+};
+
+inline auto runtime_format(std::string_view str, std::source_location location = std::source_location::current()) -> RuntimeFormatString
+{
+	return RuntimeFormatString{str, location};
+}
+
+// Anything with push(std::string_view) can be formatted into. format() and the
+// Formatter specializations are templates over the concrete stream, so a call
+// into a fixed buffer inlines down to plain copies.
+template <typename Stream>
+concept is_format_stream = requires(Stream& s, std::string_view str) {
+	s.push(str);
+};
+
+// Type-erased stream for code that cannot be a template: runtime format
+// strings and Formatter specializations written against IFormatStream&.
 class IFormatStream
 {
 public:
@@ -21,13 +124,37 @@ private:
 	auto parse_format_string(std::string_view& format) -> bool;
 
 	template <typename... Args>
-	friend void format(IFormatStream& input, std::string_view format, Args&&... args);
+	friend void format(IFormatStream& input, RuntimeFormatString format, Args&&... args);
+};
+
+// Wraps a concrete stream for the IFormatStream fallback paths.
+template <is_format_stream Stream>
+class FormatStreamAdapter final : public IFormatStream
+{
+public:
+	explicit FormatStreamAdapter(Stream& stream)
+		: m_stream{stream}
+	{
+	}
+
+	auto push(std::string_view str) -> IFormatStream& override
+	{
+		m_stream.push(str);
+		return *this;
+	}
+
+private:
+	Stream& m_stream;
 };
 
-class FormatString final : public IFormatStream
+class FormatString
 {
 public:
-	IFormatStream& push(std::string_view str);
+	auto push(std::string_view str) -> FormatString&
+	{
+		m_buffer += str;
+		return *this;
+	}
 
 	[[nodiscard]] auto begin() -> std::string::iterator { return m_buffer.begin(); }
 	[[nodiscard]] auto end() -> std::string::iterator { return m_buffer.end(); }
@@ -41,194 +168,220 @@ private:
 	std::string m_buffer;
 };
 
+// Fixed buffer of N characters; anything past N is dropped.
 template <size_t N>
-class InplaceFormatString : public IFormatStream
+class InplaceFormatString
 {
 public:
-	IFormatStream& push(std::string_view str)
+	auto push(std::string_view str) -> InplaceFormatString&
 	{
-		const size_t count = std::min(str.length(), N - m_offset);
-		std::copy_n(str.begin(), count, m_buffer.begin() + m_offset);
-		m_offset += count;
+		// The common case is kept apart so a literal's length reaches copy_n as
+		// a constant once format() is inlined.
+		if (str.length() <= N - m_offset)
+		{
+			std::copy_n(str.data(), str.length(), m_buffer.data() + m_offset);
+			m_offset += str.length();
+		}
+		else
+		{
+			push_truncated(str);
+		}
+		m_buffer[m_offset] = '\0';
 		return *this;
 	}
 
-	[[nodiscard]] auto begin() -> std::string::iterator { return m_buffer.begin(); }
-	[[nodiscard]] auto end() -> std::string::iterator { return m_buffer.end(); }
-	[[nodiscard]] auto cbegin() const -> std::string::const_iterator { return m_buffer.cbegin(); }
-	[[nodiscard]] auto cend() const -> std::string::const_iterator { return m_buffer.cend(); }
+	void clear()
+	{
+		m_offset = 0;
+		m_buffer[0] = '\0';
+	}
+
+	[[nodiscard]] auto begin() -> char* { return m_buffer.data(); }
+	[[nodiscard]] auto end() -> char* { return m_buffer.data() + m_offset; }
+	[[nodiscard]] auto cbegin() const -> const char* { return m_buffer.data(); }
+	[[nodiscard]] auto cend() const -> const char* { return m_buffer.data() + m_offset; }
 
 	[[nodiscard]] auto c_str() const -> const char* { return m_buffer.data(); }
-	[[nodiscard]] auto view() const -> std::string_view { return std::string_view{m_buffer, N}; }
+	[[nodiscard]] auto view() const -> std::string_view { return std::string_view{m_buffer.data(), m_offset}; }
 
 private:
-	std::array<char, N> m_buffer = {};
+	void push_truncated(std::string_view str)
+	{
+		const size_t count = N - m_offset;
+		str.copy(m_buffer.data() + m_offset, count);
+		m_offset += count;
+	}
+
+	std::array<char, N + 1> m_buffer = {};
 	size_t m_offset = 0llu;
 };
 
-template <typename... Args>
-void format(IFormatStream& input, std::string_view format, Args&&... args)
+// Formats into an inline buffer and only touches the heap once a message
+// outgrows it. clear() keeps any spilled capacity so a reused instance stops
+// allocating after its first long message.
+template <size_t N>
+class SmallFormatString
 {
-	input.unpack_format_args(format, std::forward<Args>(args)...);
-}
-
-template <typename StringType>
-concept has_c_str = requires(StringType t) {
-	t.c_str();
-};
+public:
+	SmallFormatString() { m_inline[0] = '\0'; }
 
-template <typename T, typename Enabled = void>
-struct Formatter
-{
-	static void format(IFormatStream& s, const T&)
+	auto push(std::string_view str) -> SmallFormatString&
 	{
-		s.push("<?>");
-	}
-};
+		if (!m_spilled && m_length + str.length() < N)
+		{
+			std::copy_n(str.begin(), str.length(), m_inline.begin() + m_length);
+			m_length += str.length();
+			m_inline[m_length] = '\0';
+			return *this;
+		}
 
-template <typename T>
-struct Formatter<T, typename std::enable_if_t<has_c_str<T>>>
-{
-	static void format(IFormatStream& s, const T& val)
-	{
-		s.push(val.c_str());
+		if (!m_spilled)
+		{
+			m_spill.assign(m_inline.data(), m_length);
+			m_spilled = true;
+		}
+
+		m_spill += str;
+		m_length = m_spill.length();
+		return *this;
 	}
-};
 
-template <>
-struct Formatter<bool>
-{
-	static void format(IFormatStream& s, bool val)
+	void clear()
 	{
-		s.push(val ? "true" : "false");
+		m_inline[0] = '\0';
+		m_length = 0;
+		m_spill.clear();
+		m_spilled = false;
 	}
+
+	[[nodiscard]] auto spilled() const -> bool { return m_spilled; }
+	[[nodiscard]] auto c_str() const -> const char* { return m_spilled ? m_spill.c_str() : m_inline.data(); }
+	[[nodiscard]] auto view() const -> std::string_view { return std::string_view{c_str(), m_length}; }
+
+private:
+	std::array<char, N> m_inline;
+	std::string m_spill;
+	size_t m_length = 0;
+	bool m_spilled = false;
 };
 
-template <>
-struct Formatter<int8_t>
+template <typename... Args>
+void format(IFormatStream& input, RuntimeFormatString format, Args&&... args)
 {
-	static void format(IFormatStream& f, int8_t val)
-	{
-		std::array<char, 5> buffer = {};
-		snprintf(buffer.data(), buffer.size(), "%" PRId8, val);
-		f.push(buffer.data());
-	}
-};
+	input.unpack_format_args(format.str, std::forward<Args>(args)...);
+}
 
-template <>
-struct Formatter<char>
+template <is_format_stream Stream, typename... Args>
+	requires(!std::is_base_of_v<IFormatStream, Stream>)
+void format(Stream& output, RuntimeFormatString format, Args&&... args)
 {
-	static void format(IFormatStream& f, char val)
-	{
-		std::array<char, 64> buffer = {};
-		snprintf(buffer.data(), buffer.size(), "%c", val);
-		f.push(buffer.data());
-	}
+	FormatStreamAdapter<Stream> adapter{output};
+	wmcv::format(static_cast<IFormatStream&>(adapter), format, std::forward<Args>(args)...);
+}
+
+template <typename StringType>
+concept has_c_str = requires(StringType t) {
+	t.c_str();
 };
 
-template <>
-struct Formatter<int16_t>
+template <typename T>
+concept is_integer_argument = std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>;
+
+// Runs a std::to_chars kernel into a stack buffer and pushes the result with
+// its known length. Buffer fits the shortest round-trip form of a double.
+template <typename Stream, typename T, typename... Options>
+void push_to_chars(Stream& s, T val, Options... options)
 {
-	static void format(IFormatStream& f, int16_t val)
-	{
-		std::array<char, 64> buffer = {};
-		snprintf(buffer.data(), buffer.size(), "%" PRId16, val);
-		f.push(buffer.data());
-	}
-};
+	std::array<char, 32> buffer;
+	const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), val, options...);
+	s.push(std::string_view{buffer.data(), static_cast<size_t>(result.ptr - buffer.data())});
+}
 
-template <>
-struct Formatter<int32_t>
+template <typename T, typename Enabled = void>
+struct Formatter
 {
-	static void format(IFormatStream& f, int32_t val)
+	template <typename Stream>
+	static void format(Stream& s, const T&)
 	{
-		std::array<char, 64> buffer = {};
-		snprintf(buffer.data(), buffer.size(), "%" PRId32, val);
-		f.push(buffer.data());
+		s.push("<?>");
 	}
 };
 
-template <>
-struct Formatter<int64_t>
+template <typename T>
+struct Formatter<T, typename std::enable_if_t<has_c_str<T>>>
 {
-	static void format(IFormatStream& f, int64_t val)
+	template <typename Stream>
+	static void format(Stream& s, const T& val)
 	{
-		std::array<char, 64> buffer = {};
-		snprintf(buffer.data(), buffer.size(), "%" PRIi64, val);
-		f.push(buffer.data());
+		s.push(val.c_str());
 	}
 };
 
-template <>
-struct Formatter<uint8_t>
+template <typename T>
+struct Formatter<T, typename std::enable_if_t<is_integer_argument<T>>>
 {
-	static void format(IFormatStream& f, uint8_t val)
+	template <typename Stream>
+	static void format(Stream& s, T val)
 	{
-		std::array<char, 64> buffer = {};
-		snprintf(buffer.data(), buffer.size(), "%" PRIu8 , val);
-		f.push(buffer.data());
+		push_to_chars(s, val);
 	}
 };
 
 template <>
-struct Formatter<uint16_t>
+struct Formatter<std::string>
 {
-	static void format(IFormatStream& f, uint16_t val)
+	template <typename Stream>
+	static void format(Stream& s, const std::string& val)
 	{
-		std::array<char, 64> buffer = {};
-		snprintf(buffer.data(), buffer.size(), "%" PRIu16, val);
-		f.push(buffer.data());
+		s.push(val);
 	}
 };
 
 template <>
-struct Formatter<uint32_t>
+struct Formatter<bool>
 {
-	static void format(IFormatStream& f, uint32_t val)
+	template <typename Stream>
+	static void format(Stream& s, bool val)
 	{
-		std::array<char, 64> buffer = {};
-		snprintf(buffer.data(), buffer.size(), "%" PRIu32, val);
-		f.push(buffer.data());
+		s.push(val ? "true" : "false");
 	}
 };
 
 template <>
-struct Formatter<uint64_t>
+struct Formatter<char>
 {
-	static void format(IFormatStream& f, uint64_t val)
+	template <typename Stream>
+	static void format(Stream& f, char val)
 	{
-		std::array<char, 64> buffer = {};
-		snprintf(buffer.data(), buffer.size(), "%" PRIu64, val);
-		f.push(buffer.data());
+		f.push(std::string_view{&val, 1});
 	}
 };
 
 template <>
 struct Formatter<float>
 {
-	static void format(IFormatStream& f, float val)
+	template <typename Stream>
+	static void format(Stream& f, float val)
 	{
-		std::array<char, 64> buffer = {};
-		snprintf(buffer.data(), buffer.size(), "%f", static_cast<double>(val));
-		f.push(buffer.data());
+		push_to_chars(f, val);
 	}
 };
 
 template <>
 struct Formatter<double>
 {
-	static void format(IFormatStream& f, double val)
+	template <typename Stream>
+	static void format(Stream& f, double val)
 	{
-		std::array<char, 64> buffer = {};
-		snprintf(buffer.data(), buffer.size(), "%f", val);
-		f.push(buffer.data());
+		push_to_chars(f, val);
 	}
 };
 
 template <>
 struct Formatter<const char*>
 {
-	static void format(IFormatStream& f, const char* val)
+	template <typename Stream>
+	static void format(Stream& f, const char* val)
 	{
 		f.push(val);
 	}
@@ -237,7 +390,8 @@ struct Formatter<const char*>
 template <>
 struct Formatter<char*>
 {
-	static void format(IFormatStream& f, const char* val)
+	template <typename Stream>
+	static void format(Stream& f, const char* val)
 	{
 		f.push(val);
 	}
@@ -246,28 +400,28 @@ struct Formatter<char*>
 template <>
 struct Formatter<std::string_view>
 {
-	static void format(IFormatStream& f, std::string_view val)
+	template <typename Stream>
+	static void format(Stream& f, std::string_view val)
 	{
-		f.push(val.data());
+		f.push(val);
 	}
 };
-;
 
 template <>
 struct Formatter<std::nullptr_t>
 {
-	static void format(IFormatStream& f, std::nullptr_t)
+	template <typename Stream>
+	static void format(Stream& f, std::nullptr_t)
 	{
-		std::array<char, 64> buffer = {};
-		snprintf(buffer.data(), buffer.size(), "0x0000000000000000");
-		f.push(buffer.data());
+		f.push("0x0000000000000000");
 	}
 };
 
 template <typename T>
 struct Formatter<T*>
 {
-	static void format(IFormatStream& f, T* ptr)
+	template <typename Stream>
+	static void format(Stream& f, T* ptr)
 	{
 		if (!ptr)
 		{
@@ -275,20 +429,36 @@ struct Formatter<T*>
 		}
 		else
 		{
-			std::array<char, 64> buffer = {};
-			snprintf(buffer.data(), buffer.size(), "%#" PRIxPTR, reinterpret_cast<uint64_t>(ptr));
-			f.push(buffer.data());
+			std::array<char, 2 + 2 * sizeof(uintptr_t)> buffer = {'0', 'x'};
+			const auto result = std::to_chars(buffer.data() + 2, buffer.data() + buffer.size(), reinterpret_cast<uintptr_t>(ptr), 16);
+			f.push(std::string_view{buffer.data(), static_cast<size_t>(result.ptr - buffer.data())});
 		}
 	}
 };
 
-
 template <typename Arg>
 void IFormatStream::apply_formatting(Arg&& arg)
 {
 	Formatter<typename std::decay_t<Arg>>::format(*this, std::forward<Arg>(arg));
 }
 
+// Calls the Formatter with the concrete stream when it accepts one, otherwise
+// through FormatStreamAdapter for specializations that take IFormatStream&.
+template <typename Stream, typename Arg>
+void format_argument(Stream& output, Arg&& arg)
+{
+	using ArgFormatter = Formatter<std::decay_t<Arg>>;
+	if constexpr (requires { ArgFormatter::format(output, std::forward<Arg>(arg)); })
+	{
+		ArgFormatter::format(output, std::forward<Arg>(arg));
+	}
+	else
+	{
+		FormatStreamAdapter<Stream> adapter{output};
+		ArgFormatter::format(static_cast<IFormatStream&>(adapter), std::forward<Arg>(arg));
+	}
+}
+
 template <typename Arg, typename... Args>
 void IFormatStream::unpack_format_args(std::string_view& format, Arg&& arg, Args&&... args)
 {
@@ -300,6 +470,24 @@ void IFormatStream::unpack_format_args(std::string_view& format, Arg&& arg, Args
 	}
 }
 
+template <is_format_stream Stream, typename... Args>
+void format(Stream& output, FormatSpec<Args...> format, Args&&... args)
+{
+	const auto push_segment = [&output](std::string_view segment)
+	{
+		if (!segment.empty())
+		{
+			output.push(segment);
+		}
+	};
+
+	push_segment(format.segment(0));
+	[&]<size_t... I>(std::index_sequence<I...>)
+	{
+		((format_argument(output, std::forward<Args>(args)), push_segment(format.segment(I + 1))), ...);
+	}(std::index_sequence_for<Args...>{});
+}
+
 } // namespace wmcv
 
 #endif // WMCV_FORMAT_H_INCLUDED
\ No newline at end of file
@@ -4,16 +4,206 @@
 #include "wmcv_log_sink.h"
 #include "wmcv_log_system.h"
 #include "wmcv_format.h"
+#include "wmcv_log_callsite.h"
 
 namespace wmcv
 {
-    template< typename... Args >
-    auto LogMessage( std::string_view fmt, Args&&... args ) -> void
-    {
-		FormatString fmt_str;
-		format(fmt_str, fmt, std::forward<Args>(args)...);
-		GetLogSystem().LogMessage(fmt_str.c_str());
-    }
+	constexpr size_t LogMessageInlineCapacity = 512;
+	using LogMessageBuffer = SmallFormatString<LogMessageInlineCapacity>;
+
+	struct ThreadLogBuffer
+	{
+		LogMessageBuffer buffer;
+		bool inUse = false;
+	};
+
+	inline auto GetThreadLogBuffer() -> ThreadLogBuffer&
+	{
+		thread_local ThreadLogBuffer threadBuffer;
+		return threadBuffer;
+	}
+
+	template< typename FormatStr, typename... Args >
+	auto FormatLogMessage( LogMessageBuffer& buffer, uint64_t suppressed, const FormatStr& fmt, Args&&... args ) -> void
+	{
+		format(buffer, fmt, std::forward<Args>(args)...);
+		if (suppressed > 0)
+		{
+			format(buffer, " ({} similar messages suppressed)", suppressed);
+		}
+	}
+
+	// The header is taken before formatting so the timestamp marks the call,
+	// not the end of formatting.
+	template< typename FormatStr, typename... Args >
+	auto LogFormattedMessageSuppressed( const LogCategory* category, LogLevel level, uint64_t suppressed, const FormatStr& fmt, Args&&... args ) -> void
+	{
+		const LogRecordHeader header = CaptureLogRecordHeader(level, fmt.location(), category);
+		ThreadLogBuffer& threadBuffer = GetThreadLogBuffer();
+
+		// A sink or formatter that logs re-enters here while the thread buffer
+		// is still being delivered, so nested calls format on the stack.
+		if (threadBuffer.inUse)
+		{
+			LogMessageBuffer fmt_str;
+			FormatLogMessage(fmt_str, suppressed, fmt, std::forward<Args>(args)...);
+			GetLogSystem().LogMessage(header, fmt_str.view());
+			return;
+		}
+
+		struct InUseScope
+		{
+			explicit InUseScope(bool& flag) : m_flag(flag) { m_flag = true; }
+			~InUseScope() { m_flag = false; }
+			InUseScope(const InUseScope&) = delete;
+			InUseScope& operator=(const InUseScope&) = delete;
+			bool& m_flag;
+		} scope{threadBuffer.inUse};
+
+		threadBuffer.buffer.clear();
+		FormatLogMessage(threadBuffer.buffer, suppressed, fmt, std::forward<Args>(args)...);
+		GetLogSystem().LogMessage(header, threadBuffer.buffer.view());
+	}
+
+	template< typename FormatStr, typename... Args >
+	auto LogFormattedMessage( const LogCategory* category, LogLevel level, const FormatStr& fmt, Args&&... args ) -> void
+	{
+		LogFormattedMessageSuppressed(category, level, 0, fmt, std::forward<Args>(args)...);
+	}
+
+	template< typename... Args >
+	auto LogMessage( FormatSpec<Args...> fmt, Args&&... args ) -> void
+	{
+		LogFormattedMessage(nullptr, LogLevel::Info, fmt, std::forward<Args>(args)...);
+	}
+
+	template< typename... Args >
+	auto LogMessage( RuntimeFormatString fmt, Args&&... args ) -> void
+	{
+		LogFormattedMessage(nullptr, LogLevel::Info, fmt, std::forward<Args>(args)...);
+	}
+
+	// Calls below WMCV_LOG_MIN_LEVEL are discarded at compile time; the rest are
+	// filtered on the category threshold before anything is formatted.
+	template< LogLevel Level, typename... Args >
+	auto Log( const LogCategory& category, FormatSpec<Args...> fmt, Args&&... args ) -> void
+	{
+		if constexpr (IsLogLevelCompiledIn(Level))
+		{
+			if (category.IsEnabled(Level))
+			{
+				LogFormattedMessage(&category, Level, fmt, std::forward<Args>(args)...);
+			}
+		}
+	}
+
+	template< typename... Args >
+	auto LogTrace( const LogCategory& category, FormatSpec<Args...> fmt, Args&&... args ) -> void
+	{
+		Log<LogLevel::Trace>(category, fmt, std::forward<Args>(args)...);
+	}
+
+	template< typename... Args >
+	auto LogDebug( const LogCategory& category, FormatSpec<Args...> fmt, Args&&... args ) -> void
+	{
+		Log<LogLevel::Debug>(category, fmt, std::forward<Args>(args)...);
+	}
+
+	template< typename... Args >
+	auto LogInfo( const LogCategory& category, FormatSpec<Args...> fmt, Args&&... args ) -> void
+	{
+		Log<LogLevel::Info>(category, fmt, std::forward<Args>(args)...);
+	}
+
+	template< typename... Args >
+	auto LogWarning( const LogCategory& category, FormatSpec<Args...> fmt, Args&&... args ) -> void
+	{
+		Log<LogLevel::Warning>(category, fmt, std::forward<Args>(args)...);
+	}
+
+	template< typename... Args >
+	auto LogError( const LogCategory& category, FormatSpec<Args...> fmt, Args&&... args ) -> void
+	{
+		Log<LogLevel::Error>(category, fmt, std::forward<Args>(args)...);
+	}
+
+	template< typename... Args >
+	auto LogFatal( const LogCategory& category, FormatSpec<Args...> fmt, Args&&... args ) -> void
+	{
+		Log<LogLevel::Fatal>(category, fmt, std::forward<Args>(args)...);
+	}
+
+	// Callsite-limited variants. Calls are filtered on the category first,
+	// then the decision is made on the callsite's state before anything is
+	// formatted; the next message that gets through reports how many were
+	// suppressed in between. The WMCV_LOG_EVERY_N, WMCV_LOG_ONCE and
+	// WMCV_LOG_AT_MOST_EVERY macros supply a callsite per statement.
+	template< LogLevel Level, typename... Args >
+	auto LogEveryN( LogCallsite& callsite, const LogCategory& category, uint64_t n, FormatSpec<Args...> fmt, Args&&... args ) -> void
+	{
+		if constexpr (IsLogLevelCompiledIn(Level))
+		{
+			if (!category.IsEnabled(Level))
+			{
+				return;
+			}
+
+			if (n > 1 && callsite.calls.fetch_add(1, std::memory_order_relaxed) % n != 0)
+			{
+				callsite.suppressed.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			LogFormattedMessageSuppressed(&category, Level, callsite.suppressed.exchange(0, std::memory_order_relaxed), fmt, std::forward<Args>(args)...);
+		}
+	}
+
+	template< LogLevel Level, typename... Args >
+	auto LogOnce( LogCallsite& callsite, const LogCategory& category, FormatSpec<Args...> fmt, Args&&... args ) -> void
+	{
+		if constexpr (IsLogLevelCompiledIn(Level))
+		{
+			if (!category.IsEnabled(Level) || callsite.calls.exchange(1, std::memory_order_relaxed) != 0)
+			{
+				return;
+			}
+
+			LogFormattedMessage(&category, Level, fmt, std::forward<Args>(args)...);
+		}
+	}
+
+	template< LogLevel Level, typename... Args >
+	auto LogAtMostEvery( LogCallsite& callsite, const LogCategory& category, std::chrono::nanoseconds interval, FormatSpec<Args...> fmt, Args&&... args ) -> void
+	{
+		if constexpr (IsLogLevelCompiledIn(Level))
+		{
+			if (!category.IsEnabled(Level))
+			{
+				return;
+			}
+
+			// Zero means never logged; steady_clock never reads zero in practice.
+			const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			int64_t last = callsite.lastLoggedNs.load(std::memory_order_relaxed);
+			if ((last != 0 && now - last < interval.count()) || !callsite.lastLoggedNs.compare_exchange_strong(last, now, std::memory_order_relaxed))
+			{
+				callsite.suppressed.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			LogFormattedMessageSuppressed(&category, Level, callsite.suppressed.exchange(0, std::memory_order_relaxed), fmt, std::forward<Args>(args)...);
+		}
+	}
 }
 
+// level is a wmcv::LogLevel, e.g. WMCV_LOG_EVERY_N(wmcv::LogLevel::Debug, s_renderLog, 60, "frame {}", frame).
+#define WMCV_LOG_EVERY_N(level, category, n, ...) \
+	do { static ::wmcv::LogCallsite wmcvLogCallsite; ::wmcv::LogEveryN<level>(wmcvLogCallsite, category, n, __VA_ARGS__); } while (false)
+
+#define WMCV_LOG_ONCE(level, category, ...) \
+	do { static ::wmcv::LogCallsite wmcvLogCallsite; ::wmcv::LogOnce<level>(wmcvLogCallsite, category, __VA_ARGS__); } while (false)
+
+#define WMCV_LOG_AT_MOST_EVERY(level, category, interval, ...) \
+	do { static ::wmcv::LogCallsite wmcvLogCallsite; ::wmcv::LogAtMostEvery<level>(wmcvLogCallsite, category, interval, __VA_ARGS__); } while (false)
+
 #endif
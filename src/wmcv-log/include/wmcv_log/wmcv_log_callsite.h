@@ -0,0 +1,19 @@
+#ifndef WMCV_LOG_CALLSITE_H_INCLUDED
+#define WMCV_LOG_CALLSITE_H_INCLUDED
+
+namespace wmcv
+{
+
+// Rate-limiting state for one log statement. The WMCV_LOG_* macros declare
+// one as a function-local static at each call, so statements never share
+// state; it is constant-initialized and needs no guard.
+struct LogCallsite
+{
+	std::atomic<uint64_t> calls = 0;
+	std::atomic<int64_t> lastLoggedNs = 0;
+	std::atomic<uint64_t> suppressed = 0;
+};
+
+} // namespace wmcv
+
+#endif // WMCV_LOG_CALLSITE_H_INCLUDED
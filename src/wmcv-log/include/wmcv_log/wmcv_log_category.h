@@ -0,0 +1,69 @@
+#ifndef WMCV_LOG_CATEGORY_H_INCLUDED
+#define WMCV_LOG_CATEGORY_H_INCLUDED
+
+// Levels below WMCV_LOG_MIN_LEVEL compile to nothing. Set it from the build,
+// e.g. -DWMCV_LOG_MIN_LEVEL=2 keeps Info and above.
+#ifndef WMCV_LOG_MIN_LEVEL
+#define WMCV_LOG_MIN_LEVEL 0
+#endif
+
+namespace wmcv
+{
+
+enum class LogLevel : uint8_t
+{
+	Trace,
+	Debug,
+	Info,
+	Warning,
+	Error,
+	Fatal,
+	Off
+};
+
+constexpr LogLevel CompiledMinLogLevel = static_cast<LogLevel>(WMCV_LOG_MIN_LEVEL);
+
+constexpr auto IsLogLevelCompiledIn(LogLevel level) -> bool
+{
+	return level >= CompiledMinLogLevel && level < LogLevel::Off;
+}
+
+auto ToString(LogLevel level) -> std::string_view;
+
+// A named channel with its own runtime threshold. Categories register
+// themselves on construction so thresholds can be changed by name; they are
+// meant to have static storage duration.
+class LogCategory
+{
+public:
+	explicit LogCategory(std::string_view name, LogLevel threshold = LogLevel::Info);
+	~LogCategory();
+
+	LogCategory(const LogCategory&) = delete;
+	LogCategory& operator=(const LogCategory&) = delete;
+	LogCategory(LogCategory&&) = delete;
+	LogCategory& operator=(LogCategory&&) = delete;
+
+	[[nodiscard]] auto IsEnabled(LogLevel level) const noexcept -> bool { return level >= m_threshold.load(std::memory_order_relaxed); }
+	[[nodiscard]] auto Threshold() const noexcept -> LogLevel { return m_threshold.load(std::memory_order_relaxed); }
+	[[nodiscard]] auto Name() const noexcept -> std::string_view { return m_name; }
+
+	void SetThreshold(LogLevel level) noexcept { m_threshold.store(level, std::memory_order_relaxed); }
+
+private:
+	friend struct LogCategoryRegistry;
+
+	std::string_view m_name;
+	std::atomic<LogLevel> m_threshold;
+	LogCategory* m_next = nullptr;
+};
+
+auto GetDefaultLogCategory() noexcept -> LogCategory&;
+
+// Returns false when no category with that name is registered.
+auto SetLogCategoryThreshold(std::string_view name, LogLevel level) -> bool;
+void SetAllLogCategoryThresholds(LogLevel level);
+
+} // namespace wmcv
+
+#endif // WMCV_LOG_CATEGORY_H_INCLUDED
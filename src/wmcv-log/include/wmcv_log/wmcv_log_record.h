@@ -0,0 +1,100 @@
+#ifndef WMCV_LOG_RECORD_H_INCLUDED
+#define WMCV_LOG_RECORD_H_INCLUDED
+
+#include "wmcv_log_category.h"
+#include "wmcv_format.h"
+
+#include <source_location>
+
+namespace wmcv
+{
+
+using LogClock = std::chrono::steady_clock;
+
+// Captured at the call site before anything is formatted: one clock read, a
+// thread_local load and a copy of the source_location. Sinks that want a
+// prefix render it with FormatLogRecordHeader when they write; the rest
+// ignore it. category is null for messages logged without one.
+struct LogRecordHeader
+{
+	int64_t timestampNs = 0;
+	uint32_t threadId = 0;
+	LogLevel level = LogLevel::Info;
+	const LogCategory* category = nullptr;
+	std::source_location location;
+};
+
+struct LogRecord
+{
+	std::string_view message;
+	LogRecordHeader header = {};
+};
+
+auto AllocateLogThreadId() noexcept -> uint32_t;
+
+// LogClock reading taken the first time it is asked for, at the latest when
+// a log system is installed; rendered timestamps are relative to it.
+auto GetLogClockOrigin() noexcept -> int64_t;
+
+// Small sequential id, assigned the first time a thread logs. Unlike
+// std::thread::id it fits the header and reads the same in every sink.
+inline auto GetLogThreadId() noexcept -> uint32_t
+{
+	thread_local const uint32_t threadId = AllocateLogThreadId();
+	return threadId;
+}
+
+inline auto GetLogTimestampNs() noexcept -> int64_t
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(LogClock::now().time_since_epoch()).count();
+}
+
+inline auto CaptureLogRecordHeader(LogLevel level, const std::source_location& location, const LogCategory* category = nullptr) noexcept -> LogRecordHeader
+{
+	return LogRecordHeader{GetLogTimestampNs(), GetLogThreadId(), level, category, location};
+}
+
+template <typename Stream>
+void push_zero_padded(Stream& output, uint32_t value, size_t width)
+{
+	std::array<char, 10> digits;
+	const auto result = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+	const auto length = static_cast<size_t>(result.ptr - digits.data());
+	for (size_t i = length; i < width; ++i)
+	{
+		output.push("0");
+	}
+	output.push(std::string_view{digits.data(), length});
+}
+
+// Renders "[12.000345] [T3] [warning] [Shader] shader.cpp:42 ", seconds since
+// GetLogClockOrigin() with microsecond precision and the file name without
+// its directory. The category is left out when there is none.
+template <typename Stream>
+void FormatLogRecordHeader(Stream& output, const LogRecordHeader& header)
+{
+	const int64_t elapsedUs = std::max<int64_t>(header.timestampNs - GetLogClockOrigin(), 0) / 1000;
+
+	std::string_view file = header.location.file_name();
+	if (const size_t slash = file.find_last_of("/\\"); slash != std::string_view::npos)
+	{
+		file.remove_prefix(slash + 1);
+	}
+
+	format(output, "[{}.", elapsedUs / 1000000);
+	push_zero_padded(output, static_cast<uint32_t>(elapsedUs % 1000000), 6);
+	format(output, "] [T{}] [{}] ", header.threadId, ToString(header.level));
+	if (header.category)
+	{
+		format(output, "[{}] ", header.category->Name());
+	}
+	format(output, "{}:{} ", file, header.location.line());
+}
+
+// Stack buffer file sinks render a header into; a file name long enough to
+// overflow it is cut short.
+using LogRecordHeaderText = InplaceFormatString<160>;
+
+} // namespace wmcv
+
+#endif // WMCV_LOG_RECORD_H_INCLUDED
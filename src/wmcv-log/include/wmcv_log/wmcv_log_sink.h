@@ -1,6 +1,8 @@
 #ifndef WMCV_LOG_SINK_H_INCLUDED
 #define WMCV_LOG_SINK_H_INCLUDED
 
+#include "wmcv_log_record.h"
+
 namespace wmcv
 {
 
@@ -9,12 +11,28 @@ concept IsLogSink = requires(Sink sink, const std::string_view message) {
 	Log(sink, message);
 };
 
+// Sinks that can amortize work (one write, one compression block) across
+// many records take a whole batch at once. Records carry their header, so a
+// sink that has both overloads is always given records.
+template <typename Sink>
+concept IsBatchedLogSink = requires(Sink sink, std::span<const LogRecord> records) {
+	Log(sink, records);
+};
+
+// Sinks are called from every logging thread at once. A sink whose state is
+// not synchronized sets SerializeLogCalls and is then called from one thread
+// at a time.
+template <typename Sink>
+concept IsSerializedLogSink = requires { requires Sink::SerializeLogCalls; };
+
 class LogSink
 {
 public:
-	template <IsLogSink T>
+	template <typename T>
+		requires IsLogSink<T> || IsBatchedLogSink<T>
 	LogSink(T&& t)
 		: self{std::make_unique<model_t<T>>(std::move(t))}
+		, serialized{IsSerializedLogSink<std::remove_cvref_t<T>>}
 	{
 	}
 
@@ -24,13 +42,19 @@ public:
 	LogSink(const LogSink&) = delete;
 	LogSink operator=(const LogSink&) = delete;
 
-	friend auto Log(LogSink& logger, const std::string_view msg) -> void { logger.self->Log_(msg); }
+	friend auto Log(LogSink& logger, const std::string_view msg) -> void { logger.self->LogMessage_(msg); }
+	friend auto Log(LogSink& logger, const LogRecord& record) -> void { logger.self->Log_(record); }
+	friend auto Log(LogSink& logger, std::span<const LogRecord> records) -> void { logger.self->LogBatch_(records); }
+
+	[[nodiscard]] auto Serialized() const -> bool { return serialized; }
 
 private:
 	struct concept_t
 	{
 		virtual ~concept_t() = default;
-		virtual auto Log_(const std::string_view msg) -> void = 0;
+		virtual auto LogMessage_(std::string_view message) -> void = 0;
+		virtual auto Log_(const LogRecord& record) -> void = 0;
+		virtual auto LogBatch_(std::span<const LogRecord> records) -> void = 0;
 
 		concept_t& operator=(concept_t&&) = default;
 		concept_t(concept_t&&) = default;
@@ -45,12 +69,50 @@ private:
 	struct model_t final : concept_t
 	{
 		model_t(T&& data) : m_data(std::move(data)) {}
-		auto Log_(const std::string_view msg) -> void { Log(m_data, msg); }
+		auto LogMessage_(std::string_view message) -> void
+		{
+			if constexpr (IsLogSink<T>)
+			{
+				Log(m_data, message);
+			}
+			else
+			{
+				Log_(LogRecord{message});
+			}
+		}
+
+		auto Log_(const LogRecord& record) -> void
+		{
+			if constexpr (IsBatchedLogSink<T>)
+			{
+				Log(m_data, std::span<const LogRecord>{&record, 1});
+			}
+			else
+			{
+				Log(m_data, record.message);
+			}
+		}
+
+		auto LogBatch_(std::span<const LogRecord> records) -> void
+		{
+			if constexpr (IsBatchedLogSink<T>)
+			{
+				Log(m_data, records);
+			}
+			else
+			{
+				for (const LogRecord& record : records)
+				{
+					Log(m_data, record.message);
+				}
+			}
+		}
 
 		T m_data;
 	};
 
 	std::unique_ptr<concept_t> self;
+	bool serialized = false;
 };
 
 }
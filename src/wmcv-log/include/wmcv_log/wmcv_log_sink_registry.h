@@ -0,0 +1,119 @@
+#ifndef WMCV_LOG_SINK_REGISTRY_H_INCLUDED
+#define WMCV_LOG_SINK_REGISTRY_H_INCLUDED
+
+#include "wmcv_log_sink.h"
+
+namespace wmcv
+{
+
+struct LogSinkHandle
+{
+	uint64_t id = 0;
+
+	friend constexpr auto operator==(LogSinkHandle, LogSinkHandle) -> bool = default;
+};
+
+// Copy-on-write list of sinks. Readers never lock the list: they mark
+// themselves in the current epoch's reader count and walk an immutable
+// snapshot. Writers serialize on a mutex, publish a new snapshot and free the
+// old one only after both epoch parities have drained, so no reader can still
+// be walking it.
+//
+// Sinks are called concurrently and must be thread-safe, except those that
+// set SerializeLogCalls (see IsSerializedLogSink), which are called under a
+// mutex of their own. Anything logged from inside a serialized sink skips the
+// serialized sinks rather than waiting on a mutex its own thread, or a thread
+// waiting on it, already holds.
+//
+// A sink must not add or remove sinks from inside Log(); the writer would wait
+// for its own read to finish.
+class LogSinkRegistry
+{
+public:
+	LogSinkRegistry() = default;
+	~LogSinkRegistry();
+
+	LogSinkRegistry(const LogSinkRegistry&) = delete;
+	LogSinkRegistry& operator=(const LogSinkRegistry&) = delete;
+	LogSinkRegistry(LogSinkRegistry&&) = delete;
+	LogSinkRegistry& operator=(LogSinkRegistry&&) = delete;
+
+	auto Add(LogSink&& sink) -> LogSinkHandle;
+	auto Remove(LogSinkHandle handle) -> bool;
+	void Clear();
+
+	template <typename Fn>
+	void ForEach(Fn&& fn);
+
+private:
+	struct Slot
+	{
+		explicit Slot(LogSink&& s) : sink(std::move(s)) {}
+
+		std::mutex mutex;
+		LogSink sink;
+	};
+
+	struct Entry
+	{
+		LogSinkHandle handle;
+		std::shared_ptr<Slot> slot;
+	};
+
+	struct Snapshot
+	{
+		std::vector<Entry> entries;
+	};
+
+	void Publish(std::unique_ptr<Snapshot> next);
+	void WaitForReaders(uint32_t parity);
+
+	std::atomic<Snapshot*> m_current = nullptr;
+	std::atomic<uint32_t> m_epoch = 0;
+	std::array<std::atomic<uint32_t>, 2> m_readers = {};
+
+	std::mutex m_writerMutex;
+	uint64_t m_nextId = 1;
+
+	static inline thread_local bool t_inSerializedSink = false;
+};
+
+template <typename Fn>
+void LogSinkRegistry::ForEach(Fn&& fn)
+{
+	const uint32_t parity = m_epoch.load(std::memory_order_seq_cst) & 1;
+	m_readers[parity].fetch_add(1, std::memory_order_seq_cst);
+
+	struct ReadScope
+	{
+		~ReadScope() { readers.fetch_sub(1, std::memory_order_release); }
+		std::atomic<uint32_t>& readers;
+	} scope{m_readers[parity]};
+
+	struct SerializedScope
+	{
+		explicit SerializedScope(std::mutex& mutex) : lock{mutex} { t_inSerializedSink = true; }
+		~SerializedScope() { t_inSerializedSink = false; }
+		std::scoped_lock<std::mutex> lock;
+	};
+
+	if (const Snapshot* snapshot = m_current.load(std::memory_order_seq_cst))
+	{
+		for (const Entry& entry : snapshot->entries)
+		{
+			if (!entry.slot->sink.Serialized())
+			{
+				fn(entry.slot->sink);
+			}
+			else if (!t_inSerializedSink)
+			{
+				const SerializedScope serialized{entry.slot->mutex};
+				fn(entry.slot->sink);
+			}
+		}
+	}
+}
+
+} // namespace wmcv
+
+#endif // WMCV_LOG_SINK_REGISTRY_H_INCLUDED
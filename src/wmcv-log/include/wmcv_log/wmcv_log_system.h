@@ -1,15 +1,27 @@
 #ifndef WMCV_LOG_SYSTEM_H_INCLUDED
 #define WMCV_LOG_SYSTEM_H_INCLUDED
 
+#include "wmcv_log_category.h"
+#include "wmcv_log_sink_registry.h"
+#include "wmcv_log_record.h"
+
 namespace wmcv
 {
-class LogSink;
-
 struct LogSystem
 {
 	virtual ~LogSystem() = default;
-	virtual void PushSink(LogSink&& sink) = 0;
-	virtual void LogMessage(const std::string_view text) = 0;
+	// Safe to call while other threads are logging.
+	virtual auto PushSink(LogSink&& sink) -> LogSinkHandle = 0;
+	virtual auto RemoveSink(LogSinkHandle handle) -> bool = 0;
+	virtual void LogMessage(const LogRecordHeader& header, const std::string_view text) = 0;
+	// Plain text, recorded as Info from the caller's location.
+	void LogMessage(const std::string_view text, const std::source_location& location = std::source_location::current());
+	virtual void Flush() = 0;
+
+	// Thresholds are read before any formatting, so changes take effect on the
+	// next call from every thread.
+	auto SetCategoryThreshold(std::string_view category, LogLevel level) -> bool;
+	void SetThreshold(LogLevel level);
 
 	LogSystem& operator=(const LogSystem&) = delete;
 	LogSystem(const LogSystem&) = delete;
@@ -20,7 +32,19 @@ protected:
 	LogSystem() = default;
 };
 
-void CreateDefaultLogSystem() noexcept;
+// Records are held back until maxRecords are pending or the oldest one is
+// maxDelay old, then handed to each sink as one span. A background thread
+// delivers batches that reach maxDelay with nothing else arriving; Flush()
+// delivers whatever is pending. Records a sink logs while receiving a batch
+// join the next one.
+struct LogBatchPolicy
+{
+	size_t maxRecords = 1;
+	std::chrono::milliseconds maxDelay{100};
+};
+
+// Resets the shared default system: sinks are dropped and the policy applied.
+void CreateDefaultLogSystem(const LogBatchPolicy& policy = {}) noexcept;
 void SetLogSystem(LogSystem* system) noexcept;
 auto GetLogSystem() noexcept -> LogSystem&;
 
@@ -0,0 +1,112 @@
+#ifndef WMCV_RING_BUFFER_H_INCLUDED
+#define WMCV_RING_BUFFER_H_INCLUDED
+
+namespace wmcv
+{
+
+// Bounded lock-free queue (Vyukov). Any number of producers may push; pops are
+// normally done by a single consumer but are safe from any thread, which lets
+// producers evict the oldest entry when the buffer is full.
+template <typename T>
+class BoundedRingBuffer
+{
+public:
+	explicit BoundedRingBuffer(size_t capacity)
+		: m_cells{std::make_unique<Cell[]>(std::bit_ceil(std::max<size_t>(capacity, 2)))}
+		, m_mask{std::bit_ceil(std::max<size_t>(capacity, 2)) - 1}
+	{
+		for (size_t i = 0; i <= m_mask; ++i)
+		{
+			m_cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	BoundedRingBuffer(const BoundedRingBuffer&) = delete;
+	BoundedRingBuffer& operator=(const BoundedRingBuffer&) = delete;
+
+	template <typename Writer>
+	auto try_push(Writer&& write) -> bool
+	{
+		size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Cell& cell = m_cells[pos & m_mask];
+			const size_t seq = cell.sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+			if (diff == 0)
+			{
+				if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					write(cell.data);
+					cell.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = m_enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	template <typename Reader>
+	auto try_pop(Reader&& read) -> bool
+	{
+		size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Cell& cell = m_cells[pos & m_mask];
+			const size_t seq = cell.sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+			if (diff == 0)
+			{
+				if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					read(cell.data);
+					cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = m_dequeuePos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	[[nodiscard]] auto empty() const -> bool
+	{
+		const size_t pos = m_dequeuePos.load(std::memory_order_acquire);
+		const size_t seq = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire);
+		return seq != pos + 1;
+	}
+
+	[[nodiscard]] auto capacity() const -> size_t { return m_mask + 1; }
+	[[nodiscard]] auto enqueue_position() const -> size_t { return m_enqueuePos.load(std::memory_order_acquire); }
+	[[nodiscard]] auto dequeue_position() const -> size_t { return m_dequeuePos.load(std::memory_order_acquire); }
+
+private:
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		T data;
+	};
+
+	std::unique_ptr<Cell[]> m_cells;
+	size_t m_mask;
+
+	alignas(64) std::atomic<size_t> m_enqueuePos = 0;
+	alignas(64) std::atomic<size_t> m_dequeuePos = 0;
+};
+
+} // namespace wmcv
+
+#endif // WMCV_RING_BUFFER_H_INCLUDED
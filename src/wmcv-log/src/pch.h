@@ -7,7 +7,23 @@
 #include <cassert>
 #include <cstdarg>
 #include <cinttypes>
+#include <charconv>
 #include <array>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <thread>
+#include <span>
+#include <functional>
+#include <filesystem>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <source_location>
 
 #ifdef _WIN32
 #ifndef WIN32_LEAN_AND_MEAN
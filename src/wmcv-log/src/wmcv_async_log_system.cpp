@@ -0,0 +1,196 @@
+#include "pch.h"
+#include "wmcv_log/wmcv_async_log_system.h"
+
+namespace wmcv
+{
+
+void AsyncLogSystem::Record::assign(const LogRecordHeader& header, std::string_view text)
+{
+	m_header = header;
+	m_length = static_cast<uint32_t>(text.length());
+	if (text.length() < InlineCapacity)
+	{
+		std::copy_n(text.begin(), text.length(), m_inline.begin());
+		m_inline[text.length()] = '\0';
+		m_overflow.clear();
+	}
+	else
+	{
+		m_overflow.assign(text);
+	}
+}
+
+void AsyncLogSystem::Record::take(Record& other)
+{
+	m_header = other.m_header;
+	m_length = other.m_length;
+	if (m_length < InlineCapacity)
+	{
+		std::copy_n(other.m_inline.begin(), m_length + 1, m_inline.begin());
+	}
+	else
+	{
+		m_overflow.swap(other.m_overflow);
+	}
+}
+
+auto AsyncLogSystem::Record::view() const -> std::string_view
+{
+	if (m_length < InlineCapacity)
+	{
+		return std::string_view{m_inline.data(), m_length};
+	}
+
+	return std::string_view{m_overflow};
+}
+
+AsyncLogSystem::AsyncLogSystem(const AsyncLogSystemParams& params)
+	: m_queue(params.capacity)
+	, m_overflowPolicy(params.overflowPolicy)
+	, m_batch(MaxBatchSize)
+	, m_batchRecords(MaxBatchSize)
+	, m_backend([this] { BackendLoop(); })
+{
+}
+
+AsyncLogSystem::~AsyncLogSystem()
+{
+	m_running.store(false, std::memory_order_release);
+	m_signal.fetch_add(1, std::memory_order_release);
+	m_signal.notify_one();
+	m_backend.join();
+}
+
+auto AsyncLogSystem::PushSink(LogSink&& sink) -> LogSinkHandle
+{
+	return m_sinks.Add(std::move(sink));
+}
+
+auto AsyncLogSystem::RemoveSink(LogSinkHandle handle) -> bool
+{
+	return m_sinks.Remove(handle);
+}
+
+void AsyncLogSystem::LogMessage(const LogRecordHeader& header, const std::string_view text)
+{
+	switch (m_overflowPolicy)
+	{
+		case LogOverflowPolicy::Block:
+			while (!TryPush(header, text))
+			{
+				WakeBackend();
+				std::this_thread::yield();
+			}
+			break;
+
+		case LogOverflowPolicy::DropNewest:
+			if (!TryPush(header, text))
+			{
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			break;
+
+		case LogOverflowPolicy::DropOldest:
+			while (!TryPush(header, text))
+			{
+				if (m_queue.try_pop([](Record&) {}))
+				{
+					m_dropped.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+			break;
+	}
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_backendSleeping.load(std::memory_order_relaxed))
+	{
+		WakeBackend();
+	}
+}
+
+void AsyncLogSystem::Flush()
+{
+	const size_t target = m_queue.enqueue_position();
+	WakeBackend();
+
+	size_t drained = m_drained.load(std::memory_order_acquire);
+	while (drained < target)
+	{
+		m_drained.wait(drained, std::memory_order_acquire);
+		drained = m_drained.load(std::memory_order_acquire);
+	}
+}
+
+auto AsyncLogSystem::TryPush(const LogRecordHeader& header, std::string_view text) -> bool
+{
+	return m_queue.try_push([&header, text](Record& record) { record.assign(header, text); });
+}
+
+void AsyncLogSystem::WakeBackend()
+{
+	m_signal.fetch_add(1, std::memory_order_release);
+	m_signal.notify_one();
+}
+
+auto AsyncLogSystem::DrainRecords() -> size_t
+{
+	// Records are moved out of the ring before the sinks run so a slow sink
+	// never holds a cell that producers are waiting on.
+	size_t total = 0;
+	for (;;)
+	{
+		size_t count = 0;
+		while (count < m_batch.size() && m_queue.try_pop([this, count](Record& record) { m_batch[count].take(record); }))
+		{
+			++count;
+		}
+
+		if (count == 0)
+		{
+			return total;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			m_batchRecords[i] = LogRecord{m_batch[i].view(), m_batch[i].header()};
+		}
+
+		const std::span<const LogRecord> records{m_batchRecords.data(), count};
+		m_sinks.ForEach([records](LogSink& sink) { Log(sink, records); });
+
+		total += count;
+	}
+}
+
+void AsyncLogSystem::BackendLoop()
+{
+	for (;;)
+	{
+		const uint32_t signal = m_signal.load(std::memory_order_acquire);
+		const size_t drainedCount = DrainRecords();
+
+		m_drained.store(m_queue.dequeue_position(), std::memory_order_release);
+		m_drained.notify_all();
+
+		if (drainedCount > 0)
+		{
+			continue;
+		}
+
+		if (!m_running.load(std::memory_order_acquire))
+		{
+			break;
+		}
+
+		m_backendSleeping.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_queue.empty())
+		{
+			m_signal.wait(signal, std::memory_order_acquire);
+		}
+		m_backendSleeping.store(false, std::memory_order_relaxed);
+	}
+}
+
+} // namespace wmcv
@@ -0,0 +1,367 @@
+#include "pch.h"
+#include "wmcv_log/wmcv_deferred_log.h"
+
+#include <fstream>
+
+namespace wmcv
+{
+
+namespace
+{
+DeferredLogWriter* s_deferredLog = nullptr;
+
+constexpr std::array<char, 8> FileMagic = {'W', 'M', 'C', 'V', 'D', 'L', 'G', '1'};
+
+struct FormatDefinition
+{
+	std::string_view format;
+	std::span<const DeferredArgType> signature;
+};
+
+class ByteReader
+{
+public:
+	explicit ByteReader(std::span<const std::byte> data)
+		: m_data(data)
+	{
+	}
+
+	[[nodiscard]] auto remaining() const -> size_t { return m_data.size() - m_offset; }
+	[[nodiscard]] auto offset() const -> size_t { return m_offset; }
+
+	template <typename T>
+	auto read(T& value) -> bool
+	{
+		if (remaining() < sizeof(T))
+		{
+			return false;
+		}
+
+		std::memcpy(&value, m_data.data() + m_offset, sizeof(T));
+		m_offset += sizeof(T);
+		return true;
+	}
+
+	auto read_bytes(size_t count, std::span<const std::byte>& bytes) -> bool
+	{
+		if (remaining() < count)
+		{
+			return false;
+		}
+
+		bytes = m_data.subspan(m_offset, count);
+		m_offset += count;
+		return true;
+	}
+
+private:
+	std::span<const std::byte> m_data;
+	size_t m_offset = 0;
+};
+
+template <typename T>
+auto FormatArg(FormatString& out, ByteReader& reader) -> bool
+{
+	T value;
+	if (!reader.read(value))
+	{
+		return false;
+	}
+
+	Formatter<T>::format(out, value);
+	return true;
+}
+
+auto FormatDeferredArg(FormatString& out, ByteReader& reader, DeferredArgType type) -> bool
+{
+	switch (type)
+	{
+		case DeferredArgType::Bool: return FormatArg<bool>(out, reader);
+		case DeferredArgType::Char: return FormatArg<char>(out, reader);
+		case DeferredArgType::Int8: return FormatArg<int8_t>(out, reader);
+		case DeferredArgType::Int16: return FormatArg<int16_t>(out, reader);
+		case DeferredArgType::Int32: return FormatArg<int32_t>(out, reader);
+		case DeferredArgType::Int64: return FormatArg<int64_t>(out, reader);
+		case DeferredArgType::UInt8: return FormatArg<uint8_t>(out, reader);
+		case DeferredArgType::UInt16: return FormatArg<uint16_t>(out, reader);
+		case DeferredArgType::UInt32: return FormatArg<uint32_t>(out, reader);
+		case DeferredArgType::UInt64: return FormatArg<uint64_t>(out, reader);
+		case DeferredArgType::Float: return FormatArg<float>(out, reader);
+		case DeferredArgType::Double: return FormatArg<double>(out, reader);
+		case DeferredArgType::Pointer:
+		{
+			uint64_t address;
+			if (!reader.read(address))
+			{
+				return false;
+			}
+
+			Formatter<const void*>::format(out, reinterpret_cast<const void*>(static_cast<uintptr_t>(address)));
+			return true;
+		}
+		case DeferredArgType::String:
+		{
+			uint16_t length;
+			std::span<const std::byte> bytes;
+			if (!reader.read(length) || !reader.read_bytes(length, bytes))
+			{
+				return false;
+			}
+
+			Formatter<std::string_view>::format(out, std::string_view{reinterpret_cast<const char*>(bytes.data()), bytes.size()});
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Same placeholder rule as CompiledFormatString: every "{}" takes the next argument.
+auto RenderMessage(FormatString& out, const FormatDefinition& definition, std::span<const std::byte> payload) -> bool
+{
+	ByteReader reader{payload};
+	std::string_view remaining = definition.format;
+	for (const DeferredArgType type : definition.signature)
+	{
+		const size_t placeholder = remaining.find("{}");
+		if (placeholder == std::string_view::npos)
+		{
+			return false;
+		}
+
+		out.push(remaining.substr(0, placeholder));
+		remaining.remove_prefix(placeholder + 2);
+		if (!FormatDeferredArg(out, reader, type))
+		{
+			return false;
+		}
+	}
+
+	out.push(remaining);
+	return reader.remaining() == 0;
+}
+
+} // namespace
+
+DeferredLogWriter::DeferredLogWriter(size_t capacity, size_t maxFormats)
+	: m_buffer{std::make_unique<std::byte[]>(capacity)}
+	, m_capacity{capacity}
+	, m_formats{std::make_unique<std::atomic<uint64_t>[]>(std::bit_ceil(std::max<size_t>(maxFormats, 2)))}
+	, m_formatMask{std::bit_ceil(std::max<size_t>(maxFormats, 2)) - 1}
+{
+}
+
+auto DeferredLogWriter::Bytes() const -> std::span<const std::byte>
+{
+	return {m_buffer.get(), std::min(m_cursor.load(std::memory_order_acquire), m_capacity)};
+}
+
+void DeferredLogWriter::Reset()
+{
+	std::fill_n(m_buffer.get(), std::min(m_cursor.load(std::memory_order_relaxed), m_capacity), std::byte{0});
+	for (size_t i = 0; i <= m_formatMask; ++i)
+	{
+		m_formats[i].store(0, std::memory_order_relaxed);
+	}
+	m_cursor.store(0, std::memory_order_release);
+}
+
+auto DeferredLogWriter::SaveToFile(const std::filesystem::path& path) const -> bool
+{
+	std::ofstream file{path, std::ios::binary | std::ios::trunc};
+	if (!file)
+	{
+		return false;
+	}
+
+	const auto bytes = Bytes();
+	file.write(FileMagic.data(), FileMagic.size());
+	file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+	return static_cast<bool>(file);
+}
+
+auto DeferredLogWriter::Reserve(size_t size) -> std::byte*
+{
+	const size_t offset = m_cursor.fetch_add(size, std::memory_order_relaxed);
+	if (offset + size > m_capacity)
+	{
+		m_dropped.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	return m_buffer.get() + offset;
+}
+
+auto DeferredLogWriter::ClaimFormat(uint64_t id) -> bool
+{
+	// Zero marks an empty slot; ids are hashes so a real zero is vanishingly rare.
+	for (size_t probe = 0; probe <= m_formatMask; ++probe)
+	{
+		auto& slot = m_formats[(id + probe) & m_formatMask];
+		uint64_t current = slot.load(std::memory_order_acquire);
+		if (current == id)
+		{
+			return false;
+		}
+
+		if (current == 0 && slot.compare_exchange_strong(current, id, std::memory_order_acq_rel))
+		{
+			return true;
+		}
+
+		if (current == id)
+		{
+			return false;
+		}
+	}
+
+	// Table is full: emit the definition again rather than lose the format.
+	return true;
+}
+
+void DeferredLogWriter::WriteDefinition(uint64_t id, std::string_view format, std::span<const DeferredArgType> signature)
+{
+	const auto length = static_cast<uint16_t>(std::min<size_t>(format.length(), 0xFFFF));
+	const auto argCount = static_cast<uint8_t>(signature.size());
+	const size_t size = sizeof(uint8_t) + sizeof(id) + sizeof(argCount) + argCount + sizeof(length) + length;
+
+	std::byte* out = Reserve(size);
+	if (!out)
+	{
+		return;
+	}
+
+	std::byte* cursor = out + sizeof(uint8_t);
+	std::memcpy(cursor, &id, sizeof(id));
+	cursor += sizeof(id);
+	std::memcpy(cursor, &argCount, sizeof(argCount));
+	cursor += sizeof(argCount);
+	std::memcpy(cursor, signature.data(), argCount);
+	cursor += argCount;
+	std::memcpy(cursor, &length, sizeof(length));
+	cursor += sizeof(length);
+	std::memcpy(cursor, format.data(), length);
+
+	std::atomic_ref<std::byte>{out[0]}.store(static_cast<std::byte>(DeferredRecordTag::Definition), std::memory_order_release);
+}
+
+auto DecodeDeferredLog(std::span<const std::byte> data, const std::function<void(std::string_view)>& onMessage) -> DeferredDecodeResult
+{
+	DeferredDecodeResult result;
+
+	// Concurrent writers can land a message ahead of its definition, so
+	// definitions are collected in a first pass.
+	std::unordered_map<uint64_t, FormatDefinition> definitions;
+	std::vector<std::pair<uint64_t, std::span<const std::byte>>> messages;
+
+	ByteReader reader{data};
+	for (;;)
+	{
+		uint8_t tag;
+		uint64_t id;
+		if (!reader.read(tag) || tag == static_cast<uint8_t>(DeferredRecordTag::End))
+		{
+			break;
+		}
+
+		if (!reader.read(id))
+		{
+			result.truncated = true;
+			break;
+		}
+
+		if (tag == static_cast<uint8_t>(DeferredRecordTag::Definition))
+		{
+			uint8_t argCount;
+			uint16_t length;
+			std::span<const std::byte> signature;
+			std::span<const std::byte> format;
+			if (!reader.read(argCount) || !reader.read_bytes(argCount, signature) || !reader.read(length) || !reader.read_bytes(length, format))
+			{
+				result.truncated = true;
+				break;
+			}
+
+			definitions[id] = FormatDefinition{
+				std::string_view{reinterpret_cast<const char*>(format.data()), format.size()},
+				std::span<const DeferredArgType>{reinterpret_cast<const DeferredArgType*>(signature.data()), signature.size()}};
+		}
+		else if (tag == static_cast<uint8_t>(DeferredRecordTag::Message))
+		{
+			uint16_t size;
+			std::span<const std::byte> payload;
+			if (!reader.read(size) || !reader.read_bytes(size, payload))
+			{
+				result.truncated = true;
+				break;
+			}
+
+			messages.emplace_back(id, payload);
+		}
+		else
+		{
+			result.truncated = true;
+			break;
+		}
+	}
+
+	FormatString text;
+	for (const auto& [id, payload] : messages)
+	{
+		const auto it = definitions.find(id);
+		if (it == definitions.end())
+		{
+			++result.unknownFormats;
+			continue;
+		}
+
+		text = FormatString{};
+		if (!RenderMessage(text, it->second, payload))
+		{
+			++result.unknownFormats;
+			continue;
+		}
+
+		onMessage(text.view());
+		++result.messages;
+	}
+
+	return result;
+}
+
+auto LoadDeferredLogFile(const std::filesystem::path& path) -> std::vector<std::byte>
+{
+	std::ifstream file{path, std::ios::binary};
+	if (!file)
+	{
+		return {};
+	}
+
+	std::array<char, FileMagic.size()> magic = {};
+	if (!file.read(magic.data(), magic.size()) || magic != FileMagic)
+	{
+		return {};
+	}
+
+	std::vector<std::byte> bytes;
+	std::array<char, 4096> chunk;
+	while (file.read(chunk.data(), chunk.size()) || file.gcount() > 0)
+	{
+		const auto* begin = reinterpret_cast<const std::byte*>(chunk.data());
+		bytes.insert(bytes.end(), begin, begin + file.gcount());
+	}
+
+	return bytes;
+}
+
+void SetDeferredLog(DeferredLogWriter* writer) noexcept
+{
+	s_deferredLog = writer;
+}
+
+auto GetDeferredLog() noexcept -> DeferredLogWriter*
+{
+	return s_deferredLog;
+}
+
+} // namespace wmcv
@@ -39,10 +39,4 @@ auto IFormatStream::parse_format_string(std::string_view& formatString) -> bool
 	return false;
 }
 
-auto FormatString::push(std::string_view str) -> IFormatStream&
-{
-	m_buffer += str;
-	return *this;
-}
-
 } // namespace wmcv
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "pch.h"
+#include "wmcv_log/wmcv_log_category.h"
+
+namespace wmcv
+{
+
+struct LogCategoryRegistry
+{
+	static auto Mutex() -> std::mutex&
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	static auto Head() -> LogCategory*&
+	{
+		static LogCategory* head = nullptr;
+		return head;
+	}
+
+	static void Register(LogCategory& category)
+	{
+		std::scoped_lock lock{Mutex()};
+		category.m_next = Head();
+		Head() = &category;
+	}
+
+	static void Unregister(LogCategory& category)
+	{
+		std::scoped_lock lock{Mutex()};
+		for (LogCategory** link = &Head(); *link; link = &(*link)->m_next)
+		{
+			if (*link == &category)
+			{
+				*link = category.m_next;
+				return;
+			}
+		}
+	}
+
+	template <typename Fn>
+	static void ForEach(Fn&& fn)
+	{
+		std::scoped_lock lock{Mutex()};
+		for (LogCategory* category = Head(); category; category = category->m_next)
+		{
+			fn(*category);
+		}
+	}
+};
+
+LogCategory::LogCategory(std::string_view name, LogLevel threshold)
+	: m_name{name}
+	, m_threshold{threshold}
+{
+	LogCategoryRegistry::Register(*this);
+}
+
+LogCategory::~LogCategory()
+{
+	LogCategoryRegistry::Unregister(*this);
+}
+
+auto ToString(LogLevel level) -> std::string_view
+{
+	switch (level)
+	{
+		case LogLevel::Trace: return "trace";
+		case LogLevel::Debug: return "debug";
+		case LogLevel::Info: return "info";
+		case LogLevel::Warning: return "warning";
+		case LogLevel::Error: return "error";
+		case LogLevel::Fatal: return "fatal";
+		case LogLevel::Off: return "off";
+	}
+	return "unknown";
+}
+
+auto GetDefaultLogCategory() noexcept -> LogCategory&
+{
+	static LogCategory category{"default", LogLevel::Trace};
+	return category;
+}
+
+auto SetLogCategoryThreshold(std::string_view name, LogLevel level) -> bool
+{
+	bool found = false;
+	LogCategoryRegistry::ForEach([&](LogCategory& category)
+		{
+			if (category.Name() == name)
+			{
+				category.SetThreshold(level);
+				found = true;
+			}
+		});
+	return found;
+}
+
+void SetAllLogCategoryThresholds(LogLevel level)
+{
+	LogCategoryRegistry::ForEach([level](LogCategory& category)
+		{
+			category.SetThreshold(level);
+		});
+}
+
+} // namespace wmcv
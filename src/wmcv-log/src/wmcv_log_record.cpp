@@ -0,0 +1,23 @@
+#include "pch.h"
+#include "wmcv_log/wmcv_log_record.h"
+
+namespace wmcv
+{
+
+namespace
+{
+std::atomic<uint32_t> s_nextThreadId = 1;
+} // namespace
+
+auto AllocateLogThreadId() noexcept -> uint32_t
+{
+	return s_nextThreadId.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto GetLogClockOrigin() noexcept -> int64_t
+{
+	static const int64_t clockOrigin = GetLogTimestampNs();
+	return clockOrigin;
+}
+
+} // namespace wmcv
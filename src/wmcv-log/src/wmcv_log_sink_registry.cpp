@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "wmcv_log/wmcv_log_sink_registry.h"
+
+namespace wmcv
+{
+
+LogSinkRegistry::~LogSinkRegistry()
+{
+	delete m_current.load(std::memory_order_acquire);
+}
+
+auto LogSinkRegistry::Add(LogSink&& sink) -> LogSinkHandle
+{
+	std::scoped_lock lock{m_writerMutex};
+	const LogSinkHandle handle{m_nextId++};
+
+	auto next = std::make_unique<Snapshot>();
+	if (const Snapshot* current = m_current.load(std::memory_order_relaxed))
+	{
+		next->entries = current->entries;
+	}
+	next->entries.push_back(Entry{handle, std::make_shared<Slot>(std::move(sink))});
+
+	Publish(std::move(next));
+	return handle;
+}
+
+auto LogSinkRegistry::Remove(LogSinkHandle handle) -> bool
+{
+	std::scoped_lock lock{m_writerMutex};
+	const Snapshot* current = m_current.load(std::memory_order_relaxed);
+	if (!current)
+	{
+		return false;
+	}
+
+	auto next = std::make_unique<Snapshot>();
+	next->entries.reserve(current->entries.size());
+	std::copy_if(current->entries.begin(), current->entries.end(), std::back_inserter(next->entries),
+		[handle](const Entry& entry) { return entry.handle != handle; });
+
+	if (next->entries.size() == current->entries.size())
+	{
+		return false;
+	}
+
+	Publish(std::move(next));
+	return true;
+}
+
+void LogSinkRegistry::Clear()
+{
+	std::scoped_lock lock{m_writerMutex};
+	Publish(nullptr);
+}
+
+void LogSinkRegistry::Publish(std::unique_ptr<Snapshot> next)
+{
+	Snapshot* previous = m_current.exchange(next.release(), std::memory_order_seq_cst);
+	if (!previous)
+	{
+		return;
+	}
+
+	// A reader may have picked its parity before the exchange and still be on
+	// the old snapshot under either count, so both must drain once.
+	const uint32_t epoch = m_epoch.load(std::memory_order_relaxed);
+	m_epoch.store(epoch + 1, std::memory_order_seq_cst);
+	WaitForReaders(epoch & 1);
+	m_epoch.store(epoch + 2, std::memory_order_seq_cst);
+	WaitForReaders((epoch + 1) & 1);
+
+	delete previous;
+}
+
+void LogSinkRegistry::WaitForReaders(uint32_t parity)
+{
+	while (m_readers[parity].load(std::memory_order_acquire) != 0)
+	{
+		std::this_thread::yield();
+	}
+}
+
+} // namespace wmcv
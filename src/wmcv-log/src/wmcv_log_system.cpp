@@ -8,39 +8,217 @@ namespace wmcv
 namespace
 {
 LogSystem* s_system = nullptr;
+
+// Set while this thread hands a batch to the sinks, so a sink that logs
+// leaves its records pending instead of delivering recursively.
+thread_local bool t_delivering = false;
 }
 
 class DefaultLogSystem final : public LogSystem
 {
 public:
-	void LogMessage(const std::string_view text) override;
-	void PushSink(LogSink&& sink) override;
+	~DefaultLogSystem() override;
+
+	using LogSystem::LogMessage;
+	void LogMessage(const LogRecordHeader& header, const std::string_view text) override;
+	auto PushSink(LogSink&& sink) -> LogSinkHandle override;
+	auto RemoveSink(LogSinkHandle handle) -> bool override;
+	void Flush() override;
+
+	void Reset(const LogBatchPolicy& policy);
+
+private:
+	void DeliverPending();
+	void RunFlusher(std::stop_token stop);
 
-	std::vector<LogSink> m_sinks;
+	LogSinkRegistry m_sinks;
+	LogBatchPolicy m_policy;
+
+	// Producers append under m_pendingMutex. Delivery swaps the batch out and
+	// calls the sinks with only m_deliveryMutex held, which keeps batches in
+	// order without blocking producers or sinks that log.
+	std::mutex m_pendingMutex;
+	std::condition_variable_any m_pendingReady;
+	std::string m_pendingText;
+	std::vector<size_t> m_pendingEnds;
+	std::vector<LogRecordHeader> m_pendingHeaders;
+	std::chrono::steady_clock::time_point m_oldestPending;
+
+	std::mutex m_deliveryMutex;
+	std::string m_deliveryText;
+	std::vector<size_t> m_deliveryEnds;
+	std::vector<LogRecordHeader> m_deliveryHeaders;
+	std::vector<LogRecord> m_records;
+
+	// Delivers batches that reach maxDelay with no further messages arriving.
+	std::jthread m_flusher;
 };
 
+DefaultLogSystem::~DefaultLogSystem()
+{
+	m_flusher = {};
+	Flush();
+}
 
-void DefaultLogSystem::LogMessage(const std::string_view text)
+void DefaultLogSystem::LogMessage(const LogRecordHeader& header, const std::string_view text)
 {
-	for (auto& sink : m_sinks)
+	if (m_policy.maxRecords <= 1)
+	{
+		const LogRecord record{text, header};
+		m_sinks.ForEach([&record](LogSink& sink) { Log(sink, record); });
+		return;
+	}
+
+	const auto now = std::chrono::steady_clock::now();
+	bool deliver = false;
+	{
+		std::scoped_lock lock{m_pendingMutex};
+		const bool first = m_pendingEnds.empty();
+		if (first)
+		{
+			m_oldestPending = now;
+		}
+
+		m_pendingText.append(text);
+		m_pendingEnds.push_back(m_pendingText.size());
+		m_pendingHeaders.push_back(header);
+
+		deliver = m_pendingEnds.size() >= m_policy.maxRecords || now - m_oldestPending >= m_policy.maxDelay;
+		if (first && !deliver)
+		{
+			m_pendingReady.notify_one();
+		}
+	}
+
+	if (deliver)
 	{
-		Log(sink, text);
+		DeliverPending();
 	}
 }
 
-void DefaultLogSystem::PushSink(LogSink&& sink)
+auto DefaultLogSystem::PushSink(LogSink&& sink) -> LogSinkHandle
+{
+	return m_sinks.Add(std::move(sink));
+}
+
+auto DefaultLogSystem::RemoveSink(LogSinkHandle handle) -> bool
+{
+	return m_sinks.Remove(handle);
+}
+
+void DefaultLogSystem::Flush()
+{
+	DeliverPending();
+}
+
+void DefaultLogSystem::Reset(const LogBatchPolicy& policy)
+{
+	m_flusher = {};
+	Flush();
+	m_sinks.Clear();
+	m_policy = policy;
+	m_records.reserve(policy.maxRecords);
+	m_pendingEnds.reserve(policy.maxRecords);
+	m_pendingHeaders.reserve(policy.maxRecords);
+	m_deliveryEnds.reserve(policy.maxRecords);
+	m_deliveryHeaders.reserve(policy.maxRecords);
+
+	if (policy.maxRecords > 1)
+	{
+		m_flusher = std::jthread{[this](std::stop_token stop) { RunFlusher(stop); }};
+	}
+}
+
+void DefaultLogSystem::DeliverPending()
+{
+	if (t_delivering)
+	{
+		return;
+	}
+
+	std::scoped_lock deliveryLock{m_deliveryMutex};
+	{
+		std::scoped_lock pendingLock{m_pendingMutex};
+		if (m_pendingEnds.empty())
+		{
+			return;
+		}
+
+		// Swapping keeps both sides' capacity for the next batch.
+		std::swap(m_pendingText, m_deliveryText);
+		std::swap(m_pendingEnds, m_deliveryEnds);
+		std::swap(m_pendingHeaders, m_deliveryHeaders);
+	}
+
+	m_records.clear();
+	size_t begin = 0;
+	for (size_t i = 0; i < m_deliveryEnds.size(); ++i)
+	{
+		const size_t end = m_deliveryEnds[i];
+		m_records.push_back(LogRecord{std::string_view{m_deliveryText}.substr(begin, end - begin), m_deliveryHeaders[i]});
+		begin = end;
+	}
+
+	t_delivering = true;
+	const std::span<const LogRecord> records{m_records};
+	m_sinks.ForEach([records](LogSink& sink) { Log(sink, records); });
+	t_delivering = false;
+
+	m_deliveryText.clear();
+	m_deliveryEnds.clear();
+	m_deliveryHeaders.clear();
+}
+
+void DefaultLogSystem::RunFlusher(std::stop_token stop)
+{
+	std::unique_lock lock{m_pendingMutex};
+	while (!stop.stop_requested())
+	{
+		if (m_pendingEnds.empty())
+		{
+			m_pendingReady.wait(lock, stop, [this] { return !m_pendingEnds.empty(); });
+			continue;
+		}
+
+		const auto deadline = m_oldestPending + m_policy.maxDelay;
+		if (std::chrono::steady_clock::now() < deadline)
+		{
+			m_pendingReady.wait_until(lock, stop, deadline, [] { return false; });
+			continue;
+		}
+
+		lock.unlock();
+		DeliverPending();
+		lock.lock();
+	}
+}
+
+void LogSystem::LogMessage(const std::string_view text, const std::source_location& location)
+{
+	LogMessage(CaptureLogRecordHeader(LogLevel::Info, location), text);
+}
+
+auto LogSystem::SetCategoryThreshold(std::string_view category, LogLevel level) -> bool
+{
+	return SetLogCategoryThreshold(category, level);
+}
+
+void LogSystem::SetThreshold(LogLevel level)
 {
-	m_sinks.emplace_back(std::move(sink));
+	SetAllLogCategoryThresholds(level);
 }
 
-void CreateDefaultLogSystem() noexcept
+void CreateDefaultLogSystem(const LogBatchPolicy& policy) noexcept
 {
+	GetLogClockOrigin();
 	static DefaultLogSystem defaultLogSystem;
+	defaultLogSystem.Reset(policy);
 	s_system = &defaultLogSystem;
 }
 
 void SetLogSystem(LogSystem* system) noexcept
 {
+	GetLogClockOrigin();
 	s_system = system;
 }
 
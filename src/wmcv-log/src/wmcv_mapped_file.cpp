@@ -0,0 +1,187 @@
+#include "pch.h"
+#include "wmcv_mapped_file.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace wmcv
+{
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+	: m_data{std::exchange(other.m_data, nullptr)}
+	, m_size{std::exchange(other.m_size, 0)}
+#ifdef _WIN32
+	, m_file{std::exchange(other.m_file, INVALID_HANDLE_VALUE)}
+	, m_mapping{std::exchange(other.m_mapping, nullptr)}
+#else
+	, m_file{std::exchange(other.m_file, -1)}
+#endif
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		Close();
+		m_data = std::exchange(other.m_data, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+		m_file = std::exchange(other.m_file, INVALID_HANDLE_VALUE);
+		m_mapping = std::exchange(other.m_mapping, nullptr);
+#else
+		m_file = std::exchange(other.m_file, -1);
+#endif
+	}
+	return *this;
+}
+
+auto MappedFile::Open(const std::filesystem::path& path, size_t size) -> MappedFile
+{
+	return Map(path, size, true);
+}
+
+auto MappedFile::OpenExisting(const std::filesystem::path& path) -> MappedFile
+{
+	std::error_code error;
+	const auto size = std::filesystem::file_size(path, error);
+	if (error || size == 0)
+	{
+		return {};
+	}
+
+	return Map(path, static_cast<size_t>(size), false);
+}
+
+#ifdef _WIN32
+
+auto MappedFile::Map(const std::filesystem::path& path, size_t size, bool resize) -> MappedFile
+{
+	MappedFile file;
+	file.m_file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, resize ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file.m_file == INVALID_HANDLE_VALUE)
+	{
+		return {};
+	}
+
+	LARGE_INTEGER length;
+	length.QuadPart = static_cast<LONGLONG>(size);
+	if (resize && (!SetFilePointerEx(file.m_file, length, nullptr, FILE_BEGIN) || !SetEndOfFile(file.m_file)))
+	{
+		return {};
+	}
+
+	file.m_mapping = CreateFileMappingW(file.m_file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFF), nullptr);
+	if (!file.m_mapping)
+	{
+		return {};
+	}
+
+	file.m_data = static_cast<std::byte*>(MapViewOfFile(file.m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+	file.m_size = file.m_data ? size : 0;
+	return file;
+}
+
+void MappedFile::Flush() noexcept
+{
+	if (m_data)
+	{
+		FlushViewOfFile(m_data, m_size);
+	}
+}
+
+void MappedFile::Close(size_t finalSize) noexcept
+{
+	if (m_data)
+	{
+		UnmapViewOfFile(m_data);
+	}
+	if (m_mapping)
+	{
+		CloseHandle(m_mapping);
+	}
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		if (m_data && finalSize < m_size)
+		{
+			LARGE_INTEGER length;
+			length.QuadPart = static_cast<LONGLONG>(finalSize);
+			SetFilePointerEx(m_file, length, nullptr, FILE_BEGIN);
+			SetEndOfFile(m_file);
+		}
+		CloseHandle(m_file);
+	}
+
+	m_data = nullptr;
+	m_size = 0;
+	m_mapping = nullptr;
+	m_file = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+auto MappedFile::Map(const std::filesystem::path& path, size_t size, bool resize) -> MappedFile
+{
+	MappedFile file;
+	file.m_file = ::open(path.c_str(), resize ? O_RDWR | O_CREAT : O_RDWR, 0644);
+	if (file.m_file < 0)
+	{
+		return {};
+	}
+
+	if (resize && ::ftruncate(file.m_file, static_cast<off_t>(size)) != 0)
+	{
+		return {};
+	}
+
+	void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file.m_file, 0);
+	if (data == MAP_FAILED)
+	{
+		return {};
+	}
+
+	file.m_data = static_cast<std::byte*>(data);
+	file.m_size = size;
+	return file;
+}
+
+void MappedFile::Flush() noexcept
+{
+	if (m_data)
+	{
+		::msync(m_data, m_size, MS_ASYNC);
+	}
+}
+
+void MappedFile::Close(size_t finalSize) noexcept
+{
+	if (m_data)
+	{
+		::munmap(m_data, m_size);
+		if (finalSize < m_size)
+		{
+			[[maybe_unused]] const int result = ::ftruncate(m_file, static_cast<off_t>(finalSize));
+		}
+	}
+	if (m_file >= 0)
+	{
+		::close(m_file);
+	}
+
+	m_data = nullptr;
+	m_size = 0;
+	m_file = -1;
+}
+
+#endif
+
+} // namespace wmcv
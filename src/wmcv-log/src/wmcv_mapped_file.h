@@ -0,0 +1,52 @@
+#ifndef WMCV_MAPPED_FILE_H_INCLUDED
+#define WMCV_MAPPED_FILE_H_INCLUDED
+
+namespace wmcv
+{
+
+// Read/write shared mapping of a whole file. Stores into Data() reach the file
+// through the page cache, so they survive a crash of the process.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Creates the file if needed and resizes it to exactly size bytes.
+	static auto Open(const std::filesystem::path& path, size_t size) -> MappedFile;
+
+	// Maps an existing file at its current size.
+	static auto OpenExisting(const std::filesystem::path& path) -> MappedFile;
+
+	[[nodiscard]] auto IsOpen() const noexcept -> bool { return m_data != nullptr; }
+	[[nodiscard]] auto Data() const noexcept -> std::byte* { return m_data; }
+	[[nodiscard]] auto Size() const noexcept -> size_t { return m_size; }
+
+	// Schedules dirty pages for write-back without waiting.
+	void Flush() noexcept;
+
+	// Unmaps and truncates the file to finalSize.
+	void Close(size_t finalSize) noexcept;
+	void Close() noexcept { Close(m_size); }
+
+private:
+	static auto Map(const std::filesystem::path& path, size_t size, bool resize) -> MappedFile;
+
+	std::byte* m_data = nullptr;
+	size_t m_size = 0;
+#ifdef _WIN32
+	HANDLE m_file = INVALID_HANDLE_VALUE;
+	HANDLE m_mapping = nullptr;
+#else
+	int m_file = -1;
+#endif
+};
+
+} // namespace wmcv
+
+#endif // WMCV_MAPPED_FILE_H_INCLUDED
@@ -0,0 +1,335 @@
+#include "pch.h"
+#include "wmcv_log/sinks/wmcv_sink_compressedfile.h"
+#include "wmcv_mapped_file.h"
+
+#define LZB_IMPLEMENTATION
+#include <lzb/lzb.h>
+
+namespace wmcv
+{
+
+namespace
+{
+
+constexpr std::array<char, 4> CompressedBlockMagic = {'W', 'L', 'Z', 'B'};
+
+enum class BlockEncoding : uint32_t
+{
+	Stored,
+	Lzb
+};
+
+// On disk each block is this header followed by storedSize bytes.
+struct CompressedBlockHeader
+{
+	std::array<char, 4> magic;
+	BlockEncoding encoding;
+	uint32_t rawSize;
+	uint32_t storedSize;
+};
+
+// Anything larger is treated as a corrupt header rather than allocated.
+constexpr uint32_t MaxBlockRawSize = 64 * 1024 * 1024;
+
+} // namespace
+
+struct LogSinkCompressedFile::State
+{
+	LogSinkCompressedFileParams params;
+	std::ofstream file;
+
+	std::mutex mutex;
+	std::condition_variable workReady;
+	std::condition_variable blocksWritten;
+	std::string current;
+	std::vector<std::string> sealed;
+	std::vector<std::string> spare;
+	uint64_t sealedCount = 0;
+	uint64_t writtenCount = 0;
+	bool stopping = false;
+
+	std::atomic<uint64_t> bytesWritten = 0;
+	std::thread writer;
+
+	~State()
+	{
+		if (writer.joinable())
+		{
+			{
+				std::scoped_lock lock{mutex};
+				stopping = true;
+			}
+			workReady.notify_one();
+			writer.join();
+		}
+	}
+
+	auto TakeBuffer() -> std::string
+	{
+		if (spare.empty())
+		{
+			std::string buffer;
+			buffer.reserve(params.blockSize);
+			return buffer;
+		}
+
+		std::string buffer = std::move(spare.back());
+		spare.pop_back();
+		return buffer;
+	}
+
+	void Seal()
+	{
+		sealed.push_back(std::exchange(current, TakeBuffer()));
+		++sealedCount;
+		workReady.notify_one();
+	}
+
+	void SealWhenRoom(std::unique_lock<std::mutex>& lock)
+	{
+		blocksWritten.wait(lock, [this] { return sealed.size() < params.maxPendingBlocks; });
+		Seal();
+	}
+
+	void Append(std::string_view prefix, std::string_view message)
+	{
+		std::unique_lock lock{mutex};
+		const size_t length = prefix.size() + message.size();
+		if (!current.empty() && current.size() + length + 1 > params.blockSize)
+		{
+			SealWhenRoom(lock);
+		}
+
+		// A message longer than a block gets a block of its own.
+		current.append(prefix);
+		current.append(message);
+		current.push_back('\n');
+		if (current.size() >= params.blockSize)
+		{
+			SealWhenRoom(lock);
+		}
+	}
+
+	void WriteBlock(std::string_view raw, std::vector<char>& scratch)
+	{
+		scratch.resize(static_cast<size_t>(lzb_compress_bound(static_cast<int>(raw.size()))));
+		const int compressed = lzb_compress(raw.data(), static_cast<int>(raw.size()), scratch.data(), static_cast<int>(scratch.size()));
+
+		CompressedBlockHeader header{CompressedBlockMagic, BlockEncoding::Lzb, static_cast<uint32_t>(raw.size()), static_cast<uint32_t>(compressed)};
+		std::string_view payload{scratch.data(), static_cast<size_t>(std::max(compressed, 0))};
+		if (compressed < 0 || static_cast<size_t>(compressed) >= raw.size())
+		{
+			header.encoding = BlockEncoding::Stored;
+			header.storedSize = header.rawSize;
+			payload = raw;
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+		bytesWritten.fetch_add(sizeof(header) + payload.size(), std::memory_order_relaxed);
+	}
+
+	void Run()
+	{
+		std::vector<std::string> work;
+		std::vector<char> scratch;
+
+		std::unique_lock lock{mutex};
+		for (;;)
+		{
+			const bool woken = workReady.wait_for(lock, params.flushInterval, [this] { return stopping || !sealed.empty(); });
+			if (sealed.empty() && !current.empty() && (!woken || stopping))
+			{
+				Seal();
+			}
+
+			if (sealed.empty())
+			{
+				if (stopping)
+				{
+					return;
+				}
+				continue;
+			}
+
+			work.swap(sealed);
+			lock.unlock();
+
+			for (const std::string& block : work)
+			{
+				WriteBlock(block, scratch);
+			}
+			file.flush();
+
+			lock.lock();
+			writtenCount += work.size();
+			for (std::string& block : work)
+			{
+				block.clear();
+				spare.push_back(std::move(block));
+			}
+			work.clear();
+			blocksWritten.notify_all();
+		}
+	}
+};
+
+LogSinkCompressedFile::LogSinkCompressedFile(LogSinkCompressedFileParams params)
+	: m_state{std::make_unique<State>()}
+{
+	State& state = *m_state;
+	state.params = std::move(params);
+	state.params.blockSize = std::clamp<size_t>(state.params.blockSize, 64, MaxBlockRawSize / 2);
+	state.params.maxPendingBlocks = std::max<size_t>(state.params.maxPendingBlocks, 1);
+
+	state.file.open(state.params.path, std::ios::binary | std::ios::app);
+	if (!state.file)
+	{
+		return;
+	}
+
+	state.current.reserve(state.params.blockSize);
+	state.writer = std::thread{[&state] { state.Run(); }};
+}
+
+LogSinkCompressedFile::~LogSinkCompressedFile() = default;
+LogSinkCompressedFile::LogSinkCompressedFile(LogSinkCompressedFile&&) noexcept = default;
+LogSinkCompressedFile& LogSinkCompressedFile::operator=(LogSinkCompressedFile&&) noexcept = default;
+
+void LogSinkCompressedFile::Write(std::string_view message) noexcept
+{
+	if (IsOpen())
+	{
+		m_state->Append({}, message);
+	}
+}
+
+void LogSinkCompressedFile::Write(const LogRecord& record) noexcept
+{
+	if (IsOpen())
+	{
+		LogRecordHeaderText header;
+		FormatLogRecordHeader(header, record.header);
+		m_state->Append(header.view(), record.message);
+	}
+}
+
+void LogSinkCompressedFile::Flush() noexcept
+{
+	if (!IsOpen())
+	{
+		return;
+	}
+
+	State& state = *m_state;
+	std::unique_lock lock{state.mutex};
+	if (!state.current.empty())
+	{
+		state.SealWhenRoom(lock);
+	}
+
+	const uint64_t target = state.sealedCount;
+	state.blocksWritten.wait(lock, [&state, target] { return state.writtenCount >= target; });
+}
+
+auto LogSinkCompressedFile::IsOpen() const noexcept -> bool
+{
+	return m_state && m_state->writer.joinable();
+}
+
+auto LogSinkCompressedFile::BytesWritten() const noexcept -> uint64_t
+{
+	return m_state ? m_state->bytesWritten.load(std::memory_order_relaxed) : 0;
+}
+
+auto Log(LogSinkCompressedFile& sink, const std::string_view message) noexcept -> void
+{
+	sink.Write(message);
+}
+
+auto Log(LogSinkCompressedFile& sink, std::span<const LogRecord> records) noexcept -> void
+{
+	for (const LogRecord& record : records)
+	{
+		sink.Write(record);
+	}
+}
+
+auto DecodeCompressedLog(std::span<const std::byte> data, const std::function<void(std::string_view text)>& onBlock) -> CompressedLogDecodeResult
+{
+	CompressedLogDecodeResult result;
+	std::vector<char> text;
+
+	size_t offset = 0;
+	while (offset + sizeof(CompressedBlockHeader) <= data.size())
+	{
+		CompressedBlockHeader header;
+		std::memcpy(&header, data.data() + offset, sizeof(header));
+
+		const bool plausible = header.magic == CompressedBlockMagic && header.rawSize <= MaxBlockRawSize &&
+							   (header.encoding == BlockEncoding::Lzb || (header.encoding == BlockEncoding::Stored && header.storedSize == header.rawSize));
+		if (!plausible)
+		{
+			++offset;
+			++result.skippedBytes;
+			continue;
+		}
+
+		// A payload running past the end is either the final block cut short
+		// or a false match inside compressed data. Either way the scan moves
+		// on: intact blocks after a false match still decode, and a real cut
+		// leaves a tail that is reported as truncated below.
+		const size_t payloadOffset = offset + sizeof(header);
+		if (header.storedSize > data.size() - payloadOffset)
+		{
+			++offset;
+			++result.skippedBytes;
+			continue;
+		}
+
+		const auto* payload = reinterpret_cast<const char*>(data.data() + payloadOffset);
+		std::string_view block;
+		if (header.encoding == BlockEncoding::Stored)
+		{
+			block = std::string_view{payload, header.storedSize};
+		}
+		else
+		{
+			text.resize(header.rawSize);
+			const int decoded = lzb_decompress(payload, static_cast<int>(header.storedSize), text.data(), static_cast<int>(text.size()));
+			if (decoded != static_cast<int>(header.rawSize))
+			{
+				++offset;
+				++result.skippedBytes;
+				continue;
+			}
+			block = std::string_view{text.data(), text.size()};
+		}
+
+		onBlock(block);
+		++result.blocks;
+		result.bytes += block.size();
+		offset = payloadOffset + header.storedSize;
+	}
+
+	if (offset < data.size())
+	{
+		result.truncated = true;
+		result.skippedBytes += data.size() - offset;
+	}
+
+	return result;
+}
+
+auto LoadCompressedLogFile(const std::filesystem::path& path) -> std::vector<std::byte>
+{
+	const MappedFile file = MappedFile::OpenExisting(path);
+	if (!file.IsOpen())
+	{
+		return {};
+	}
+
+	return std::vector<std::byte>(file.Data(), file.Data() + file.Size());
+}
+
+} // namespace wmcv
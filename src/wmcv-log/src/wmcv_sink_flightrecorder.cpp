@@ -0,0 +1,197 @@
+#include "pch.h"
+#include "wmcv_log/sinks/wmcv_sink_flightrecorder.h"
+#include "wmcv_log/sinks/wmcv_sink_mappedfile.h"
+#include "wmcv_mapped_file.h"
+
+namespace wmcv
+{
+
+namespace
+{
+
+constexpr std::array<char, 8> FlightRecorderMagic = {'W', 'M', 'C', 'V', 'F', 'L', 'T', '1'};
+
+// File layout: one header, then slotCount slots of slotSize bytes. Sequence
+// numbers start at 1; a slot whose sequence is 0 was never published.
+struct alignas(64) FlightRecorderHeader
+{
+	std::array<char, 8> magic;
+	uint64_t slotSize;
+	uint64_t slotCount;
+	uint64_t nextSequence;
+};
+
+struct FlightRecorderSlot
+{
+	uint64_t sequence;
+	uint32_t length;
+	uint32_t reserved;
+};
+
+constexpr size_t MinSlotSize = 32;
+
+auto SlotAt(std::byte* base, size_t slotSize, size_t index) -> std::byte*
+{
+	return base + sizeof(FlightRecorderHeader) + index * slotSize;
+}
+
+} // namespace
+
+struct LogSinkFlightRecorder::State
+{
+	MappedFile file;
+	FlightRecorderHeader* header = nullptr;
+	size_t slotSize = 0;
+	size_t slotCount = 0;
+
+	void Write(std::string_view prefix, std::string_view message) noexcept
+	{
+		const uint64_t sequence = std::atomic_ref<uint64_t>{header->nextSequence}.fetch_add(1, std::memory_order_relaxed) + 1;
+		std::byte* slot = SlotAt(file.Data(), slotSize, static_cast<size_t>(sequence % slotCount));
+
+		// Unpublish first so a crash mid-copy never pairs a sequence with torn text.
+		auto* slotHeader = reinterpret_cast<FlightRecorderSlot*>(slot);
+		std::atomic_ref<uint64_t> published{slotHeader->sequence};
+		published.store(0, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		const size_t length = std::min(prefix.length() + message.length(), slotSize - sizeof(FlightRecorderSlot));
+		auto* text = reinterpret_cast<char*>(slot + sizeof(FlightRecorderSlot));
+		const size_t prefixLength = prefix.copy(text, length);
+		message.copy(text + prefixLength, length - prefixLength);
+		slotHeader->length = static_cast<uint32_t>(length);
+		published.store(sequence, std::memory_order_release);
+	}
+};
+
+LogSinkFlightRecorder::LogSinkFlightRecorder(LogSinkFlightRecorderParams params)
+	: m_state{std::make_unique<State>()}
+{
+	const size_t slotSize = (std::max(params.slotSize, MinSlotSize) + 7) & ~size_t{7};
+	const size_t slotCount = std::max<size_t>(params.capacity / slotSize, 1);
+
+	std::error_code error;
+	if (std::filesystem::exists(params.path, error))
+	{
+		std::filesystem::rename(params.path, LogSegmentPath(params.path, 1), error);
+		if (error)
+		{
+			std::filesystem::remove(params.path, error);
+		}
+	}
+
+	m_state->file = MappedFile::Open(params.path, sizeof(FlightRecorderHeader) + slotCount * slotSize);
+	if (!m_state->file.IsOpen())
+	{
+		return;
+	}
+
+	// The file is freshly created, so every slot starts zeroed and unpublished.
+	auto* header = new (m_state->file.Data()) FlightRecorderHeader{FlightRecorderMagic, slotSize, slotCount, 0};
+	m_state->header = header;
+	m_state->slotSize = slotSize;
+	m_state->slotCount = slotCount;
+}
+
+LogSinkFlightRecorder::~LogSinkFlightRecorder() = default;
+LogSinkFlightRecorder::LogSinkFlightRecorder(LogSinkFlightRecorder&&) noexcept = default;
+LogSinkFlightRecorder& LogSinkFlightRecorder::operator=(LogSinkFlightRecorder&&) noexcept = default;
+
+void LogSinkFlightRecorder::Write(std::string_view message) noexcept
+{
+	if (IsOpen())
+	{
+		m_state->Write({}, message);
+	}
+}
+
+void LogSinkFlightRecorder::Write(const LogRecord& record) noexcept
+{
+	if (IsOpen())
+	{
+		LogRecordHeaderText header;
+		FormatLogRecordHeader(header, record.header);
+		m_state->Write(header.view(), record.message);
+	}
+}
+
+auto LogSinkFlightRecorder::IsOpen() const noexcept -> bool
+{
+	return m_state && m_state->header;
+}
+
+auto LogSinkFlightRecorder::SlotCount() const noexcept -> size_t
+{
+	return m_state ? m_state->slotCount : 0;
+}
+
+auto Log(LogSinkFlightRecorder& sink, const std::string_view message) noexcept -> void
+{
+	sink.Write(message);
+}
+
+auto Log(LogSinkFlightRecorder& sink, std::span<const LogRecord> records) noexcept -> void
+{
+	for (const LogRecord& record : records)
+	{
+		sink.Write(record);
+	}
+}
+
+auto ReadFlightRecorder(std::span<const std::byte> data, const std::function<void(uint64_t sequence, std::string_view message)>& onRecord) -> bool
+{
+	FlightRecorderHeader header;
+	if (data.size() < sizeof(header))
+	{
+		return false;
+	}
+
+	std::memcpy(&header, data.data(), sizeof(header));
+	if (header.magic != FlightRecorderMagic || header.slotSize < MinSlotSize || header.slotCount == 0 ||
+		header.slotCount > (data.size() - sizeof(header)) / header.slotSize)
+	{
+		return false;
+	}
+
+	struct Entry
+	{
+		uint64_t sequence;
+		std::string_view message;
+	};
+
+	std::vector<Entry> entries;
+	entries.reserve(static_cast<size_t>(header.slotCount));
+	for (size_t index = 0; index < header.slotCount; ++index)
+	{
+		const std::byte* slot = data.data() + sizeof(header) + index * header.slotSize;
+		FlightRecorderSlot slotHeader;
+		std::memcpy(&slotHeader, slot, sizeof(slotHeader));
+		if (slotHeader.sequence == 0 || slotHeader.length > header.slotSize - sizeof(slotHeader))
+		{
+			continue;
+		}
+
+		entries.push_back(Entry{slotHeader.sequence, std::string_view{reinterpret_cast<const char*>(slot + sizeof(slotHeader)), slotHeader.length}});
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.sequence < rhs.sequence; });
+	for (const Entry& entry : entries)
+	{
+		onRecord(entry.sequence, entry.message);
+	}
+
+	return true;
+}
+
+auto LoadFlightRecorderFile(const std::filesystem::path& path) -> std::vector<std::byte>
+{
+	const MappedFile file = MappedFile::OpenExisting(path);
+	if (!file.IsOpen())
+	{
+		return {};
+	}
+
+	return std::vector<std::byte>(file.Data(), file.Data() + file.Size());
+}
+
+} // namespace wmcv
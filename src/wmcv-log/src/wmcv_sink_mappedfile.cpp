@@ -0,0 +1,234 @@
+#include "pch.h"
+#include "wmcv_log/sinks/wmcv_sink_mappedfile.h"
+#include "wmcv_mapped_file.h"
+
+namespace wmcv
+{
+
+struct LogSinkMappedFile::State
+{
+	LogSinkMappedFileParams params;
+	MappedFile file;
+	size_t cursor = 0;
+	size_t droppedSinceReopen = 0;
+	std::atomic<uint64_t> dropped = 0;
+
+	~State()
+	{
+		file.Close(cursor);
+	}
+
+	void OpenSegment(size_t cursorStart)
+	{
+		file = MappedFile::Open(params.path, params.segmentSize);
+		cursor = file.IsOpen() ? cursorStart : 0;
+	}
+
+	// Resume after whatever is left at the active path, crash padding
+	// removed, rotating it first when it is already full.
+	void ResumeSegment()
+	{
+		std::error_code error;
+		size_t recovered = 0;
+		if (std::filesystem::exists(params.path, error))
+		{
+			recovered = RecoverLogSegment(params.path);
+			if (recovered >= params.segmentSize)
+			{
+				RotateSegments();
+				recovered = 0;
+			}
+		}
+
+		OpenSegment(recovered);
+	}
+
+	void RotateSegments()
+	{
+		std::error_code error;
+		if (params.retainedSegments == 0)
+		{
+			std::filesystem::remove(params.path, error);
+			return;
+		}
+
+		std::filesystem::remove(LogSegmentPath(params.path, params.retainedSegments), error);
+		for (size_t index = params.retainedSegments; index > 1; --index)
+		{
+			const auto from = LogSegmentPath(params.path, index - 1);
+			if (std::filesystem::exists(from, error))
+			{
+				std::filesystem::rename(from, LogSegmentPath(params.path, index), error);
+			}
+		}
+		std::filesystem::rename(params.path, LogSegmentPath(params.path, 1), error);
+	}
+
+	void Roll()
+	{
+		file.Close(cursor);
+		RotateSegments();
+		OpenSegment(0);
+	}
+
+	void Drop() noexcept
+	{
+		++droppedSinceReopen;
+		dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// A failed open or roll may be transient, so a closed sink tries again
+	// once every reopenAfterDrops dropped messages.
+	auto TryReopen() noexcept -> bool
+	{
+		if (droppedSinceReopen < params.reopenAfterDrops)
+		{
+			return false;
+		}
+
+		droppedSinceReopen = 0;
+		try
+		{
+			ResumeSegment();
+		}
+		catch (...)
+		{
+		}
+		return file.IsOpen();
+	}
+
+	void Append(std::string_view prefix, std::string_view message) noexcept
+	{
+		if (!file.IsOpen() && !TryReopen())
+		{
+			Drop();
+			return;
+		}
+
+		const size_t capacity = params.segmentSize;
+		const size_t length = std::min(prefix.length() + message.length(), capacity - 1);
+		if (cursor + length + 1 > capacity)
+		{
+			// Building the rotated paths can throw; losing the record beats
+			// terminating from inside a log call.
+			try
+			{
+				Roll();
+			}
+			catch (...)
+			{
+			}
+
+			if (!file.IsOpen())
+			{
+				Drop();
+				return;
+			}
+		}
+
+		auto* out = reinterpret_cast<char*>(file.Data() + cursor);
+		const size_t prefixLength = prefix.copy(out, length);
+		message.copy(out + prefixLength, length - prefixLength);
+		out[length] = '\n';
+		cursor += length + 1;
+	}
+};
+
+LogSinkMappedFile::LogSinkMappedFile(LogSinkMappedFileParams params)
+	: m_state{std::make_unique<State>()}
+{
+	m_state->params = std::move(params);
+	m_state->params.segmentSize = std::max<size_t>(m_state->params.segmentSize, 2);
+	m_state->ResumeSegment();
+}
+
+LogSinkMappedFile::~LogSinkMappedFile() = default;
+
+LogSinkMappedFile::LogSinkMappedFile(LogSinkMappedFile&&) noexcept = default;
+LogSinkMappedFile& LogSinkMappedFile::operator=(LogSinkMappedFile&&) noexcept = default;
+
+void LogSinkMappedFile::Write(std::string_view message) noexcept
+{
+	if (m_state)
+	{
+		m_state->Append({}, message);
+	}
+}
+
+void LogSinkMappedFile::Write(const LogRecord& record) noexcept
+{
+	if (m_state)
+	{
+		LogRecordHeaderText header;
+		FormatLogRecordHeader(header, record.header);
+		m_state->Append(header.view(), record.message);
+	}
+}
+
+void LogSinkMappedFile::Flush() noexcept
+{
+	if (m_state)
+	{
+		m_state->file.Flush();
+	}
+}
+
+auto LogSinkMappedFile::IsOpen() const noexcept -> bool
+{
+	return m_state && m_state->file.IsOpen();
+}
+
+auto LogSinkMappedFile::Cursor() const noexcept -> size_t
+{
+	return m_state ? m_state->cursor : 0;
+}
+
+auto LogSinkMappedFile::DroppedCount() const noexcept -> uint64_t
+{
+	return m_state ? m_state->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+auto Log(LogSinkMappedFile& sink, const std::string_view message) noexcept -> void
+{
+	sink.Write(message);
+}
+
+auto Log(LogSinkMappedFile& sink, std::span<const LogRecord> records) noexcept -> void
+{
+	for (const LogRecord& record : records)
+	{
+		sink.Write(record);
+	}
+}
+
+auto LogSegmentPath(const std::filesystem::path& path, size_t index) -> std::filesystem::path
+{
+	if (index == 0)
+	{
+		return path;
+	}
+
+	auto rotated = path;
+	rotated.replace_filename(path.stem().string() + "." + std::to_string(index) + path.extension().string());
+	return rotated;
+}
+
+auto RecoverLogSegment(const std::filesystem::path& path) -> size_t
+{
+	MappedFile file = MappedFile::OpenExisting(path);
+	if (!file.IsOpen())
+	{
+		return 0;
+	}
+
+	size_t length = file.Size();
+	while (length > 0 && file.Data()[length - 1] == std::byte{0})
+	{
+		--length;
+	}
+
+	file.Close(length);
+	return length;
+}
+
+} // namespace wmcv
@@ -0,0 +1,61 @@
+#ifndef TEST_BENCH_H_INCLUDED
+#define TEST_BENCH_H_INCLUDED
+
+#include <chrono>
+#include <cstdio>
+
+namespace wmcv::test
+{
+
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static_cast<void>(*static_cast<const volatile char*>(static_cast<const volatile void*>(&value)));
+#endif
+}
+
+// Hides where a pointer came from, so calls through it stay virtual.
+template <typename T>
+inline auto Opaque(T* pointer) -> T*
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : "+r"(pointer));
+	return pointer;
+#else
+	T* volatile hidden = pointer;
+	return hidden;
+#endif
+}
+
+// Best of several timed runs, so the gtest binary can double as a quick
+// micro-benchmark without pulling in a benchmarking library.
+template <typename Fn>
+auto MeasureNsPerOp(size_t iterations, Fn&& fn) -> double
+{
+	constexpr int Runs = 5;
+	double best = 0.0;
+	for (int run = 0; run < Runs; ++run)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; ++i)
+		{
+			fn();
+		}
+		const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		const double perOp = elapsed / static_cast<double>(iterations);
+		best = (run == 0) ? perOp : std::min(best, perOp);
+	}
+	return best;
+}
+
+inline void ReportBenchmark(const char* name, double baselineNs, double candidateNs)
+{
+	std::printf("[ BENCH    ] %-36s %8.2f ns/op -> %8.2f ns/op (x%.2f)\n", name, baselineNs, candidateNs, baselineNs / candidateNs);
+}
+
+} // namespace wmcv::test
+
+#endif // TEST_BENCH_H_INCLUDED
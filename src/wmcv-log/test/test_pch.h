@@ -2,8 +2,24 @@
 #define TEST_PCH_H_INCLUDED
 
 #include <array>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <string>
 #include <string_view>
 #include <cinttypes>
+#include <charconv>
+#include <span>
+#include <functional>
+#include <filesystem>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+#include <chrono>
+#include <source_location>
 
 #endif
\ No newline at end of file
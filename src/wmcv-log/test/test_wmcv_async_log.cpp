@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "wmcv_log/wmcv_log.h"
+#include "wmcv_log/wmcv_async_log_system.h"
+
+namespace
+{
+
+struct SinkState
+{
+	std::atomic<bool> released = false;
+	std::atomic<int> received = 0;
+	std::mutex mutex;
+	std::vector<std::string> messages;
+};
+
+// Stands in for a slow sink: every call stalls until the test releases it.
+struct BlockingSink
+{
+	SinkState* state;
+};
+
+auto Log(BlockingSink& sink, const std::string_view message) noexcept -> void
+{
+	while (!sink.state->released.load(std::memory_order_acquire))
+	{
+		std::this_thread::yield();
+	}
+
+	std::scoped_lock lock{sink.state->mutex};
+	sink.state->messages.emplace_back(message);
+	sink.state->received.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace
+
+TEST(AsyncLog, test_producers_do_not_block_on_sink)
+{
+	constexpr int NumThreads = 4;
+	constexpr int NumMessages = 256;
+
+	SinkState state;
+	wmcv::AsyncLogSystem system{{.capacity = NumThreads * NumMessages, .overflowPolicy = wmcv::LogOverflowPolicy::Block}};
+	system.PushSink(BlockingSink{&state});
+
+	std::vector<std::thread> producers;
+	for (int t = 0; t < NumThreads; ++t)
+	{
+		producers.emplace_back([&system]
+			{
+				for (int i = 0; i < NumMessages; ++i)
+				{
+					system.LogMessage("message");
+				}
+			});
+	}
+
+	for (auto& producer : producers)
+	{
+		producer.join();
+	}
+
+	EXPECT_EQ(state.received.load(), 0);
+
+	state.released.store(true, std::memory_order_release);
+	system.Flush();
+
+	EXPECT_EQ(state.received.load(), NumThreads * NumMessages);
+	EXPECT_EQ(system.DroppedCount(), 0u);
+}
+
+TEST(AsyncLog, test_drop_newest_counts_dropped)
+{
+	SinkState state;
+	wmcv::AsyncLogSystem system{{.capacity = 16, .overflowPolicy = wmcv::LogOverflowPolicy::DropNewest}};
+	system.PushSink(BlockingSink{&state});
+
+	for (int i = 0; i < 100; ++i)
+	{
+		system.LogMessage("message");
+	}
+
+	EXPECT_GT(system.DroppedCount(), 0u);
+
+	state.released.store(true, std::memory_order_release);
+	system.Flush();
+
+	EXPECT_EQ(static_cast<uint64_t>(state.received.load()) + system.DroppedCount(), 100u);
+}
+
+TEST(AsyncLog, test_drop_oldest_keeps_latest)
+{
+	SinkState state;
+	wmcv::AsyncLogSystem system{{.capacity = 16, .overflowPolicy = wmcv::LogOverflowPolicy::DropOldest}};
+	system.PushSink(BlockingSink{&state});
+
+	for (int i = 0; i < 100; ++i)
+	{
+		wmcv::FormatString str;
+		wmcv::format(str, "message {}", i);
+		system.LogMessage(str.view());
+	}
+
+	EXPECT_GT(system.DroppedCount(), 0u);
+
+	state.released.store(true, std::memory_order_release);
+	system.Flush();
+
+	ASSERT_FALSE(state.messages.empty());
+	EXPECT_EQ(state.messages.back(), "message 99");
+	EXPECT_EQ(static_cast<uint64_t>(state.received.load()) + system.DroppedCount(), 100u);
+}
+
+TEST(AsyncLog, test_flush_delivers_long_messages)
+{
+	SinkState state;
+	state.released = true;
+
+	wmcv::AsyncLogSystem system;
+	system.PushSink(BlockingSink{&state});
+	wmcv::SetLogSystem(&system);
+
+	const std::string longMessage(1024, 'x');
+	wmcv::LogMessage("{}", longMessage);
+	wmcv::LogMessage("short");
+	wmcv::GetLogSystem().Flush();
+	wmcv::SetLogSystem(nullptr);
+
+	ASSERT_EQ(state.messages.size(), 2u);
+	EXPECT_EQ(state.messages[0], longMessage);
+	EXPECT_EQ(state.messages[1], "short");
+}
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include "wmcv_log/wmcv_deferred_log.h"
+#include "test_bench.h"
+
+namespace
+{
+
+auto DecodeAll(std::span<const std::byte> bytes, wmcv::DeferredDecodeResult* result = nullptr) -> std::vector<std::string>
+{
+	std::vector<std::string> messages;
+	const auto decoded = wmcv::DecodeDeferredLog(bytes, [&](std::string_view message)
+		{
+			messages.emplace_back(message);
+		});
+
+	if (result)
+	{
+		*result = decoded;
+	}
+	return messages;
+}
+
+template <typename... Args>
+auto FormatNow(wmcv::FormatSpec<Args...> fmt, Args&&... args) -> std::string
+{
+	wmcv::FormatString str;
+	wmcv::format(str, fmt, std::forward<Args>(args)...);
+	return std::string{str.view()};
+}
+
+} // namespace
+
+TEST(DeferredLog, test_decode_matches_format)
+{
+	int value = 0;
+	const std::string name = "container2_diffuse.png";
+	wmcv::DeferredLogWriter writer{4096};
+
+	writer.Write("Frame {} took {} ms", 1024, 16.6f);
+	writer.Write("Failed to load image: {} ({}x{})", name, 512u, int64_t{-512});
+	writer.Write("{} {} {} {}", true, 'c', uint64_t{0xFFFFFFFFFFFFFFFF}, &value);
+	writer.Write("{} {}", 0.1, std::string_view{"view"});
+	writer.Write("no args");
+
+	wmcv::DeferredDecodeResult result;
+	const auto messages = DecodeAll(writer.Bytes(), &result);
+
+	ASSERT_EQ(messages.size(), 5u);
+	EXPECT_EQ(messages[0], FormatNow("Frame {} took {} ms", 1024, 16.6f));
+	EXPECT_EQ(messages[1], FormatNow("Failed to load image: {} ({}x{})", name, 512u, int64_t{-512}));
+	EXPECT_EQ(messages[2], FormatNow("{} {} {} {}", true, 'c', uint64_t{0xFFFFFFFFFFFFFFFF}, &value));
+	EXPECT_EQ(messages[3], FormatNow("{} {}", 0.1, std::string_view{"view"}));
+	EXPECT_EQ(messages[4], "no args");
+	EXPECT_EQ(result.unknownFormats, 0u);
+	EXPECT_FALSE(result.truncated);
+}
+
+TEST(DeferredLog, test_format_defined_once)
+{
+	wmcv::DeferredLogWriter writer{4096};
+	writer.Write("value {}", 1);
+	const size_t first = writer.Bytes().size();
+	writer.Write("value {}", 2);
+	const size_t second = writer.Bytes().size() - first;
+
+	// Second record is just the message header and one int.
+	EXPECT_EQ(second, sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint16_t) + sizeof(int));
+	EXPECT_EQ(DecodeAll(writer.Bytes()), (std::vector<std::string>{"value 1", "value 2"}));
+}
+
+TEST(DeferredLog, test_same_format_different_types)
+{
+	wmcv::DeferredLogWriter writer{4096};
+	writer.Write("value {}", 1);
+	writer.Write("value {}", 1.5);
+	writer.Write("value {}", "text");
+
+	EXPECT_EQ(DecodeAll(writer.Bytes()), (std::vector<std::string>{"value 1", "value 1.5", "value text"}));
+}
+
+TEST(DeferredLog, test_overflow_counts_dropped)
+{
+	wmcv::DeferredLogWriter writer{64};
+	for (int i = 0; i < 16; ++i)
+	{
+		writer.Write("message {}", i);
+	}
+
+	wmcv::DeferredDecodeResult result;
+	const auto messages = DecodeAll(writer.Bytes(), &result);
+
+	EXPECT_GT(writer.DroppedCount(), 0u);
+	EXPECT_EQ(messages.size() + writer.DroppedCount(), 16u);
+	EXPECT_EQ(result.unknownFormats, 0u);
+	EXPECT_EQ(messages.front(), "message 0");
+}
+
+TEST(DeferredLog, test_reset_starts_new_stream)
+{
+	wmcv::DeferredLogWriter writer{4096};
+	writer.Write("before {}", 1);
+	writer.Reset();
+	writer.Write("after {}", 2);
+
+	EXPECT_EQ(DecodeAll(writer.Bytes()), std::vector<std::string>{"after 2"});
+}
+
+TEST(DeferredLog, test_concurrent_writers)
+{
+	constexpr int ThreadCount = 4;
+	constexpr int PerThread = 1000;
+	wmcv::DeferredLogWriter writer{1 << 20};
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < ThreadCount; ++t)
+	{
+		threads.emplace_back([&writer, t]
+			{
+				for (int i = 0; i < PerThread; ++i)
+				{
+					writer.Write("thread {} message {}", t, i);
+				}
+			});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	wmcv::DeferredDecodeResult result;
+	const auto messages = DecodeAll(writer.Bytes(), &result);
+	EXPECT_EQ(messages.size(), size_t{ThreadCount * PerThread});
+	EXPECT_EQ(result.unknownFormats, 0u);
+	EXPECT_FALSE(result.truncated);
+}
+
+TEST(DeferredLog, test_file_round_trip)
+{
+	const auto path = std::filesystem::temp_directory_path() / "wmcv_deferred_log_test.bin";
+	{
+		wmcv::DeferredLogWriter writer{4096};
+		writer.Write("saved {} {}", 42, "to disk");
+		ASSERT_TRUE(writer.SaveToFile(path));
+	}
+
+	const auto bytes = wmcv::LoadDeferredLogFile(path);
+	std::filesystem::remove(path);
+
+	EXPECT_EQ(DecodeAll(bytes), std::vector<std::string>{"saved 42 to disk"});
+}
+
+TEST(DeferredLog, test_log_message_deferred_uses_installed_writer)
+{
+	wmcv::DeferredLogWriter writer{4096};
+	wmcv::LogMessageDeferred("ignored {}", 0);
+
+	wmcv::SetDeferredLog(&writer);
+	wmcv::LogMessageDeferred("recorded {}", 1);
+	wmcv::SetDeferredLog(nullptr);
+
+	EXPECT_EQ(DecodeAll(writer.Bytes()), std::vector<std::string>{"recorded 1"});
+}
+
+TEST(DeferredLogBench, deferred_vs_formatted)
+{
+	constexpr size_t Iterations = 50000;
+	const char* name = "container2_diffuse.png";
+	wmcv::SmallFormatString<256> str;
+	// Room for every run so the writer never takes the cheaper drop path.
+	wmcv::DeferredLogWriter writer{5 * Iterations * 64};
+
+	const double formatNs = wmcv::test::MeasureNsPerOp(Iterations, [&]
+		{
+			str.clear();
+			wmcv::format(str, "Frame {} took {} ms loading {}", 1024, 16.6f, name);
+			wmcv::test::DoNotOptimize(str);
+		});
+	const double deferredNs = wmcv::test::MeasureNsPerOp(Iterations, [&]
+		{
+			writer.Write("Frame {} took {} ms loading {}", 1024, 16.6f, name);
+		});
+
+	wmcv::test::ReportBenchmark("deferred three args", formatNs, deferredNs);
+	EXPECT_EQ(writer.DroppedCount(), 0u);
+}
@@ -60,7 +60,7 @@ TEST(Format, test_format_string_no_args_right_brace_only_with_string_right)
 TEST(Format, test_format_string_extra_args)
 {
 	wmcv::FormatString str;
-	wmcv::format(str, "}A String", 1, 'b', true, 4.f);
+	wmcv::format(str, wmcv::runtime_format("}A String"), 1, 'b', true, 4.f);
 	
 	EXPECT_STREQ(str.c_str(), "}A String");
 }
@@ -229,7 +229,7 @@ TEST(Format, test_inplace_format_string_no_args_right_brace_only_with_string_rig
 TEST(Format, test_inplace_format_string_extra_args)
 {
 	wmcv::InplaceFormatString<512> str;
-	wmcv::format(str, "}A String", 1, 'b', true, 4.f);
+	wmcv::format(str, wmcv::runtime_format("}A String"), 1, 'b', true, 4.f);
 	
 	EXPECT_STREQ(str.c_str(), "}A String");
 }
@@ -338,3 +338,82 @@ TEST(Format, test_inplace_format_string_ptr)
 	
 	EXPECT_STRNE(str.c_str(), "");
 }
+
+TEST(Format, test_compiled_format_segments)
+{
+	constexpr wmcv::FormatSpec<int, const char*> spec{"{{a {} b {}}}"};
+	static_assert(spec.segment(0) == "{{a ");
+	static_assert(spec.segment(1) == " b ");
+	static_assert(spec.segment(2) == "}}");
+
+	wmcv::FormatString str;
+	wmcv::format(str, spec, 1, "c");
+	EXPECT_STREQ(str.c_str(), "{{a 1 b c}}");
+}
+
+TEST(Format, test_format_string_float_round_trip)
+{
+	wmcv::FormatString str;
+	wmcv::format(str, "{}, {}, {}, {}", 0.1f, 5678.f, -2.5f, 1e-7f);
+
+	EXPECT_STREQ(str.c_str(), "0.1, 5678, -2.5, 1e-07");
+}
+
+TEST(Format, test_format_string_double_round_trip)
+{
+	wmcv::FormatString str;
+	wmcv::format(str, "{}, {}", 0.1, 1.0 / 3.0);
+
+	EXPECT_STREQ(str.c_str(), "0.1, 0.3333333333333333");
+}
+
+TEST(Format, test_format_string_ptr_hex)
+{
+	wmcv::FormatString str;
+	wmcv::format(str, "{}", reinterpret_cast<int*>(uintptr_t{0xdeadbeef}));
+
+	EXPECT_STREQ(str.c_str(), "0xdeadbeef");
+}
+
+TEST(Format, test_inplace_format_string_truncates)
+{
+	wmcv::InplaceFormatString<8> str;
+	wmcv::format(str, "{}-{}", "abcd", "efgh");
+
+	EXPECT_EQ(str.view(), "abcd-efg");
+	EXPECT_STREQ(str.c_str(), "abcd-efg");
+
+	str.clear();
+	wmcv::format(str, "{}", 42);
+	EXPECT_STREQ(str.c_str(), "42");
+}
+
+namespace
+{
+struct ErasedArg
+{
+	int value;
+};
+} // namespace
+
+// Written against the type-erased stream, so it is reached through FormatStreamAdapter.
+template <>
+struct wmcv::Formatter<ErasedArg>
+{
+	static void format(wmcv::IFormatStream& f, const ErasedArg& arg)
+	{
+		f.push("erased ");
+		wmcv::Formatter<int>::format(f, arg.value);
+	}
+};
+
+TEST(Format, test_format_stream_adapter_fallback)
+{
+	wmcv::InplaceFormatString<32> inplace;
+	wmcv::format(inplace, "[{}]", ErasedArg{7});
+	EXPECT_EQ(inplace.view(), "[erased 7]");
+
+	wmcv::FormatString runtime;
+	wmcv::format(runtime, wmcv::runtime_format("[{}] {}"), ErasedArg{8}, 9);
+	EXPECT_STREQ(runtime.c_str(), "[erased 8] 9");
+}
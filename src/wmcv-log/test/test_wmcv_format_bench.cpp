@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+#include "wmcv_log/wmcv_format.h"
+#include "test_bench.h"
+
+namespace
+{
+constexpr size_t Iterations = 200000;
+}
+
+TEST(FormatBench, compiled_vs_runtime_no_args)
+{
+	wmcv::SmallFormatString<256> runtime;
+	wmcv::SmallFormatString<256> compiled;
+
+	const double runtimeNs = wmcv::test::MeasureNsPerOp(Iterations, [&]
+		{
+			runtime.clear();
+			wmcv::format(runtime, wmcv::runtime_format("ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ"));
+			wmcv::test::DoNotOptimize(runtime);
+		});
+	const double compiledNs = wmcv::test::MeasureNsPerOp(Iterations, [&]
+		{
+			compiled.clear();
+			wmcv::format(compiled, "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ");
+			wmcv::test::DoNotOptimize(compiled);
+		});
+
+	wmcv::test::ReportBenchmark("format no args", runtimeNs, compiledNs);
+	EXPECT_EQ(runtime.view(), compiled.view());
+}
+
+TEST(FormatBench, compiled_vs_runtime_three_args)
+{
+	wmcv::SmallFormatString<256> runtime;
+	wmcv::SmallFormatString<256> compiled;
+
+	const double runtimeNs = wmcv::test::MeasureNsPerOp(Iterations, [&]
+		{
+			runtime.clear();
+			wmcv::format(runtime, wmcv::runtime_format("Failed to load image: {} ({}x{})"), "container2_diffuse.png", 512, 512);
+			wmcv::test::DoNotOptimize(runtime);
+		});
+	const double compiledNs = wmcv::test::MeasureNsPerOp(Iterations, [&]
+		{
+			compiled.clear();
+			wmcv::format(compiled, "Failed to load image: {} ({}x{})", "container2_diffuse.png", 512, 512);
+			wmcv::test::DoNotOptimize(compiled);
+		});
+
+	wmcv::test::ReportBenchmark("format three args", runtimeNs, compiledNs);
+	EXPECT_EQ(runtime.view(), compiled.view());
+}
+
+TEST(FormatBench, compiled_vs_runtime_long_literals)
+{
+	wmcv::SmallFormatString<512> runtime;
+	wmcv::SmallFormatString<512> compiled;
+
+	const double runtimeNs = wmcv::test::MeasureNsPerOp(Iterations, [&]
+		{
+			runtime.clear();
+			wmcv::format(runtime, wmcv::runtime_format("pointLights[{}].position = {} pointLights[{}].ambient = {} pointLights[{}].diffuse = {}"), 0, true, 1, false, 2, 'x');
+			wmcv::test::DoNotOptimize(runtime);
+		});
+	const double compiledNs = wmcv::test::MeasureNsPerOp(Iterations, [&]
+		{
+			compiled.clear();
+			wmcv::format(compiled, "pointLights[{}].position = {} pointLights[{}].ambient = {} pointLights[{}].diffuse = {}", 0, true, 1, false, 2, 'x');
+			wmcv::test::DoNotOptimize(compiled);
+		});
+
+	wmcv::test::ReportBenchmark("format six args", runtimeNs, compiledNs);
+	EXPECT_EQ(runtime.view(), compiled.view());
+}
+
+namespace
+{
+
+// The snprintf kernels the Formatter specializations used before to_chars,
+// kept here as the baseline.
+struct SnprintfFormatter
+{
+	template <typename Stream>
+	static void format(Stream& f, int32_t val)
+	{
+		std::array<char, 64> buffer = {};
+		snprintf(buffer.data(), buffer.size(), "%" PRId32, val);
+		f.push(buffer.data());
+	}
+
+	template <typename Stream>
+	static void format(Stream& f, int64_t val)
+	{
+		std::array<char, 64> buffer = {};
+		snprintf(buffer.data(), buffer.size(), "%" PRIi64, val);
+		f.push(buffer.data());
+	}
+
+	template <typename Stream>
+	static void format(Stream& f, uint64_t val)
+	{
+		std::array<char, 64> buffer = {};
+		snprintf(buffer.data(), buffer.size(), "%" PRIu64, val);
+		f.push(buffer.data());
+	}
+
+	template <typename Stream>
+	static void format(Stream& f, float val)
+	{
+		std::array<char, 64> buffer = {};
+		snprintf(buffer.data(), buffer.size(), "%f", static_cast<double>(val));
+		f.push(buffer.data());
+	}
+
+	template <typename Stream>
+	static void format(Stream& f, double val)
+	{
+		std::array<char, 64> buffer = {};
+		snprintf(buffer.data(), buffer.size(), "%f", val);
+		f.push(buffer.data());
+	}
+
+	template <typename Stream>
+	static void format(Stream& f, const void* ptr)
+	{
+		std::array<char, 64> buffer = {};
+		snprintf(buffer.data(), buffer.size(), "%#" PRIxPTR, reinterpret_cast<uintptr_t>(ptr));
+		f.push(buffer.data());
+	}
+};
+
+template <typename T>
+void CompareFormatterThroughput(const char* name, const std::array<T, 8>& values)
+{
+	wmcv::SmallFormatString<64> str;
+	size_t index = 0;
+
+	const double baselineNs = wmcv::test::MeasureNsPerOp(Iterations, [&]
+		{
+			str.clear();
+			SnprintfFormatter::format(str, values[index++ & 7]);
+			wmcv::test::DoNotOptimize(str);
+		});
+	const double toCharsNs = wmcv::test::MeasureNsPerOp(Iterations, [&]
+		{
+			str.clear();
+			wmcv::Formatter<T>::format(str, values[index++ & 7]);
+			wmcv::test::DoNotOptimize(str);
+		});
+
+	wmcv::test::ReportBenchmark(name, baselineNs, toCharsNs);
+}
+
+} // namespace
+
+TEST(FormatterBench, int32)
+{
+	CompareFormatterThroughput<int32_t>("Formatter<int32_t>", {0, 7, -42, 1024, 65535, -2147483647, 2147483647, 31337});
+}
+
+TEST(FormatterBench, int64)
+{
+	CompareFormatterThroughput<int64_t>("Formatter<int64_t>", {0, 7, -42, 1024, 1ll << 40, -(1ll << 62), 9223372036854775807ll, 31337});
+}
+
+TEST(FormatterBench, uint64)
+{
+	CompareFormatterThroughput<uint64_t>("Formatter<uint64_t>", {0u, 7u, 42u, 1024u, 1ull << 40, 1ull << 62, 18446744073709551615ull, 31337u});
+}
+
+TEST(FormatterBench, float)
+{
+	CompareFormatterThroughput<float>("Formatter<float>", {0.f, 0.1f, -2.5f, 16.6f, 3.14159f, 1e-7f, 5678.f, 0.032f});
+}
+
+TEST(FormatterBench, double)
+{
+	CompareFormatterThroughput<double>("Formatter<double>", {0.0, 0.1, -2.5, 16.6, 3.14159, 1e-7, 5678.0, 0.032});
+}
+
+TEST(FormatterBench, pointer)
+{
+	std::array<int, 8> storage = {};
+	std::array<const void*, 8> pointers = {};
+	for (size_t i = 0; i < storage.size(); ++i)
+	{
+		pointers[i] = &storage[i];
+	}
+	CompareFormatterThroughput<const void*>("Formatter<T*>", pointers);
+}
+
+namespace
+{
+
+// Formats the same message through the IFormatStream adapter, which is what
+// every push cost before format() was templated on the stream, and directly
+// into the concrete buffer.
+template <typename Stream, typename Fn>
+void CompareVirtualToStatic(const char* name, Fn&& formatInto)
+{
+	Stream erasedTarget;
+	Stream direct;
+	wmcv::FormatStreamAdapter<Stream> adapter{erasedTarget};
+	wmcv::IFormatStream* erased = wmcv::test::Opaque<wmcv::IFormatStream>(&adapter);
+
+	const double virtualNs = wmcv::test::MeasureNsPerOp(Iterations, [&]
+		{
+			erasedTarget.clear();
+			formatInto(*erased);
+			wmcv::test::DoNotOptimize(erasedTarget.view());
+		});
+	const double staticNs = wmcv::test::MeasureNsPerOp(Iterations, [&]
+		{
+			direct.clear();
+			formatInto(direct);
+			wmcv::test::DoNotOptimize(direct.view());
+		});
+
+	wmcv::test::ReportBenchmark(name, virtualNs, staticNs);
+	EXPECT_EQ(erasedTarget.view(), direct.view());
+}
+
+} // namespace
+
+TEST(FormatBench, virtual_vs_static_inplace_no_args)
+{
+	CompareVirtualToStatic<wmcv::InplaceFormatString<128>>("inplace short no args", [](auto& out)
+		{
+			wmcv::format(out, "ERROR::SHADER::PROGRAM::LINKING_FAILED");
+		});
+}
+
+TEST(FormatBench, virtual_vs_static_inplace_integers)
+{
+	CompareVirtualToStatic<wmcv::InplaceFormatString<128>>("inplace short integers", [](auto& out)
+		{
+			wmcv::format(out, "frame {} draws {}", 1024, 37);
+		});
+}
+
+TEST(FormatBench, virtual_vs_static_inplace_strings)
+{
+	CompareVirtualToStatic<wmcv::InplaceFormatString<128>>("inplace short strings", [](auto& out)
+		{
+			wmcv::format(out, "uniform {} = {} ({})", "model", true, 'x');
+		});
+}
+
+TEST(FormatBench, virtual_vs_static_log_buffer)
+{
+	CompareVirtualToStatic<wmcv::SmallFormatString<256>>("small buffer short mixed", [](auto& out)
+		{
+			wmcv::format(out, "Failed to load image: {} ({}x{})", "container2_diffuse.png", 512, 512);
+		});
+}
@@ -47,7 +47,7 @@ public:
 
 TEST_F(LogFixture, test_sink)
 {
-	const std::string expected = "Custom Log Message 1234 5678.000000";
+	const std::string expected = "Custom Log Message 1234 5678";
 	std::string result;
 	int counter = 0;
 
@@ -55,4 +55,8 @@ TEST_F(LogFixture, test_sink)
 	wmcv::LogMessage("Custom Log Message {} {}", 1234, 5678.f);
 	EXPECT_EQ(expected, result);
 	EXPECT_EQ(counter, 1);
+
+	wmcv::LogMessage("Custom Log Message {} {}", 1234, 5678.5f);
+	EXPECT_EQ("Custom Log Message 1234 5678.5", result);
+	EXPECT_EQ(counter, 2);
 }
\ No newline at end of file
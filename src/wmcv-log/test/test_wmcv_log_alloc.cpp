@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "wmcv_log/wmcv_log.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+thread_local size_t t_allocationCount = 0;
+}
+
+void* operator new(size_t size)
+{
+	++t_allocationCount;
+	if (void* ptr = std::malloc(size > 0 ? size : 1))
+	{
+		return ptr;
+	}
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+namespace
+{
+
+class CountingLogSystem final : public wmcv::LogSystem
+{
+public:
+	auto PushSink(wmcv::LogSink&&) -> wmcv::LogSinkHandle override { return {}; }
+	auto RemoveSink(wmcv::LogSinkHandle) -> bool override { return false; }
+	void LogMessage(const wmcv::LogRecordHeader&, const std::string_view text) override
+	{
+		++messages;
+		lastLength = text.length();
+	}
+	void Flush() override {}
+
+	size_t messages = 0;
+	size_t lastLength = 0;
+};
+
+class LogAllocationFixture : public ::testing::Test
+{
+public:
+	void SetUp()
+	{
+		wmcv::SetLogSystem(&system);
+	}
+
+	void TearDown()
+	{
+		wmcv::SetLogSystem(nullptr);
+	}
+
+	CountingLogSystem system;
+};
+
+} // namespace
+
+TEST_F(LogAllocationFixture, test_typical_messages_do_not_allocate)
+{
+	int value = 7;
+	const char* name = "diffuse";
+	wmcv::LogMessage("warm up {}", 0);
+
+	const size_t before = t_allocationCount;
+	wmcv::LogMessage("Frame {} took {} ms", 1024, 16.6f);
+	wmcv::LogMessage("Failed to load image: {}", name);
+	wmcv::LogMessage("{} {} {} {}", true, 'c', uint64_t{0xFFFFFFFFFFFFFFFF}, &value);
+	wmcv::LogMessage("ERROR::SHADER::PROGRAM::LINKING_FAILED\n{}", std::string_view{"link error"});
+	const size_t after = t_allocationCount;
+
+	EXPECT_EQ(after - before, 0u);
+	EXPECT_EQ(system.messages, 5u);
+}
+
+TEST_F(LogAllocationFixture, test_long_message_spills_then_reuses_capacity)
+{
+	const std::string longText(2 * wmcv::LogMessageInlineCapacity, 'x');
+
+	wmcv::LogMessage("{}", longText.c_str());
+	EXPECT_EQ(system.lastLength, longText.length());
+
+	const size_t before = t_allocationCount;
+	wmcv::LogMessage("{}", longText.c_str());
+	wmcv::LogMessage("short {}", 1);
+	const size_t after = t_allocationCount;
+
+	EXPECT_EQ(after - before, 0u);
+	EXPECT_EQ(system.lastLength, 7u);
+}
+
+TEST(SmallFormatString, test_spills_past_inline_capacity)
+{
+	wmcv::SmallFormatString<8> str;
+	wmcv::format(str, "{}-{}", "abcd", "efgh");
+
+	EXPECT_TRUE(str.spilled());
+	EXPECT_STREQ(str.c_str(), "abcd-efgh");
+	EXPECT_EQ(str.view(), "abcd-efgh");
+
+	str.clear();
+	wmcv::format(str, "{}", 42);
+	EXPECT_FALSE(str.spilled());
+	EXPECT_STREQ(str.c_str(), "42");
+}
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include "wmcv_log/wmcv_log.h"
+#include "wmcv_log/wmcv_async_log_system.h"
+
+namespace
+{
+
+struct BatchLog
+{
+	std::mutex mutex;
+	std::vector<size_t> batchSizes;
+	std::vector<std::string> messages;
+};
+
+struct BatchedSink
+{
+	BatchLog* log;
+};
+
+auto Log(BatchedSink& sink, std::span<const wmcv::LogRecord> records) -> void
+{
+	std::scoped_lock lock{sink.log->mutex};
+	sink.log->batchSizes.push_back(records.size());
+	for (const auto& record : records)
+	{
+		sink.log->messages.emplace_back(record.message);
+	}
+}
+
+// Logs once from inside every batch it receives.
+struct ReentrantSink
+{
+	BatchLog* log;
+};
+
+auto Log(ReentrantSink& sink, std::span<const wmcv::LogRecord> records) -> void
+{
+	{
+		std::scoped_lock lock{sink.log->mutex};
+		sink.log->batchSizes.push_back(records.size());
+		for (const auto& record : records)
+		{
+			sink.log->messages.emplace_back(record.message);
+		}
+	}
+
+	if (records.front().message != "from sink")
+	{
+		wmcv::LogMessage("from sink");
+	}
+}
+
+auto WaitForMessages(BatchLog& log, size_t count) -> bool
+{
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+	while (std::chrono::steady_clock::now() < deadline)
+	{
+		{
+			std::scoped_lock lock{log.mutex};
+			if (log.messages.size() >= count)
+			{
+				return true;
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds{1});
+	}
+	return false;
+}
+
+struct MessageSink
+{
+	std::vector<std::string>* messages;
+};
+
+auto Log(MessageSink& sink, const std::string_view message) -> void
+{
+	sink.messages->emplace_back(message);
+}
+
+class LogBatchFixture : public ::testing::Test
+{
+public:
+	void TearDown()
+	{
+		wmcv::CreateDefaultLogSystem();
+		wmcv::SetLogSystem(nullptr);
+	}
+};
+
+} // namespace
+
+static_assert(wmcv::IsBatchedLogSink<BatchedSink>);
+static_assert(!wmcv::IsLogSink<BatchedSink>);
+static_assert(wmcv::IsLogSink<MessageSink>);
+static_assert(!wmcv::IsBatchedLogSink<MessageSink>);
+
+TEST_F(LogBatchFixture, test_batches_by_size)
+{
+	BatchLog log;
+	wmcv::CreateDefaultLogSystem({.maxRecords = 4, .maxDelay = std::chrono::hours{1}});
+	wmcv::GetLogSystem().PushSink(BatchedSink{&log});
+
+	for (int i = 0; i < 10; ++i)
+	{
+		wmcv::LogMessage("message {}", i);
+	}
+	EXPECT_EQ(log.batchSizes, (std::vector<size_t>{4, 4}));
+
+	wmcv::GetLogSystem().Flush();
+	EXPECT_EQ(log.batchSizes, (std::vector<size_t>{4, 4, 2}));
+	ASSERT_EQ(log.messages.size(), 10u);
+	EXPECT_EQ(log.messages.front(), "message 0");
+	EXPECT_EQ(log.messages.back(), "message 9");
+}
+
+TEST_F(LogBatchFixture, test_batches_by_age)
+{
+	BatchLog log;
+	wmcv::CreateDefaultLogSystem({.maxRecords = 100, .maxDelay = std::chrono::milliseconds{1}});
+	wmcv::GetLogSystem().PushSink(BatchedSink{&log});
+
+	wmcv::LogMessage("first");
+	wmcv::LogMessage("second");
+
+	// Nothing else is logged, so only the deadline can deliver them.
+	ASSERT_TRUE(WaitForMessages(log, 2));
+	std::scoped_lock lock{log.mutex};
+	EXPECT_EQ(log.messages.front(), "first");
+	EXPECT_EQ(log.messages.back(), "second");
+}
+
+TEST_F(LogBatchFixture, test_sink_can_log_while_receiving_a_batch)
+{
+	BatchLog log;
+	wmcv::CreateDefaultLogSystem({.maxRecords = 2, .maxDelay = std::chrono::hours{1}});
+	wmcv::GetLogSystem().PushSink(ReentrantSink{&log});
+
+	wmcv::LogMessage("a");
+	wmcv::LogMessage("b");
+	EXPECT_EQ(log.messages, (std::vector<std::string>{"a", "b"}));
+
+	// The sink's own record waits for the next delivery.
+	wmcv::GetLogSystem().Flush();
+	EXPECT_EQ(log.messages, (std::vector<std::string>{"a", "b", "from sink"}));
+}
+
+TEST_F(LogBatchFixture, test_message_sink_receives_batch_one_by_one)
+{
+	std::vector<std::string> messages;
+	wmcv::CreateDefaultLogSystem({.maxRecords = 3});
+	wmcv::GetLogSystem().PushSink(MessageSink{&messages});
+
+	wmcv::LogMessage("a");
+	wmcv::LogMessage("b");
+	EXPECT_TRUE(messages.empty());
+	wmcv::LogMessage("c");
+	EXPECT_EQ(messages, (std::vector<std::string>{"a", "b", "c"}));
+}
+
+TEST_F(LogBatchFixture, test_unbatched_policy_delivers_immediately)
+{
+	BatchLog log;
+	wmcv::CreateDefaultLogSystem();
+	wmcv::GetLogSystem().PushSink(BatchedSink{&log});
+
+	wmcv::LogMessage("now");
+	EXPECT_EQ(log.batchSizes, std::vector<size_t>{1});
+}
+
+TEST(LogSinkBatch, test_type_erased_sink_adapts_both_forms)
+{
+	BatchLog log;
+	std::vector<std::string> messages;
+	wmcv::LogSink batched{BatchedSink{&log}};
+	wmcv::LogSink single{MessageSink{&messages}};
+
+	const std::array<wmcv::LogRecord, 2> records = {wmcv::LogRecord{"x"}, wmcv::LogRecord{"y"}};
+	Log(batched, "single");
+	Log(batched, std::span<const wmcv::LogRecord>{records});
+	Log(single, std::span<const wmcv::LogRecord>{records});
+
+	EXPECT_EQ(log.batchSizes, (std::vector<size_t>{1, 2}));
+	EXPECT_EQ(messages, (std::vector<std::string>{"x", "y"}));
+}
+
+TEST(AsyncLogBatch, test_backend_delivers_batches)
+{
+	BatchLog log;
+	{
+		wmcv::AsyncLogSystem system;
+		system.PushSink(BatchedSink{&log});
+		for (int i = 0; i < 500; ++i)
+		{
+			system.LogMessage("record");
+		}
+		system.Flush();
+	}
+
+	EXPECT_EQ(log.messages.size(), 500u);
+	for (const size_t size : log.batchSizes)
+	{
+		EXPECT_LE(size, 64u);
+	}
+}
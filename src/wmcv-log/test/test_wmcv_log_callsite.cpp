@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "wmcv_log/wmcv_log.h"
+
+namespace
+{
+
+struct CountedArg
+{
+	int value;
+};
+
+size_t s_formatCalls = 0;
+
+wmcv::LogCategory s_callsiteLog{"callsite_test", wmcv::LogLevel::Debug};
+
+class RecordingLogSystem final : public wmcv::LogSystem
+{
+public:
+	auto PushSink(wmcv::LogSink&&) -> wmcv::LogSinkHandle override { return {}; }
+	auto RemoveSink(wmcv::LogSinkHandle) -> bool override { return false; }
+	void LogMessage(const wmcv::LogRecordHeader&, const std::string_view text) override { messages.emplace_back(text); }
+	void Flush() override {}
+
+	std::vector<std::string> messages;
+};
+
+class LogCallsiteFixture : public ::testing::Test
+{
+public:
+	void SetUp()
+	{
+		s_formatCalls = 0;
+		s_callsiteLog.SetThreshold(wmcv::LogLevel::Debug);
+		wmcv::SetLogSystem(&system);
+	}
+
+	void TearDown()
+	{
+		wmcv::SetLogSystem(nullptr);
+	}
+
+	RecordingLogSystem system;
+};
+
+} // namespace
+
+template <>
+struct wmcv::Formatter<CountedArg>
+{
+	static void format(wmcv::IFormatStream& f, const CountedArg& arg)
+	{
+		++s_formatCalls;
+		wmcv::Formatter<int>::format(f, arg.value);
+	}
+};
+
+TEST_F(LogCallsiteFixture, test_every_n_formats_only_logged_calls)
+{
+	wmcv::LogCallsite callsite;
+	for (int i = 0; i < 10; ++i)
+	{
+		wmcv::LogEveryN<wmcv::LogLevel::Info>(callsite, s_callsiteLog, 4, "frame {}", CountedArg{i});
+	}
+
+	EXPECT_EQ(s_formatCalls, 3u);
+	EXPECT_EQ(system.messages, (std::vector<std::string>{
+		"frame 0",
+		"frame 4 (3 similar messages suppressed)",
+		"frame 8 (3 similar messages suppressed)"}));
+}
+
+TEST_F(LogCallsiteFixture, test_callsites_are_independent)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		WMCV_LOG_EVERY_N(wmcv::LogLevel::Info, s_callsiteLog, 2, "first {}", i);
+		WMCV_LOG_EVERY_N(wmcv::LogLevel::Info, s_callsiteLog, 2, "second {}", i);
+	}
+
+	EXPECT_EQ(system.messages, (std::vector<std::string>{
+		"first 0",
+		"second 0",
+		"first 2 (1 similar messages suppressed)",
+		"second 2 (1 similar messages suppressed)"}));
+}
+
+TEST_F(LogCallsiteFixture, test_once)
+{
+	wmcv::LogCallsite callsite;
+	for (int i = 0; i < 5; ++i)
+	{
+		wmcv::LogOnce<wmcv::LogLevel::Info>(callsite, s_callsiteLog, "initialised {}", CountedArg{i});
+	}
+
+	EXPECT_EQ(s_formatCalls, 1u);
+	EXPECT_EQ(system.messages, std::vector<std::string>{"initialised 0"});
+}
+
+TEST_F(LogCallsiteFixture, test_at_most_every_interval)
+{
+	wmcv::LogCallsite callsite;
+	const auto logTick = [&callsite](int i) { wmcv::LogAtMostEvery<wmcv::LogLevel::Info>(callsite, s_callsiteLog, std::chrono::milliseconds{20}, "tick {}", CountedArg{i}); };
+
+	logTick(0);
+	logTick(1);
+	logTick(2);
+	std::this_thread::sleep_for(std::chrono::milliseconds{30});
+	logTick(3);
+
+	EXPECT_EQ(s_formatCalls, 2u);
+	EXPECT_EQ(system.messages, (std::vector<std::string>{"tick 0", "tick 3 (2 similar messages suppressed)"}));
+}
+
+TEST_F(LogCallsiteFixture, test_statements_on_one_line_are_independent)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		WMCV_LOG_ONCE(wmcv::LogLevel::Info, s_callsiteLog, "left {}", i); WMCV_LOG_ONCE(wmcv::LogLevel::Info, s_callsiteLog, "right {}", i);
+	}
+
+	EXPECT_EQ(system.messages, (std::vector<std::string>{"left 0", "right 0"}));
+}
+
+TEST_F(LogCallsiteFixture, test_filtered_calls_are_not_counted)
+{
+	wmcv::LogCallsite callsite;
+	s_callsiteLog.SetThreshold(wmcv::LogLevel::Warning);
+	for (int i = 0; i < 5; ++i)
+	{
+		wmcv::LogEveryN<wmcv::LogLevel::Debug>(callsite, s_callsiteLog, 2, "hidden {}", CountedArg{i});
+		wmcv::LogOnce<wmcv::LogLevel::Info>(callsite, s_callsiteLog, "hidden once {}", CountedArg{i});
+	}
+
+	EXPECT_EQ(s_formatCalls, 0u);
+	EXPECT_TRUE(system.messages.empty());
+	EXPECT_EQ(callsite.calls.load(), 0u);
+
+	wmcv::LogEveryN<wmcv::LogLevel::Error>(callsite, s_callsiteLog, 2, "shown {}", CountedArg{5});
+	EXPECT_EQ(system.messages, std::vector<std::string>{"shown 5"});
+}
+
+TEST_F(LogCallsiteFixture, test_every_n_from_many_threads)
+{
+	constexpr int ThreadCount = 4;
+	constexpr int PerThread = 1000;
+	std::atomic<size_t> delivered = 0;
+
+	class CountingSystem final : public wmcv::LogSystem
+	{
+	public:
+		explicit CountingSystem(std::atomic<size_t>& count) : m_count(count) {}
+		auto PushSink(wmcv::LogSink&&) -> wmcv::LogSinkHandle override { return {}; }
+		auto RemoveSink(wmcv::LogSinkHandle) -> bool override { return false; }
+		void LogMessage(const wmcv::LogRecordHeader&, const std::string_view) override { m_count.fetch_add(1); }
+		void Flush() override {}
+		std::atomic<size_t>& m_count;
+	} counting{delivered};
+	wmcv::SetLogSystem(&counting);
+
+	wmcv::LogCallsite callsite;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < ThreadCount; ++t)
+	{
+		threads.emplace_back([&callsite]
+			{
+				for (int i = 0; i < PerThread; ++i)
+				{
+					wmcv::LogEveryN<wmcv::LogLevel::Info>(callsite, s_callsiteLog, 100, "busy {}", i);
+				}
+			});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	EXPECT_EQ(delivered.load(), size_t{ThreadCount * PerThread / 100});
+}
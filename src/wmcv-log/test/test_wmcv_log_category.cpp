@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "wmcv_log/wmcv_log.h"
+
+namespace
+{
+
+struct CountedArg
+{
+	int value;
+};
+
+size_t s_formatCalls = 0;
+
+class RecordingLogSystem final : public wmcv::LogSystem
+{
+public:
+	auto PushSink(wmcv::LogSink&&) -> wmcv::LogSinkHandle override { return {}; }
+	auto RemoveSink(wmcv::LogSinkHandle) -> bool override { return false; }
+	void LogMessage(const wmcv::LogRecordHeader&, const std::string_view text) override { messages.emplace_back(text); }
+	void Flush() override {}
+
+	std::vector<std::string> messages;
+};
+
+class LogCategoryFixture : public ::testing::Test
+{
+public:
+	void SetUp()
+	{
+		s_formatCalls = 0;
+		wmcv::SetLogSystem(&system);
+	}
+
+	void TearDown()
+	{
+		wmcv::SetLogSystem(nullptr);
+	}
+
+	RecordingLogSystem system;
+};
+
+} // namespace
+
+template <>
+struct wmcv::Formatter<CountedArg>
+{
+	static void format(wmcv::IFormatStream& f, const CountedArg& arg)
+	{
+		++s_formatCalls;
+		wmcv::Formatter<int>::format(f, arg.value);
+	}
+};
+
+TEST_F(LogCategoryFixture, test_below_threshold_is_not_formatted)
+{
+	wmcv::LogCategory category{"test.filtered", wmcv::LogLevel::Warning};
+
+	wmcv::LogDebug(category, "debug {}", CountedArg{1});
+	wmcv::LogInfo(category, "info {}", CountedArg{2});
+	wmcv::LogWarning(category, "warning {}", CountedArg{3});
+	wmcv::LogError(category, "error {}", CountedArg{4});
+
+	EXPECT_EQ(s_formatCalls, 2u);
+	EXPECT_EQ(system.messages, (std::vector<std::string>{"warning 3", "error 4"}));
+}
+
+TEST_F(LogCategoryFixture, test_threshold_changes_at_runtime)
+{
+	wmcv::LogCategory category{"test.runtime", wmcv::LogLevel::Fatal};
+
+	wmcv::LogError(category, "first");
+	EXPECT_TRUE(system.SetCategoryThreshold("test.runtime", wmcv::LogLevel::Error));
+	wmcv::LogError(category, "second");
+	EXPECT_TRUE(system.SetCategoryThreshold("test.runtime", wmcv::LogLevel::Off));
+	wmcv::LogFatal(category, "third");
+
+	EXPECT_EQ(category.Threshold(), wmcv::LogLevel::Off);
+	EXPECT_EQ(system.messages, std::vector<std::string>{"second"});
+}
+
+TEST_F(LogCategoryFixture, test_unknown_category)
+{
+	EXPECT_FALSE(system.SetCategoryThreshold("test.missing", wmcv::LogLevel::Info));
+}
+
+TEST_F(LogCategoryFixture, test_set_threshold_applies_to_all_categories)
+{
+	wmcv::LogCategory first{"test.first", wmcv::LogLevel::Trace};
+	wmcv::LogCategory second{"test.second", wmcv::LogLevel::Error};
+
+	system.SetThreshold(wmcv::LogLevel::Warning);
+	EXPECT_EQ(first.Threshold(), wmcv::LogLevel::Warning);
+	EXPECT_EQ(second.Threshold(), wmcv::LogLevel::Warning);
+
+	system.SetThreshold(wmcv::LogLevel::Trace);
+}
+
+TEST_F(LogCategoryFixture, test_destroyed_category_is_unregistered)
+{
+	{
+		wmcv::LogCategory category{"test.scoped"};
+		EXPECT_TRUE(system.SetCategoryThreshold("test.scoped", wmcv::LogLevel::Debug));
+	}
+	EXPECT_FALSE(system.SetCategoryThreshold("test.scoped", wmcv::LogLevel::Debug));
+}
+
+TEST_F(LogCategoryFixture, test_default_category_logs_everything)
+{
+	EXPECT_EQ(wmcv::GetDefaultLogCategory().Threshold(), wmcv::LogLevel::Trace);
+	wmcv::LogError(wmcv::GetDefaultLogCategory(), "error {}", 1);
+	EXPECT_EQ(system.messages, std::vector<std::string>{"error 1"});
+}
+
+TEST(LogLevel, test_compiled_min_level)
+{
+	static_assert(wmcv::IsLogLevelCompiledIn(wmcv::LogLevel::Fatal));
+	static_assert(!wmcv::IsLogLevelCompiledIn(wmcv::LogLevel::Off));
+	EXPECT_EQ(wmcv::IsLogLevelCompiledIn(wmcv::LogLevel::Trace), WMCV_LOG_MIN_LEVEL == 0);
+	EXPECT_EQ(wmcv::ToString(wmcv::LogLevel::Warning), "warning");
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "wmcv_log/wmcv_log.h"
+#include "wmcv_log/wmcv_async_log_system.h"
+
+namespace
+{
+
+struct CapturedRecord
+{
+	std::string message;
+	wmcv::LogRecordHeader header;
+};
+
+struct HeaderSink
+{
+	std::mutex* mutex;
+	std::vector<CapturedRecord>* records;
+};
+
+auto Log(HeaderSink& sink, std::span<const wmcv::LogRecord> records) -> void
+{
+	std::scoped_lock lock{*sink.mutex};
+	for (const auto& record : records)
+	{
+		sink.records->push_back(CapturedRecord{std::string{record.message}, record.header});
+	}
+}
+
+wmcv::LogCategory s_recordTestLog{"RecordTest", wmcv::LogLevel::Trace};
+
+class LogRecordFixture : public ::testing::Test
+{
+public:
+	void TearDown()
+	{
+		wmcv::CreateDefaultLogSystem();
+		wmcv::SetLogSystem(nullptr);
+	}
+
+	std::mutex mutex;
+	std::vector<CapturedRecord> records;
+};
+
+} // namespace
+
+TEST_F(LogRecordFixture, test_header_captured_at_call_site)
+{
+	wmcv::CreateDefaultLogSystem();
+	wmcv::GetLogSystem().PushSink(HeaderSink{&mutex, &records});
+
+	const int64_t before = wmcv::GetLogTimestampNs();
+	const uint32_t line = std::source_location::current().line() + 1;
+	wmcv::LogError(s_recordTestLog, "texture {} missing", 7);
+	wmcv::LogMessage("plain");
+
+	ASSERT_EQ(records.size(), 2u);
+	const wmcv::LogRecordHeader& header = records[0].header;
+	EXPECT_EQ(records[0].message, "texture 7 missing");
+	EXPECT_EQ(header.level, wmcv::LogLevel::Error);
+	EXPECT_EQ(header.location.line(), line);
+	EXPECT_NE(std::string_view{header.location.file_name()}.find("test_wmcv_log_record.cpp"), std::string_view::npos);
+	EXPECT_EQ(header.threadId, wmcv::GetLogThreadId());
+	EXPECT_GE(header.timestampNs, before);
+
+	EXPECT_EQ(records[1].header.level, wmcv::LogLevel::Info);
+	EXPECT_GE(records[1].header.timestampNs, header.timestampNs);
+}
+
+TEST_F(LogRecordFixture, test_header_survives_batching)
+{
+	wmcv::CreateDefaultLogSystem({.maxRecords = 4, .maxDelay = std::chrono::hours{1}});
+	wmcv::GetLogSystem().PushSink(HeaderSink{&mutex, &records});
+
+	wmcv::LogError(s_recordTestLog, "first");
+	wmcv::LogMessage(wmcv::runtime_format("second {}"), 2);
+	const uint32_t runtimeLine = std::source_location::current().line() - 1;
+	wmcv::GetLogSystem().Flush();
+
+	ASSERT_EQ(records.size(), 2u);
+	EXPECT_EQ(records[0].header.level, wmcv::LogLevel::Error);
+	EXPECT_EQ(records[1].header.level, wmcv::LogLevel::Info);
+	EXPECT_EQ(records[1].header.location.line(), runtimeLine);
+}
+
+TEST_F(LogRecordFixture, test_async_system_keeps_thread_ids)
+{
+	wmcv::AsyncLogSystem system;
+	wmcv::SetLogSystem(&system);
+	system.PushSink(HeaderSink{&mutex, &records});
+
+	uint32_t workerId = 0;
+	std::thread worker{[&workerId]
+		{
+			workerId = wmcv::GetLogThreadId();
+			wmcv::LogMessage("worker");
+		}};
+	worker.join();
+	wmcv::LogMessage("main");
+	system.Flush();
+
+	ASSERT_EQ(records.size(), 2u);
+	EXPECT_NE(workerId, wmcv::GetLogThreadId());
+	EXPECT_EQ(records[0].header.threadId, workerId);
+	EXPECT_EQ(records[1].header.threadId, wmcv::GetLogThreadId());
+}
+
+TEST(LogRecord, test_format_header)
+{
+	wmcv::LogRecordHeader header;
+	header.timestampNs = wmcv::GetLogClockOrigin() + 12'000'345'999;
+	header.threadId = 3;
+	header.level = wmcv::LogLevel::Warning;
+	header.location = std::source_location::current();
+
+	wmcv::FormatString str;
+	wmcv::FormatLogRecordHeader(str, header);
+
+	wmcv::FormatString expected;
+	wmcv::format(expected, "[12.000345] [T3] [warning] test_wmcv_log_record.cpp:{} ", header.location.line());
+	EXPECT_EQ(str.view(), expected.view());
+}
@@ -0,0 +1,275 @@
+#include <gtest/gtest.h>
+#include "wmcv_log/wmcv_log.h"
+#include "wmcv_log/sinks/wmcv_sink_compressedfile.h"
+
+#include <lzb/lzb.h>
+
+#include <fstream>
+
+namespace
+{
+
+auto RoundTrip(const std::string& input) -> std::string
+{
+	std::vector<char> compressed(static_cast<size_t>(lzb_compress_bound(static_cast<int>(input.size()))));
+	const int compressedSize = lzb_compress(input.data(), static_cast<int>(input.size()), compressed.data(), static_cast<int>(compressed.size()));
+	EXPECT_GT(compressedSize, 0);
+
+	std::string output(input.size(), '\0');
+	const int decoded = lzb_decompress(compressed.data(), compressedSize, output.data(), static_cast<int>(output.size()));
+	EXPECT_EQ(decoded, static_cast<int>(input.size()));
+	return output;
+}
+
+auto NoiseText(size_t length, uint32_t seed) -> std::string
+{
+	std::string text(length, '\0');
+	for (char& c : text)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		c = static_cast<char>(seed >> 24);
+	}
+	return text;
+}
+
+auto Line(int i) -> std::string
+{
+	wmcv::FormatString line;
+	wmcv::format(line, "frame {} draw calls {} shader cube.fs bound texture container2_diffuse.png", i, i % 97);
+	return std::string{line.view()};
+}
+
+class CompressedFileFixture : public ::testing::Test
+{
+public:
+	void SetUp()
+	{
+		const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+		directory = std::filesystem::temp_directory_path() / "wmcv_compressedfile_test" / info->name();
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory);
+		path = directory / "app.wlz";
+	}
+
+	void TearDown()
+	{
+		std::filesystem::remove_all(directory);
+	}
+
+	auto Decode(std::span<const std::byte> bytes, wmcv::CompressedLogDecodeResult* result = nullptr) -> std::string
+	{
+		std::string text;
+		const auto decoded = wmcv::DecodeCompressedLog(bytes, [&text](std::string_view block) { text.append(block); });
+		if (result)
+		{
+			*result = decoded;
+		}
+		return text;
+	}
+
+	std::filesystem::path directory;
+	std::filesystem::path path;
+};
+
+} // namespace
+
+static_assert(wmcv::IsLogSink<wmcv::LogSinkCompressedFile>);
+
+TEST(Lzb, test_round_trip)
+{
+	for (const size_t length : {size_t{0}, size_t{1}, size_t{12}, size_t{13}, size_t{100}, size_t{70000}})
+	{
+		const std::string noise = NoiseText(length, 7);
+		EXPECT_EQ(RoundTrip(noise), noise);
+
+		const std::string repeated(length, 'a');
+		EXPECT_EQ(RoundTrip(repeated), repeated);
+	}
+
+	std::string text;
+	for (int i = 0; i < 2000; ++i)
+	{
+		text += Line(i);
+	}
+	EXPECT_EQ(RoundTrip(text), text);
+}
+
+TEST(Lzb, test_rejects_malformed_input)
+{
+	const std::string input(1000, 'x');
+	std::vector<char> compressed(static_cast<size_t>(lzb_compress_bound(1000)));
+	const int size = lzb_compress(input.data(), 1000, compressed.data(), static_cast<int>(compressed.size()));
+	ASSERT_GT(size, 0);
+	EXPECT_LT(size, 100);
+
+	std::string output(1000, '\0');
+	EXPECT_EQ(lzb_decompress(compressed.data(), size - 1, output.data(), 1000), -1);
+	EXPECT_EQ(lzb_decompress(compressed.data(), size, output.data(), 999), -1);
+
+	// A match reaching before the start of the output.
+	const std::array<unsigned char, 4> badOffset = {0x00, 0x05, 0x00, 0x00};
+	EXPECT_EQ(lzb_decompress(badOffset.data(), static_cast<int>(badOffset.size()), output.data(), 1000), -1);
+}
+
+TEST_F(CompressedFileFixture, test_round_trip_through_file)
+{
+	std::string expected;
+	{
+		wmcv::LogSinkCompressedFile sink{{.path = path, .blockSize = 4096}};
+		ASSERT_TRUE(sink.IsOpen());
+		for (int i = 0; i < 5000; ++i)
+		{
+			const std::string line = Line(i);
+			Log(sink, line);
+			expected += line + "\n";
+		}
+	}
+
+	wmcv::CompressedLogDecodeResult result;
+	EXPECT_EQ(Decode(wmcv::LoadCompressedLogFile(path), &result), expected);
+	EXPECT_GT(result.blocks, 10u);
+	EXPECT_EQ(result.skippedBytes, 0u);
+	EXPECT_FALSE(result.truncated);
+	EXPECT_LT(std::filesystem::file_size(path), expected.size() / 3);
+}
+
+TEST_F(CompressedFileFixture, test_flush_writes_partial_block)
+{
+	wmcv::LogSinkCompressedFile sink{{.path = path, .flushInterval = std::chrono::hours{1}}};
+	const std::string noise = NoiseText(300, 11);
+	sink.Write("first");
+	sink.Write(noise);
+	sink.Flush();
+
+	EXPECT_GT(sink.BytesWritten(), 0u);
+	EXPECT_EQ(Decode(wmcv::LoadCompressedLogFile(path)), "first\n" + noise + "\n");
+}
+
+TEST_F(CompressedFileFixture, test_records_keep_their_header)
+{
+	static wmcv::LogCategory s_compressedTestLog{"CompressedTest"};
+
+	wmcv::LogRecord record{"frame 120 took 41ms"};
+	record.header = wmcv::CaptureLogRecordHeader(wmcv::LogLevel::Warning, std::source_location::current(), &s_compressedTestLog);
+	record.header.timestampNs = wmcv::GetLogClockOrigin() + 1'500'000'000;
+
+	wmcv::LogSinkCompressedFile sink{{.path = path, .flushInterval = std::chrono::hours{1}}};
+	Log(sink, std::span<const wmcv::LogRecord>{&record, 1});
+	sink.Flush();
+
+	wmcv::FormatString expected;
+	wmcv::format(expected, "[1.500000] [T{}] [warning] [CompressedTest] test_wmcv_sink_compressedfile.cpp:{} frame 120 took 41ms\n",
+		wmcv::GetLogThreadId(), record.header.location.line());
+	EXPECT_EQ(Decode(wmcv::LoadCompressedLogFile(path)), expected.view());
+}
+
+TEST_F(CompressedFileFixture, test_flush_interval_writes_idle_block)
+{
+	wmcv::LogSinkCompressedFile sink{{.path = path, .flushInterval = std::chrono::milliseconds{5}}};
+	sink.Write("idle");
+
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+	while (sink.BytesWritten() == 0 && std::chrono::steady_clock::now() < deadline)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds{1});
+	}
+	EXPECT_GT(sink.BytesWritten(), 0u);
+}
+
+TEST_F(CompressedFileFixture, test_decodes_tailed_and_truncated_copy)
+{
+	{
+		wmcv::LogSinkCompressedFile sink{{.path = path, .blockSize = 1024}};
+		for (int i = 0; i < 400; ++i)
+		{
+			Log(sink, Line(i));
+		}
+	}
+
+	const auto bytes = wmcv::LoadCompressedLogFile(path);
+	std::vector<std::string> blocks;
+	wmcv::DecodeCompressedLog(bytes, [&blocks](std::string_view block) { blocks.emplace_back(block); });
+	ASSERT_GT(blocks.size(), 4u);
+
+	// Start inside the first block and cut the last one short.
+	const std::span<const std::byte> middle = std::span{bytes}.subspan(7, bytes.size() - 12);
+	wmcv::CompressedLogDecodeResult result;
+	const std::string text = Decode(middle, &result);
+
+	std::string expected;
+	for (size_t i = 1; i + 1 < blocks.size(); ++i)
+	{
+		expected += blocks[i];
+	}
+	EXPECT_EQ(text, expected);
+	EXPECT_EQ(result.blocks, blocks.size() - 2);
+	EXPECT_GT(result.skippedBytes, 0u);
+	EXPECT_TRUE(result.truncated);
+}
+
+TEST_F(CompressedFileFixture, test_resyncs_after_a_header_that_overruns)
+{
+	{
+		wmcv::LogSinkCompressedFile sink{{.path = path}};
+		sink.Write("first run");
+	}
+	{
+		// A block header whose payload would run far past the end of the file,
+		// as a false match inside compressed data would.
+		const std::array<uint32_t, 3> fields = {1, 100, 1'000'000};
+		std::ofstream file{path, std::ios::binary | std::ios::app};
+		file.write("WLZB", 4);
+		file.write(reinterpret_cast<const char*>(fields.data()), sizeof(fields));
+	}
+	{
+		wmcv::LogSinkCompressedFile sink{{.path = path}};
+		sink.Write("second run");
+	}
+
+	wmcv::CompressedLogDecodeResult result;
+	EXPECT_EQ(Decode(wmcv::LoadCompressedLogFile(path), &result), "first run\nsecond run\n");
+	EXPECT_EQ(result.blocks, 2u);
+	EXPECT_EQ(result.skippedBytes, 16u);
+	EXPECT_FALSE(result.truncated);
+}
+
+TEST_F(CompressedFileFixture, test_appends_to_existing_file)
+{
+	{
+		wmcv::LogSinkCompressedFile sink{{.path = path}};
+		sink.Write("first run");
+	}
+	{
+		wmcv::LogSinkCompressedFile sink{{.path = path}};
+		sink.Write("second run");
+	}
+
+	EXPECT_EQ(Decode(wmcv::LoadCompressedLogFile(path)), "first run\nsecond run\n");
+}
+
+TEST_F(CompressedFileFixture, test_concurrent_writers)
+{
+	constexpr int ThreadCount = 4;
+	constexpr int PerThread = 2000;
+	{
+		wmcv::LogSinkCompressedFile sink{{.path = path, .blockSize = 2048, .maxPendingBlocks = 2}};
+		std::vector<std::thread> threads;
+		for (int t = 0; t < ThreadCount; ++t)
+		{
+			threads.emplace_back([&sink, t]
+				{
+					for (int i = 0; i < PerThread; ++i)
+					{
+						Log(sink, Line(t * PerThread + i));
+					}
+				});
+		}
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	const std::string text = Decode(wmcv::LoadCompressedLogFile(path));
+	EXPECT_EQ(static_cast<int>(std::count(text.begin(), text.end(), '\n')), ThreadCount * PerThread);
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include "wmcv_log/wmcv_log.h"
+#include "wmcv_log/sinks/wmcv_sink_mappedfile.h"
+#include "wmcv_log/sinks/wmcv_sink_flightrecorder.h"
+
+namespace
+{
+
+struct Recovered
+{
+	std::vector<uint64_t> sequences;
+	std::vector<std::string> messages;
+};
+
+auto Recover(const std::filesystem::path& path, bool* valid = nullptr) -> Recovered
+{
+	Recovered recovered;
+	const bool result = wmcv::ReadFlightRecorder(wmcv::LoadFlightRecorderFile(path), [&](uint64_t sequence, std::string_view message)
+		{
+			recovered.sequences.push_back(sequence);
+			recovered.messages.emplace_back(message);
+		});
+
+	if (valid)
+	{
+		*valid = result;
+	}
+	return recovered;
+}
+
+class FlightRecorderFixture : public ::testing::Test
+{
+public:
+	void SetUp()
+	{
+		const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+		directory = std::filesystem::temp_directory_path() / "wmcv_flightrecorder_test" / info->name();
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory);
+		path = directory / "app.flight";
+	}
+
+	void TearDown()
+	{
+		std::filesystem::remove_all(directory);
+	}
+
+	std::filesystem::path directory;
+	std::filesystem::path path;
+};
+
+} // namespace
+
+static_assert(wmcv::IsLogSink<wmcv::LogSinkFlightRecorder>);
+
+TEST_F(FlightRecorderFixture, test_keeps_most_recent_records)
+{
+	wmcv::LogSinkFlightRecorder sink{{.path = path, .capacity = 4 * 64, .slotSize = 64}};
+	ASSERT_EQ(sink.SlotCount(), 4u);
+
+	for (int i = 0; i < 10; ++i)
+	{
+		wmcv::FormatString line;
+		wmcv::format(line, "record {}", i);
+		sink.Write(line.view());
+	}
+
+	// Read while the sink is still live, as a crash would leave it.
+	bool valid = false;
+	const auto recovered = Recover(path, &valid);
+	EXPECT_TRUE(valid);
+	EXPECT_EQ(recovered.sequences, (std::vector<uint64_t>{7, 8, 9, 10}));
+	EXPECT_EQ(recovered.messages, (std::vector<std::string>{"record 6", "record 7", "record 8", "record 9"}));
+}
+
+TEST_F(FlightRecorderFixture, test_records_keep_their_header)
+{
+	static wmcv::LogCategory s_flightTestLog{"FlightTest"};
+
+	wmcv::LogRecord record{"frame 120 took 41ms"};
+	record.header = wmcv::CaptureLogRecordHeader(wmcv::LogLevel::Warning, std::source_location::current(), &s_flightTestLog);
+	record.header.timestampNs = wmcv::GetLogClockOrigin() + 1'500'000'000;
+	{
+		wmcv::LogSinkFlightRecorder sink{{.path = path, .capacity = 4096}};
+		wmcv::LogSink erased{std::move(sink)};
+		Log(erased, record);
+	}
+
+	wmcv::FormatString expected;
+	wmcv::format(expected, "[1.500000] [T{}] [warning] [FlightTest] test_wmcv_sink_flightrecorder.cpp:{} frame 120 took 41ms",
+		wmcv::GetLogThreadId(), record.header.location.line());
+	EXPECT_EQ(Recover(path).messages, std::vector<std::string>{std::string{expected.view()}});
+}
+
+TEST_F(FlightRecorderFixture, test_truncates_to_slot)
+{
+	wmcv::LogSinkFlightRecorder sink{{.path = path, .capacity = 1024, .slotSize = 32}};
+	sink.Write(std::string(100, 'x'));
+
+	const auto recovered = Recover(path);
+	ASSERT_EQ(recovered.messages.size(), 1u);
+	EXPECT_EQ(recovered.messages[0], std::string(16, 'x'));
+}
+
+TEST_F(FlightRecorderFixture, test_survives_abnormal_exit)
+{
+	const auto crashing = [this]
+	{
+		wmcv::LogSinkFlightRecorder sink{{.path = path, .capacity = 4096}};
+		wmcv::LogSink erased{std::move(sink)};
+		Log(erased, "before crash 1");
+		Log(erased, "before crash 2");
+		std::abort();
+	};
+	ASSERT_DEATH(crashing(), "");
+
+	const auto recovered = Recover(path);
+	EXPECT_EQ(recovered.messages, (std::vector<std::string>{"before crash 1", "before crash 2"}));
+}
+
+TEST_F(FlightRecorderFixture, test_previous_run_is_kept)
+{
+	{
+		wmcv::LogSinkFlightRecorder sink{{.path = path, .capacity = 4096}};
+		sink.Write("first run");
+	}
+	{
+		wmcv::LogSinkFlightRecorder sink{{.path = path, .capacity = 4096}};
+		sink.Write("second run");
+	}
+
+	EXPECT_EQ(Recover(path).messages, std::vector<std::string>{"second run"});
+	EXPECT_EQ(Recover(wmcv::LogSegmentPath(path, 1)).messages, std::vector<std::string>{"first run"});
+}
+
+TEST_F(FlightRecorderFixture, test_rejects_other_files)
+{
+	const std::array<std::byte, 128> garbage = {};
+	EXPECT_FALSE(wmcv::ReadFlightRecorder(garbage, [](uint64_t, std::string_view) {}));
+	EXPECT_FALSE(wmcv::ReadFlightRecorder({}, [](uint64_t, std::string_view) {}));
+}
+
+TEST_F(FlightRecorderFixture, test_concurrent_writers)
+{
+	constexpr int ThreadCount = 4;
+	constexpr int PerThread = 200;
+	wmcv::LogSinkFlightRecorder sink{{.path = path, .capacity = 64 * 1024, .slotSize = 64}};
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < ThreadCount; ++t)
+	{
+		threads.emplace_back([&sink]
+			{
+				for (int i = 0; i < PerThread; ++i)
+				{
+					sink.Write("concurrent record");
+				}
+			});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	const auto recovered = Recover(path);
+	EXPECT_EQ(recovered.messages.size(), size_t{ThreadCount * PerThread});
+	EXPECT_EQ(recovered.sequences.back(), uint64_t{ThreadCount * PerThread});
+}
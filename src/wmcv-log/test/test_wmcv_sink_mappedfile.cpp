@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+#include "wmcv_log/wmcv_log.h"
+#include "wmcv_log/sinks/wmcv_sink_mappedfile.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+
+auto ReadFile(const std::filesystem::path& path) -> std::string
+{
+	std::error_code error;
+	const auto size = std::filesystem::file_size(path, error);
+	if (error)
+	{
+		return {};
+	}
+
+	std::string content(size, '\0');
+	std::ifstream file{path, std::ios::binary};
+	file.read(content.data(), static_cast<std::streamsize>(content.size()));
+	return content;
+}
+
+class MappedFileSinkFixture : public ::testing::Test
+{
+public:
+	void SetUp()
+	{
+		const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+		directory = std::filesystem::temp_directory_path() / "wmcv_mappedfile_test" / info->name();
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory);
+		path = directory / "app.log";
+	}
+
+	void TearDown()
+	{
+		std::filesystem::remove_all(directory);
+	}
+
+	std::filesystem::path directory;
+	std::filesystem::path path;
+};
+
+} // namespace
+
+static_assert(wmcv::IsLogSink<wmcv::LogSinkMappedFile>);
+
+TEST_F(MappedFileSinkFixture, test_writes_lines_and_trims_on_close)
+{
+	{
+		wmcv::LogSink sink{wmcv::LogSinkMappedFile{{.path = path, .segmentSize = 4096}}};
+		Log(sink, "first");
+		Log(sink, "second");
+	}
+
+	EXPECT_EQ(ReadFile(path), "first\nsecond\n");
+}
+
+TEST_F(MappedFileSinkFixture, test_records_are_written_with_their_header)
+{
+	static wmcv::LogCategory s_sinkTestLog{"SinkTest", wmcv::LogLevel::Trace};
+
+	wmcv::CreateDefaultLogSystem();
+	const wmcv::LogSinkHandle handle = wmcv::GetLogSystem().PushSink(wmcv::LogSinkMappedFile{{.path = path, .segmentSize = 4096}});
+	const uint32_t line = std::source_location::current().line() + 1;
+	wmcv::LogError(s_sinkTestLog, "texture {} missing", 7);
+	ASSERT_TRUE(wmcv::GetLogSystem().RemoveSink(handle));
+	wmcv::SetLogSystem(nullptr);
+
+	wmcv::FormatString expected;
+	wmcv::format(expected, "] [T{}] [error] [SinkTest] test_wmcv_sink_mappedfile.cpp:{} texture 7 missing\n", wmcv::GetLogThreadId(), line);
+	const std::string content = ReadFile(path);
+	ASSERT_FALSE(content.empty());
+	EXPECT_EQ(content.front(), '[');
+	EXPECT_TRUE(content.ends_with(expected.view())) << content;
+}
+
+TEST_F(MappedFileSinkFixture, test_rotates_and_keeps_retained_segments)
+{
+	{
+		// 5 eleven-byte lines fit in one segment.
+		wmcv::LogSinkMappedFile sink{{.path = path, .segmentSize = 64, .retainedSegments = 2}};
+		for (int i = 0; i < 20; ++i)
+		{
+			wmcv::FormatString line;
+			wmcv::format(line, "message {}", i + 10);
+			sink.Write(line.view());
+		}
+	}
+
+	EXPECT_EQ(ReadFile(path), "message 25\nmessage 26\nmessage 27\nmessage 28\nmessage 29\n");
+	EXPECT_EQ(ReadFile(wmcv::LogSegmentPath(path, 1)), "message 20\nmessage 21\nmessage 22\nmessage 23\nmessage 24\n");
+	EXPECT_EQ(ReadFile(wmcv::LogSegmentPath(path, 2)), "message 15\nmessage 16\nmessage 17\nmessage 18\nmessage 19\n");
+	EXPECT_FALSE(std::filesystem::exists(wmcv::LogSegmentPath(path, 3)));
+	EXPECT_EQ(wmcv::LogSegmentPath(path, 2).filename(), "app.2.log");
+}
+
+TEST_F(MappedFileSinkFixture, test_long_message_is_truncated_to_segment)
+{
+	{
+		wmcv::LogSinkMappedFile sink{{.path = path, .segmentSize = 16}};
+		sink.Write("0123456789abcdefghij");
+	}
+
+	EXPECT_EQ(ReadFile(path), "0123456789abcde\n");
+}
+
+TEST_F(MappedFileSinkFixture, test_concurrent_loggers_write_whole_lines)
+{
+	constexpr int ThreadCount = 8;
+	constexpr int PerThread = 2000;
+
+	wmcv::CreateDefaultLogSystem();
+	const wmcv::LogSinkHandle handle = wmcv::GetLogSystem().PushSink(wmcv::LogSinkMappedFile{{.path = path, .segmentSize = 4 * 1024 * 1024}});
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < ThreadCount; ++t)
+	{
+		threads.emplace_back([t]
+			{
+				for (int i = 0; i < PerThread; ++i)
+				{
+					wmcv::LogMessage("thread {} message {}", t, i);
+				}
+			});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	// Removing the sink destroys it, which trims the segment.
+	ASSERT_TRUE(wmcv::GetLogSystem().RemoveSink(handle));
+	wmcv::SetLogSystem(nullptr);
+
+	std::array<int, ThreadCount> next = {};
+	std::array<unsigned, ThreadCount> logThreadIds = {};
+	std::istringstream lines{ReadFile(path)};
+	std::string line;
+	int count = 0;
+	while (std::getline(lines, line))
+	{
+		unsigned logThreadId = 0;
+		int thread = -1;
+		int message = -1;
+		ASSERT_EQ(std::sscanf(line.c_str(), "[%*u.%*u] [T%u] [info] %*s thread %d message %d", &logThreadId, &thread, &message), 3) << line;
+		ASSERT_GE(thread, 0);
+		ASSERT_LT(thread, ThreadCount);
+		EXPECT_EQ(message, next[static_cast<size_t>(thread)]++);
+
+		unsigned& expectedId = logThreadIds[static_cast<size_t>(thread)];
+		expectedId = expectedId == 0 ? logThreadId : expectedId;
+		EXPECT_EQ(logThreadId, expectedId);
+		++count;
+	}
+	EXPECT_EQ(count, ThreadCount * PerThread);
+}
+
+TEST_F(MappedFileSinkFixture, test_failed_roll_drops_and_counts)
+{
+	wmcv::LogSinkMappedFile sink{{.path = path, .segmentSize = 16}};
+	sink.Write("0123456789");
+	EXPECT_EQ(sink.DroppedCount(), 0u);
+
+	// The next segment cannot be created once its directory is gone.
+	std::filesystem::remove_all(directory);
+	sink.Write("0123456789");
+	sink.Write("again");
+
+	EXPECT_FALSE(sink.IsOpen());
+	EXPECT_EQ(sink.DroppedCount(), 2u);
+}
+
+TEST_F(MappedFileSinkFixture, test_closed_sink_reopens_after_drops)
+{
+	wmcv::LogSinkMappedFile sink{{.path = path, .segmentSize = 16, .reopenAfterDrops = 2}};
+	sink.Write("0123456789");
+
+	std::filesystem::remove_all(directory);
+	sink.Write("0123456789");
+	sink.Write("lost");
+	EXPECT_FALSE(sink.IsOpen());
+
+	// Once the directory is back the next message reopens the segment.
+	std::filesystem::create_directories(directory);
+	sink.Write("back");
+	EXPECT_TRUE(sink.IsOpen());
+	EXPECT_EQ(sink.DroppedCount(), 2u);
+	sink.Flush();
+	EXPECT_EQ(ReadFile(path).substr(0, 5), "back\n");
+}
+
+TEST_F(MappedFileSinkFixture, test_recovers_crash_padding)
+{
+	{
+		// A crashed run leaves the segment at full size, zero-filled past the last write.
+		std::ofstream file{path, std::ios::binary};
+		const std::string content = "line one\nline two\n";
+		file.write(content.data(), static_cast<std::streamsize>(content.size()));
+		const std::string padding(1000, '\0');
+		file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+	}
+
+	{
+		wmcv::LogSinkMappedFile sink{{.path = path, .segmentSize = 4096}};
+		EXPECT_EQ(sink.Cursor(), 18u);
+		sink.Write("line three");
+	}
+
+	EXPECT_EQ(ReadFile(path), "line one\nline two\nline three\n");
+}
+
+TEST_F(MappedFileSinkFixture, test_recover_segment_trims_padding)
+{
+	{
+		std::ofstream file{path, std::ios::binary};
+		file.write("abc\n\0\0\0\0", 8);
+	}
+
+	EXPECT_EQ(wmcv::RecoverLogSegment(path), 4u);
+	EXPECT_EQ(std::filesystem::file_size(path), 4u);
+}
+
+TEST_F(MappedFileSinkFixture, test_full_recovered_segment_is_rotated)
+{
+	{
+		std::ofstream file{path, std::ios::binary};
+		file << std::string(31, 'x') << '\n';
+	}
+
+	{
+		wmcv::LogSinkMappedFile sink{{.path = path, .segmentSize = 32}};
+		sink.Write("fresh");
+	}
+
+	EXPECT_EQ(ReadFile(path), "fresh\n");
+	EXPECT_EQ(ReadFile(wmcv::LogSegmentPath(path, 1)).size(), 32u);
+}
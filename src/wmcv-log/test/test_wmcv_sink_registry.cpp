@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include "wmcv_log/wmcv_log.h"
+#include "wmcv_log/wmcv_async_log_system.h"
+
+namespace
+{
+
+struct CountingSink
+{
+	std::atomic<size_t>* count;
+};
+
+auto Log(CountingSink& sink, const std::string_view) noexcept -> void
+{
+	sink.count->fetch_add(1, std::memory_order_relaxed);
+}
+
+// Not thread-safe, and logs back into its registry from inside Log().
+struct ReentrantSink
+{
+	static constexpr bool SerializeLogCalls = true;
+
+	wmcv::LogSinkRegistry* registry;
+	size_t* count;
+};
+
+auto Log(ReentrantSink& sink, const std::string_view) noexcept -> void
+{
+	++*sink.count;
+	sink.registry->ForEach([](wmcv::LogSink& inner) { Log(inner, "from inside"); });
+}
+
+// Waits, up to a deadline, until two threads are inside it at once.
+struct RendezvousSink
+{
+	std::atomic<int>* inside;
+	std::atomic<bool>* met;
+};
+
+auto Log(RendezvousSink& sink, const std::string_view) noexcept -> void
+{
+	sink.inside->fetch_add(1);
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+	while (sink.inside->load() < 2 && std::chrono::steady_clock::now() < deadline)
+	{
+		std::this_thread::yield();
+	}
+	if (sink.inside->load() >= 2)
+	{
+		sink.met->store(true);
+	}
+}
+
+// Runs loggers against system while another thread keeps adding and removing
+// sinks; the permanent sink must see every message exactly once.
+void RunRegistrationStress(wmcv::LogSystem& system)
+{
+	constexpr int LoggerCount = 4;
+	constexpr int PerLogger = 5000;
+	constexpr int Churn = 200;
+
+	std::atomic<size_t> permanent = 0;
+	std::atomic<size_t> transient = 0;
+	system.PushSink(CountingSink{&permanent});
+
+	std::atomic<bool> go = false;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < LoggerCount; ++t)
+	{
+		threads.emplace_back([&]
+			{
+				while (!go.load(std::memory_order_acquire))
+				{
+					std::this_thread::yield();
+				}
+				for (int i = 0; i < PerLogger; ++i)
+				{
+					system.LogMessage("stress");
+				}
+			});
+	}
+
+	threads.emplace_back([&]
+		{
+			while (!go.load(std::memory_order_acquire))
+			{
+				std::this_thread::yield();
+			}
+			for (int i = 0; i < Churn; ++i)
+			{
+				const auto handle = system.PushSink(CountingSink{&transient});
+				std::this_thread::yield();
+				EXPECT_TRUE(system.RemoveSink(handle));
+			}
+		});
+
+	go.store(true, std::memory_order_release);
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	system.Flush();
+
+	EXPECT_EQ(permanent.load(), size_t{LoggerCount * PerLogger});
+	const size_t transientAfterChurn = transient.load();
+	system.LogMessage("after");
+	system.Flush();
+	EXPECT_EQ(transient.load(), transientAfterChurn);
+}
+
+} // namespace
+
+TEST(SinkRegistry, test_add_and_remove)
+{
+	std::atomic<size_t> first = 0;
+	std::atomic<size_t> second = 0;
+	wmcv::LogSinkRegistry registry;
+
+	const auto firstHandle = registry.Add(CountingSink{&first});
+	const auto secondHandle = registry.Add(CountingSink{&second});
+	EXPECT_NE(firstHandle, secondHandle);
+
+	registry.ForEach([](wmcv::LogSink& sink) { Log(sink, "both"); });
+	EXPECT_TRUE(registry.Remove(firstHandle));
+	EXPECT_FALSE(registry.Remove(firstHandle));
+	registry.ForEach([](wmcv::LogSink& sink) { Log(sink, "second only"); });
+
+	EXPECT_EQ(first.load(), 1u);
+	EXPECT_EQ(second.load(), 2u);
+
+	registry.Clear();
+	EXPECT_FALSE(registry.Remove(secondHandle));
+	registry.ForEach([](wmcv::LogSink& sink) { Log(sink, "none"); });
+	EXPECT_EQ(second.load(), 2u);
+}
+
+TEST(SinkRegistry, test_only_serialized_sinks_are_locked)
+{
+	static_assert(wmcv::IsSerializedLogSink<ReentrantSink>);
+	static_assert(!wmcv::IsSerializedLogSink<CountingSink>);
+
+	std::atomic<int> inside = 0;
+	std::atomic<bool> met = false;
+	wmcv::LogSinkRegistry registry;
+	registry.Add(RendezvousSink{&inside, &met});
+
+	std::thread other{[&registry] { registry.ForEach([](wmcv::LogSink& sink) { Log(sink, "other"); }); }};
+	registry.ForEach([](wmcv::LogSink& sink) { Log(sink, "this"); });
+	other.join();
+
+	EXPECT_TRUE(met.load());
+}
+
+TEST(SinkRegistry, test_logging_from_a_serialized_sink_skips_it)
+{
+	std::atomic<size_t> plain = 0;
+	size_t reentrant = 0;
+	wmcv::LogSinkRegistry registry;
+	registry.Add(ReentrantSink{&registry, &reentrant});
+	registry.Add(CountingSink{&plain});
+
+	registry.ForEach([](wmcv::LogSink& sink) { Log(sink, "outside"); });
+
+	// The nested message reaches only the plain sink.
+	EXPECT_EQ(reentrant, 1u);
+	EXPECT_EQ(plain.load(), 2u);
+}
+
+TEST(SinkRegistry, test_default_system_remove_sink)
+{
+	std::atomic<size_t> count = 0;
+	wmcv::CreateDefaultLogSystem();
+	const auto handle = wmcv::GetLogSystem().PushSink(CountingSink{&count});
+
+	wmcv::LogMessage("kept");
+	EXPECT_TRUE(wmcv::GetLogSystem().RemoveSink(handle));
+	wmcv::LogMessage("dropped");
+
+	EXPECT_EQ(count.load(), 1u);
+	wmcv::SetLogSystem(nullptr);
+}
+
+TEST(SinkRegistry, test_concurrent_registration_default_system)
+{
+	wmcv::CreateDefaultLogSystem();
+	RunRegistrationStress(wmcv::GetLogSystem());
+	wmcv::CreateDefaultLogSystem();
+	wmcv::SetLogSystem(nullptr);
+}
+
+TEST(SinkRegistry, test_concurrent_registration_async_system)
+{
+	wmcv::AsyncLogSystem system{{.capacity = 1024, .overflowPolicy = wmcv::LogOverflowPolicy::Block}};
+	RunRegistrationStress(system);
+}
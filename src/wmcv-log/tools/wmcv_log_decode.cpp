@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "wmcv_log/wmcv_deferred_log.h"
+
+// Renders a deferred binary log (see DeferredLogWriter::SaveToFile) as text.
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::fprintf(stderr, "usage: %s <deferred-log-file>\n", argv[0]);
+		return 1;
+	}
+
+	const auto bytes = wmcv::LoadDeferredLogFile(argv[1]);
+	if (bytes.empty())
+	{
+		std::fprintf(stderr, "%s: not a deferred log or empty\n", argv[1]);
+		return 1;
+	}
+
+	const auto result = wmcv::DecodeDeferredLog(bytes, [](std::string_view message)
+		{
+			std::fwrite(message.data(), 1, message.length(), stdout);
+			std::fputc('\n', stdout);
+		});
+
+	if (result.unknownFormats > 0 || result.truncated)
+	{
+		std::fprintf(stderr, "%zu messages, %zu with unknown formats%s\n", result.messages, result.unknownFormats, result.truncated ? ", stream truncated" : "");
+		return 2;
+	}
+
+	return 0;
+}
@@ -0,0 +1,58 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "wmcv_log/sinks/wmcv_sink_compressedfile.h"
+
+// Writes the text of a compressed log file to stdout, or to the given output
+// file. Damaged or partial blocks are skipped and reported on stderr.
+int main(int argc, char** argv)
+{
+	if (argc < 2 || argc > 3)
+	{
+		std::fprintf(stderr, "usage: %s <compressed-log> [output]\n", argv[0]);
+		return 1;
+	}
+
+	const auto bytes = wmcv::LoadCompressedLogFile(argv[1]);
+	if (bytes.empty())
+	{
+		std::fprintf(stderr, "%s: cannot read file\n", argv[1]);
+		return 1;
+	}
+
+	std::FILE* output = argc == 3 ? std::fopen(argv[2], "wb") : stdout;
+	if (!output)
+	{
+		std::fprintf(stderr, "%s: cannot open for writing\n", argv[2]);
+		return 1;
+	}
+
+	const auto result = wmcv::DecodeCompressedLog(bytes, [output](std::string_view text)
+		{
+			std::fwrite(text.data(), 1, text.size(), output);
+		});
+
+	if (output != stdout)
+	{
+		std::fclose(output);
+	}
+
+	if (result.skippedBytes > 0 || result.truncated)
+	{
+		std::fprintf(stderr, "%s: %zu blocks decoded, %zu bytes skipped%s\n", argv[1], result.blocks, result.skippedBytes, result.truncated ? ", last block truncated" : "");
+	}
+
+	return result.blocks > 0 ? 0 : 1;
+}
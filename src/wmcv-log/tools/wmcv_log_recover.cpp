@@ -0,0 +1,40 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "wmcv_log/sinks/wmcv_sink_flightrecorder.h"
+
+// Prints the records left in a flight recorder file, oldest first.
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::fprintf(stderr, "usage: %s <flight-recorder-file>\n", argv[0]);
+		return 1;
+	}
+
+	const auto bytes = wmcv::LoadFlightRecorderFile(argv[1]);
+	const bool valid = wmcv::ReadFlightRecorder(bytes, [](uint64_t sequence, std::string_view message)
+		{
+			std::printf("[%" PRIu64 "] %.*s\n", sequence, static_cast<int>(message.length()), message.data());
+		});
+
+	if (!valid)
+	{
+		std::fprintf(stderr, "%s: not a flight recorder file\n", argv[1]);
+		return 1;
+	}
+
+	return 0;
+}
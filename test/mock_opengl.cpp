@@ -0,0 +1,543 @@
+#include "pch.h"
+#include "mock_opengl.h"
+#include "gl_state.h"
+
+#include <gtest/gtest.h>
+
+namespace wmcv::test
+{
+
+namespace
+{
+
+MockOpenGL* s_current = nullptr;
+
+GLuint APIENTRY MockCreateShader(GLenum)
+{
+	MockOpenGL::current().record("glCreateShader");
+	return MockOpenGL::current().nextName++;
+}
+
+void APIENTRY MockShaderSource(GLuint, GLsizei, const GLchar* const*, const GLint*)
+{
+	MockOpenGL::current().record("glShaderSource");
+}
+
+void APIENTRY MockCompileShader(GLuint)
+{
+	MockOpenGL::current().record("glCompileShader");
+}
+
+void APIENTRY MockGetShaderiv(GLuint, GLenum, GLint* params)
+{
+	MockOpenGL::current().record("glGetShaderiv");
+	*params = GL_TRUE;
+}
+
+void APIENTRY MockGetShaderInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+	MockOpenGL::current().record("glGetShaderInfoLog");
+	if (length)
+		*length = 0;
+	if (bufSize > 0)
+		infoLog[0] = '\0';
+}
+
+void APIENTRY MockDeleteShader(GLuint)
+{
+	MockOpenGL::current().record("glDeleteShader");
+}
+
+GLuint APIENTRY MockCreateProgram()
+{
+	MockOpenGL::current().record("glCreateProgram");
+	return MockOpenGL::current().nextName++;
+}
+
+void APIENTRY MockAttachShader(GLuint, GLuint)
+{
+	MockOpenGL::current().record("glAttachShader");
+}
+
+void APIENTRY MockLinkProgram(GLuint)
+{
+	MockOpenGL::current().record("glLinkProgram");
+}
+
+void APIENTRY MockGetProgramiv(GLuint, GLenum pname, GLint* params)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glGetProgramiv");
+
+	switch (pname)
+	{
+	case GL_ACTIVE_UNIFORMS:
+		*params = static_cast<GLint>(gl.uniforms.size());
+		break;
+	case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+		*params = 1;
+		for (const MockUniform& uniform : gl.uniforms)
+			*params = std::max(*params, static_cast<GLint>(uniform.name.size() + 1));
+		break;
+	default:
+		*params = GL_TRUE;
+		break;
+	}
+}
+
+void APIENTRY MockGetProgramInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+	MockOpenGL::current().record("glGetProgramInfoLog");
+	if (length)
+		*length = 0;
+	if (bufSize > 0)
+		infoLog[0] = '\0';
+}
+
+void APIENTRY MockGetActiveUniform(GLuint, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glGetActiveUniform");
+
+	const MockUniform& uniform = gl.uniforms.at(index);
+	const size_t written = std::min(uniform.name.size(), static_cast<size_t>(std::max(bufSize - 1, 0)));
+	std::memcpy(name, uniform.name.data(), written);
+	name[written] = '\0';
+	*length = static_cast<GLsizei>(written);
+	*size = uniform.size;
+	*type = uniform.type;
+}
+
+GLint APIENTRY MockGetUniformLocation(GLuint, const GLchar* name)
+{
+	MockOpenGL::current().record("glGetUniformLocation");
+	return MockOpenGL::current().locationOf(name);
+}
+
+void APIENTRY MockDeleteProgram(GLuint)
+{
+	MockOpenGL::current().record("glDeleteProgram");
+}
+
+void APIENTRY MockUseProgram(GLuint program)
+{
+	MockOpenGL::current().record("glUseProgram");
+	MockOpenGL::current().program = program;
+}
+
+void APIENTRY MockActiveTexture(GLenum texture)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glActiveTexture");
+	if (texture < GL_TEXTURE0)
+		ADD_FAILURE() << "glActiveTexture takes GL_TEXTURE0 + unit, got " << texture;
+	gl.activeTextureUnit = texture - GL_TEXTURE0;
+}
+
+void APIENTRY MockBindTexture(GLenum, GLuint texture)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glBindTexture");
+	gl.boundTextures[gl.activeTextureUnit] = texture;
+}
+
+void APIENTRY MockUniform1i(GLint location, GLint v0)
+{
+	MockOpenGL::current().record("glUniform1i");
+	MockOpenGL::current().storeUniform(location, &v0, sizeof(v0));
+}
+
+void APIENTRY MockUniform1f(GLint location, GLfloat v0)
+{
+	MockOpenGL::current().record("glUniform1f");
+	MockOpenGL::current().storeUniform(location, &v0, sizeof(v0));
+}
+
+void APIENTRY MockUniform2fv(GLint location, GLsizei count, const GLfloat* value)
+{
+	MockOpenGL::current().record("glUniform2fv");
+	MockOpenGL::current().storeUniform(location, value, sizeof(GLfloat) * 2 * static_cast<size_t>(count));
+}
+
+void APIENTRY MockUniform3fv(GLint location, GLsizei count, const GLfloat* value)
+{
+	MockOpenGL::current().record("glUniform3fv");
+	MockOpenGL::current().storeUniform(location, value, sizeof(GLfloat) * 3 * static_cast<size_t>(count));
+}
+
+void APIENTRY MockUniform4fv(GLint location, GLsizei count, const GLfloat* value)
+{
+	MockOpenGL::current().record("glUniform4fv");
+	MockOpenGL::current().storeUniform(location, value, sizeof(GLfloat) * 4 * static_cast<size_t>(count));
+}
+
+void APIENTRY MockUniformMatrix2fv(GLint location, GLsizei count, GLboolean, const GLfloat* value)
+{
+	MockOpenGL::current().record("glUniformMatrix2fv");
+	MockOpenGL::current().storeUniform(location, value, sizeof(GLfloat) * 4 * static_cast<size_t>(count));
+}
+
+void APIENTRY MockUniformMatrix3fv(GLint location, GLsizei count, GLboolean, const GLfloat* value)
+{
+	MockOpenGL::current().record("glUniformMatrix3fv");
+	MockOpenGL::current().storeUniform(location, value, sizeof(GLfloat) * 9 * static_cast<size_t>(count));
+}
+
+void APIENTRY MockUniformMatrix4fv(GLint location, GLsizei count, GLboolean, const GLfloat* value)
+{
+	MockOpenGL::current().record("glUniformMatrix4fv");
+	MockOpenGL::current().storeUniform(location, value, sizeof(GLfloat) * 16 * static_cast<size_t>(count));
+}
+
+void APIENTRY MockGenBuffers(GLsizei n, GLuint* buffers)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glGenBuffers");
+	for (GLsizei i = 0; i < n; ++i)
+	{
+		buffers[i] = gl.nextName++;
+		gl.buffers[buffers[i]];
+	}
+}
+
+void APIENTRY MockDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glDeleteBuffers");
+	for (GLsizei i = 0; i < n; ++i)
+		gl.buffers.erase(buffers[i]);
+}
+
+void APIENTRY MockBindBuffer(GLenum target, GLuint buffer)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glBindBuffer");
+	gl.boundBuffers[target] = buffer;
+}
+
+void APIENTRY MockBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glBindBufferBase");
+	gl.bufferBases[{target, index}] = buffer;
+	gl.boundBuffers[target] = buffer;
+}
+
+void APIENTRY MockBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glBufferData");
+	std::vector<unsigned char>& buffer = gl.buffers.at(gl.boundBuffers.at(target));
+	buffer.assign(static_cast<size_t>(size), 0);
+	if (data)
+		std::memcpy(buffer.data(), data, buffer.size());
+}
+
+void APIENTRY MockBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glBufferSubData");
+	std::vector<unsigned char>& buffer = gl.buffers.at(gl.boundBuffers.at(target));
+	if (static_cast<size_t>(offset + size) > buffer.size())
+	{
+		ADD_FAILURE() << "glBufferSubData writes past the end of buffer " << gl.boundBuffers.at(target);
+		return;
+	}
+	std::memcpy(buffer.data() + offset, data, static_cast<size_t>(size));
+}
+
+void APIENTRY MockBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glBindBufferRange");
+	if (offset % gl.bufferOffsetAlignment != 0)
+		ADD_FAILURE() << "glBindBufferRange offset " << offset << " is not aligned";
+	gl.bufferRanges[{target, index}] = MockBufferRange{buffer, offset, size};
+	gl.boundBuffers[target] = buffer;
+}
+
+void APIENTRY MockBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glBufferStorage");
+	std::vector<unsigned char>& buffer = gl.buffers.at(gl.boundBuffers.at(target));
+	buffer.assign(static_cast<size_t>(size), 0);
+	if (data)
+		std::memcpy(buffer.data(), data, buffer.size());
+}
+
+// The mapping is the buffer's own storage, so it behaves as coherent.
+void* APIENTRY MockMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr, GLbitfield)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glMapBufferRange");
+	return gl.buffers.at(gl.boundBuffers.at(target)).data() + offset;
+}
+
+GLboolean APIENTRY MockUnmapBuffer(GLenum)
+{
+	MockOpenGL::current().record("glUnmapBuffer");
+	return GL_TRUE;
+}
+
+void APIENTRY MockGetIntegerv(GLenum pname, GLint* data)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glGetIntegerv");
+	switch (pname)
+	{
+	case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+	case GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT:
+		*data = gl.bufferOffsetAlignment;
+		break;
+	default:
+		*data = 0;
+		break;
+	}
+}
+
+void APIENTRY MockBindVertexArray(GLuint array)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glBindVertexArray");
+	gl.boundVertexArray = array;
+}
+
+void APIENTRY MockVertexAttribPointer(GLuint index, GLint size, GLenum, GLboolean, GLsizei stride, const void* pointer)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glVertexAttribPointer");
+	MockVertexAttribute& attribute = gl.attributes[{gl.boundVertexArray, index}];
+	attribute.size = size;
+	attribute.stride = stride;
+	attribute.offset = reinterpret_cast<uintptr_t>(pointer);
+	attribute.buffer = gl.boundBuffers[GL_ARRAY_BUFFER];
+	attribute.binding = index;
+}
+
+void APIENTRY MockVertexAttribFormat(GLuint index, GLint size, GLenum, GLboolean, GLuint relativeOffset)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glVertexAttribFormat");
+	MockVertexAttribute& attribute = gl.attributes[{gl.boundVertexArray, index}];
+	attribute.size = size;
+	attribute.offset = relativeOffset;
+}
+
+void APIENTRY MockVertexAttribBinding(GLuint index, GLuint binding)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glVertexAttribBinding");
+	gl.attributes[{gl.boundVertexArray, index}].binding = binding;
+}
+
+void APIENTRY MockVertexBindingDivisor(GLuint binding, GLuint divisor)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glVertexBindingDivisor");
+	gl.vertexBindings[{gl.boundVertexArray, binding}].divisor = divisor;
+}
+
+void APIENTRY MockBindVertexBuffer(GLuint binding, GLuint buffer, GLintptr offset, GLsizei stride)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glBindVertexBuffer");
+	MockVertexBinding& vertexBinding = gl.vertexBindings[{gl.boundVertexArray, binding}];
+	vertexBinding.buffer = buffer;
+	vertexBinding.offset = offset;
+	vertexBinding.stride = stride;
+}
+
+void APIENTRY MockEnableVertexAttribArray(GLuint index)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glEnableVertexAttribArray");
+	gl.attributes[{gl.boundVertexArray, index}].enabled = true;
+}
+
+void APIENTRY MockDrawArrays(GLenum, GLint, GLsizei)
+{
+	MockOpenGL::current().record("glDrawArrays");
+}
+
+void APIENTRY MockDrawArraysInstanced(GLenum, GLint, GLsizei, GLsizei)
+{
+	MockOpenGL::current().record("glDrawArraysInstanced");
+}
+
+void APIENTRY MockMultiDrawElementsIndirect(GLenum, GLenum, const void* indirect, GLsizei drawcount, GLsizei)
+{
+	MockOpenGL& gl = MockOpenGL::current();
+	gl.record("glMultiDrawElementsIndirect");
+	gl.indirectDraws.push_back(MockIndirectDraw{
+		gl.boundVertexArray,
+		gl.boundBuffers[GL_DRAW_INDIRECT_BUFFER],
+		reinterpret_cast<uintptr_t>(indirect),
+		drawcount});
+}
+
+struct MockEntry
+{
+	std::string_view name;
+	void* proc;
+};
+
+template <typename Fn>
+void* AsProc(Fn fn)
+{
+	return reinterpret_cast<void*>(fn);
+}
+
+const MockEntry s_entries[] = {
+	{"glCreateShader", AsProc(&MockCreateShader)},
+	{"glShaderSource", AsProc(&MockShaderSource)},
+	{"glCompileShader", AsProc(&MockCompileShader)},
+	{"glGetShaderiv", AsProc(&MockGetShaderiv)},
+	{"glGetShaderInfoLog", AsProc(&MockGetShaderInfoLog)},
+	{"glDeleteShader", AsProc(&MockDeleteShader)},
+	{"glCreateProgram", AsProc(&MockCreateProgram)},
+	{"glAttachShader", AsProc(&MockAttachShader)},
+	{"glLinkProgram", AsProc(&MockLinkProgram)},
+	{"glGetProgramiv", AsProc(&MockGetProgramiv)},
+	{"glGetProgramInfoLog", AsProc(&MockGetProgramInfoLog)},
+	{"glGetActiveUniform", AsProc(&MockGetActiveUniform)},
+	{"glGetUniformLocation", AsProc(&MockGetUniformLocation)},
+	{"glDeleteProgram", AsProc(&MockDeleteProgram)},
+	{"glUseProgram", AsProc(&MockUseProgram)},
+	{"glActiveTexture", AsProc(&MockActiveTexture)},
+	{"glBindTexture", AsProc(&MockBindTexture)},
+	{"glUniform1i", AsProc(&MockUniform1i)},
+	{"glUniform1f", AsProc(&MockUniform1f)},
+	{"glUniform2fv", AsProc(&MockUniform2fv)},
+	{"glUniform3fv", AsProc(&MockUniform3fv)},
+	{"glUniform4fv", AsProc(&MockUniform4fv)},
+	{"glUniformMatrix2fv", AsProc(&MockUniformMatrix2fv)},
+	{"glUniformMatrix3fv", AsProc(&MockUniformMatrix3fv)},
+	{"glUniformMatrix4fv", AsProc(&MockUniformMatrix4fv)},
+	{"glGenBuffers", AsProc(&MockGenBuffers)},
+	{"glDeleteBuffers", AsProc(&MockDeleteBuffers)},
+	{"glBindBuffer", AsProc(&MockBindBuffer)},
+	{"glBindBufferBase", AsProc(&MockBindBufferBase)},
+	{"glBufferData", AsProc(&MockBufferData)},
+	{"glBufferSubData", AsProc(&MockBufferSubData)},
+	{"glBindBufferRange", AsProc(&MockBindBufferRange)},
+	{"glBufferStorage", AsProc(&MockBufferStorage)},
+	{"glMapBufferRange", AsProc(&MockMapBufferRange)},
+	{"glUnmapBuffer", AsProc(&MockUnmapBuffer)},
+	{"glGetIntegerv", AsProc(&MockGetIntegerv)},
+	{"glBindVertexArray", AsProc(&MockBindVertexArray)},
+	{"glVertexAttribPointer", AsProc(&MockVertexAttribPointer)},
+	{"glEnableVertexAttribArray", AsProc(&MockEnableVertexAttribArray)},
+	{"glVertexAttribFormat", AsProc(&MockVertexAttribFormat)},
+	{"glVertexAttribBinding", AsProc(&MockVertexAttribBinding)},
+	{"glVertexBindingDivisor", AsProc(&MockVertexBindingDivisor)},
+	{"glBindVertexBuffer", AsProc(&MockBindVertexBuffer)},
+	{"glDrawArrays", AsProc(&MockDrawArrays)},
+	{"glDrawArraysInstanced", AsProc(&MockDrawArraysInstanced)},
+	{"glMultiDrawElementsIndirect", AsProc(&MockMultiDrawElementsIndirect)},
+};
+
+void* GetMockProcAddress(const char* name)
+{
+	for (const MockEntry& entry : s_entries)
+	{
+		if (entry.name == name)
+			return entry.proc;
+	}
+	return nullptr;
+}
+
+void* GetNullProcAddress(const char*)
+{
+	return nullptr;
+}
+
+} // namespace
+
+MockOpenGL::MockOpenGL()
+{
+	s_current = this;
+	wmcv::LoadOpenGLFunctions(&GetMockProcAddress);
+	// A fresh fake context has nothing bound.
+	wmcv::GetGLState().invalidate();
+}
+
+MockOpenGL::~MockOpenGL()
+{
+	wmcv::LoadOpenGLFunctions(&GetNullProcAddress);
+	s_current = nullptr;
+}
+
+MockOpenGL& MockOpenGL::current()
+{
+	return *s_current;
+}
+
+void MockOpenGL::addUniform(std::string name, GLenum type, GLint size)
+{
+	GLint location = static_cast<GLint>(locations.size());
+	if (size > 1 && name.ends_with("[0]"))
+	{
+		const std::string base = name.substr(0, name.size() - 3);
+		for (GLint i = 0; i < size; ++i)
+			locations.emplace(base + "[" + std::to_string(i) + "]", location++);
+	}
+	else
+	{
+		locations.emplace(name, location);
+	}
+
+	uniforms.push_back(MockUniform{std::move(name), type, size});
+}
+
+int MockOpenGL::calls(std::string_view function) const
+{
+	const auto it = m_calls.find(function);
+	return it != m_calls.end() ? it->second : 0;
+}
+
+int MockOpenGL::totalCalls() const
+{
+	int total = 0;
+	for (const auto& [function, count] : m_calls)
+		total += count;
+	return total;
+}
+
+void MockOpenGL::resetCalls()
+{
+	m_calls.clear();
+}
+
+GLint MockOpenGL::locationOf(std::string_view name) const
+{
+	const auto it = locations.find(name);
+	return it != locations.end() ? it->second : -1;
+}
+
+const std::vector<unsigned char>& MockOpenGL::bufferData(GLuint buffer) const
+{
+	return buffers.at(buffer);
+}
+
+GLuint MockOpenGL::boundBufferBase(GLenum target, GLuint index) const
+{
+	const auto it = bufferBases.find({target, index});
+	return it != bufferBases.end() ? it->second : 0;
+}
+
+void MockOpenGL::record(const char* function)
+{
+	auto it = m_calls.find(std::string_view{function});
+	if (it == m_calls.end())
+		it = m_calls.emplace(function, 0).first;
+	++it->second;
+}
+
+void MockOpenGL::storeUniform(GLint location, const void* data, size_t size)
+{
+	const auto* bytes = static_cast<const unsigned char*>(data);
+	m_uniformValues[location].assign(bytes, bytes + size);
+}
+
+} // namespace wmcv::test
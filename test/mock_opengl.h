@@ -0,0 +1,131 @@
+#ifndef MOCK_OPENGL_H_INCLUDED
+#define MOCK_OPENGL_H_INCLUDED
+
+#include "opengl_functions.h"
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace wmcv::test
+{
+
+struct MockUniform
+{
+	std::string name;
+	GLenum type = GL_FLOAT;
+	GLint size = 1;
+};
+
+// offset is the pointer given to glVertexAttribPointer, or the relative
+// offset given to glVertexAttribFormat. Attributes set up with a pointer read
+// through the binding that matches their index.
+struct MockVertexAttribute
+{
+	GLint size = 0;
+	GLsizei stride = 0;
+	uintptr_t offset = 0;
+	GLuint buffer = 0;
+	GLuint binding = 0;
+	bool enabled = false;
+};
+
+struct MockVertexBinding
+{
+	GLuint buffer = 0;
+	GLintptr offset = 0;
+	GLsizei stride = 0;
+	GLuint divisor = 0;
+};
+
+struct MockBufferRange
+{
+	GLuint buffer = 0;
+	GLintptr offset = 0;
+	GLsizeiptr size = 0;
+};
+
+struct MockIndirectDraw
+{
+	GLuint vertexArray = 0;
+	GLuint indirectBuffer = 0;
+	uintptr_t offset = 0;
+	GLsizei drawCount = 0;
+};
+
+// Points the gl* function table at an in-memory fake for its lifetime. Every
+// call is counted by function name and uniform uploads are recorded per
+// location, so tests can assert on driver traffic without a context.
+class MockOpenGL
+{
+public:
+	MockOpenGL();
+	~MockOpenGL();
+
+	MockOpenGL(const MockOpenGL&) = delete;
+	MockOpenGL& operator=(const MockOpenGL&) = delete;
+
+	// Uniforms reported by the next linked program, in active uniform order.
+	void addUniform(std::string name, GLenum type, GLint size = 1);
+
+	int calls(std::string_view function) const;
+	int totalCalls() const;
+	void resetCalls();
+
+	GLint locationOf(std::string_view name) const;
+
+	template <typename T>
+	T uniformValue(GLint location) const
+	{
+		T value{};
+		const auto it = m_uniformValues.find(location);
+		if (it != m_uniformValues.end() && it->second.size() == sizeof(T))
+			std::memcpy(&value, it->second.data(), sizeof(T));
+		return value;
+	}
+
+	// Contents of a buffer object as last written through glBufferData and
+	// glBufferSubData.
+	const std::vector<unsigned char>& bufferData(GLuint buffer) const;
+	GLuint boundBufferBase(GLenum target, GLuint index) const;
+
+	static MockOpenGL& current();
+
+	void record(const char* function);
+	void storeUniform(GLint location, const void* data, size_t size);
+
+	std::vector<MockUniform> uniforms;
+	std::map<std::string, GLint, std::less<>> locations;
+	GLuint nextName = 1;
+
+	std::map<GLenum, GLuint> boundBuffers;
+	std::map<std::pair<GLenum, GLuint>, GLuint> bufferBases;
+	std::unordered_map<GLuint, std::vector<unsigned char>> buffers;
+	std::map<std::pair<GLenum, GLuint>, MockBufferRange> bufferRanges;
+	// Reported for both uniform and shader storage offset alignment.
+	GLint bufferOffsetAlignment = 256;
+
+	GLuint program = 0;
+	GLuint activeTextureUnit = 0;
+	// GL_TEXTURE_2D binding per texture unit index.
+	std::map<GLuint, GLuint> boundTextures;
+
+	GLuint boundVertexArray = 0;
+	// Keyed by vertex array and attribute index.
+	std::map<std::pair<GLuint, GLuint>, MockVertexAttribute> attributes;
+	// Keyed by vertex array and binding index.
+	std::map<std::pair<GLuint, GLuint>, MockVertexBinding> vertexBindings;
+
+	std::vector<MockIndirectDraw> indirectDraws;
+
+private:
+	std::map<std::string, int, std::less<>> m_calls;
+	std::unordered_map<GLint, std::vector<unsigned char>> m_uniformValues;
+};
+
+} // namespace wmcv::test
+
+#endif // MOCK_OPENGL_H_INCLUDED
@@ -0,0 +1,176 @@
+#include "pch.h"
+#include "dynamic_ring_buffer.h"
+#include "mock_opengl.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+namespace
+{
+
+// Fences are numbered in insertion order; the fake GPU completes them in the
+// same order, either when told to or when the CPU blocks on one.
+class FakeFenceProvider final : public wmcv::FenceProvider
+{
+public:
+	wmcv::FenceHandle insert() override
+	{
+		const uintptr_t fence = ++m_inserted;
+		m_live.insert(fence);
+		return reinterpret_cast<wmcv::FenceHandle>(fence);
+	}
+
+	bool signaled(wmcv::FenceHandle fence) override { return id(fence) <= m_completed; }
+
+	void wait(wmcv::FenceHandle fence) override
+	{
+		waited.push_back(id(fence));
+		m_completed = std::max(m_completed, id(fence));
+	}
+
+	void release(wmcv::FenceHandle fence) override
+	{
+		if (m_live.erase(id(fence)) == 0)
+			ADD_FAILURE() << "fence " << id(fence) << " released twice";
+	}
+
+	void completeAll() { m_completed = m_inserted; }
+	size_t live() const { return m_live.size(); }
+
+	std::vector<uintptr_t> waited;
+
+private:
+	static uintptr_t id(wmcv::FenceHandle fence) { return reinterpret_cast<uintptr_t>(fence); }
+
+	uintptr_t m_inserted = 0;
+	uintptr_t m_completed = 0;
+	std::set<uintptr_t> m_live;
+};
+
+} // namespace
+
+TEST(FrameRegionRing, hands_out_aligned_offsets_inside_the_current_region)
+{
+	FakeFenceProvider fences;
+	wmcv::FrameRegionRing ring{1024, 3, fences};
+
+	for (uint32_t frame = 0; frame < 6; ++frame)
+	{
+		ring.beginFrame();
+		const size_t base = (frame % 3) * 1024;
+		EXPECT_EQ(ring.currentRegion(), frame % 3);
+		EXPECT_EQ(ring.allocate(100, 256), base);
+		EXPECT_EQ(ring.allocate(16, 256), base + 256);
+		EXPECT_EQ(ring.allocate(600, 16), base + 272);
+		EXPECT_EQ(ring.allocate(200, 16), wmcv::FrameRegionRing::INVALID_OFFSET);
+		EXPECT_EQ(ring.allocate(152, 1), base + 872);
+		EXPECT_EQ(ring.used(), 1024u);
+		ring.endFrame();
+		fences.completeAll();
+	}
+
+	EXPECT_EQ(ring.stats().frames, 6u);
+	EXPECT_EQ(ring.stats().stalls, 0u);
+	EXPECT_TRUE(fences.waited.empty());
+}
+
+TEST(FrameRegionRing, waits_for_the_gpu_before_reusing_a_region)
+{
+	FakeFenceProvider fences;
+	{
+		wmcv::FrameRegionRing ring{256, 3, fences};
+
+		// Three frames in flight fill the ring without waiting.
+		for (int frame = 0; frame < 3; ++frame)
+		{
+			ring.beginFrame();
+			ring.endFrame();
+		}
+		EXPECT_TRUE(fences.waited.empty());
+
+		// The fourth frame reuses region 0 and has to wait for frame 0's fence.
+		ring.beginFrame();
+		EXPECT_EQ(ring.currentRegion(), 0u);
+		ASSERT_EQ(fences.waited.size(), 1u);
+		EXPECT_EQ(fences.waited[0], 1u);
+		EXPECT_EQ(ring.stats().stalls, 1u);
+		ring.endFrame();
+
+		// Waiting on frame 0 does not retire frame 1, so the next one stalls as well.
+		ring.beginFrame();
+		EXPECT_EQ(fences.waited.back(), 2u);
+		ring.endFrame();
+
+		fences.completeAll();
+		ring.beginFrame();
+		ring.endFrame();
+		EXPECT_EQ(ring.stats().stalls, 2u);
+		EXPECT_EQ(fences.live(), 3u);
+	}
+
+	EXPECT_EQ(fences.live(), 0u);
+}
+
+TEST(DynamicRingBuffer, writes_land_in_the_mapped_buffer_of_the_current_frame)
+{
+	wmcv::test::MockOpenGL gl;
+	FakeFenceProvider fences;
+	wmcv::DynamicRingBuffer ring{4096, 2, fences};
+
+	ASSERT_EQ(gl.bufferData(ring.bufferId()).size(), 8192u);
+
+	for (uint32_t frame = 0; frame < 4; ++frame)
+	{
+		ring.beginFrame();
+		const std::array<float, 4> transforms{1.f, 2.f, 3.f, static_cast<float>(frame)};
+		const std::array<uint32_t, 3> lights{frame, frame + 1, frame + 2};
+		const wmcv::DynamicAllocation first = ring.write(std::span<const float>{transforms});
+		const wmcv::DynamicAllocation second = ring.write(std::span<const uint32_t>{lights});
+		ring.bindRange(GL_SHADER_STORAGE_BUFFER, 0, second);
+		ring.endFrame();
+		fences.completeAll();
+
+		ASSERT_TRUE(first.valid());
+		ASSERT_TRUE(second.valid());
+		EXPECT_EQ(first.offset, (frame % 2) * 4096u);
+		EXPECT_EQ(second.offset, first.offset + 256u);
+
+		const std::vector<unsigned char>& bytes = gl.bufferData(ring.bufferId());
+		float lastTransform = 0.f;
+		std::memcpy(&lastTransform, bytes.data() + first.offset + 3 * sizeof(float), sizeof(float));
+		EXPECT_EQ(lastTransform, static_cast<float>(frame));
+
+		const wmcv::test::MockBufferRange& range = gl.bufferRanges[{GL_SHADER_STORAGE_BUFFER, 0}];
+		EXPECT_EQ(range.buffer, ring.bufferId());
+		EXPECT_EQ(static_cast<size_t>(range.offset), second.offset);
+		EXPECT_EQ(static_cast<size_t>(range.size), sizeof(lights));
+	}
+
+	// Everything went through the mapping.
+	EXPECT_EQ(gl.calls("glBufferData"), 0);
+	EXPECT_EQ(gl.calls("glBufferSubData"), 0);
+	EXPECT_EQ(gl.calls("glMapBufferRange"), 1);
+
+	ring.beginFrame();
+	EXPECT_FALSE(ring.allocate(8192).valid());
+}
+
+TEST(DynamicRingBuffer, a_region_sized_for_its_allocations_fits_them_at_any_alignment)
+{
+	const size_t regionSize = wmcv::DynamicRingBuffer::RegionSizeFor({128, 20 * 1000, 100 * 1000, 1});
+	for (const GLint alignment : {1, 64, 256})
+	{
+		wmcv::test::MockOpenGL gl;
+		gl.bufferOffsetAlignment = alignment;
+		FakeFenceProvider fences;
+		wmcv::DynamicRingBuffer ring{regionSize, 2, fences};
+
+		ring.beginFrame();
+		EXPECT_TRUE(ring.allocate(128).valid());
+		EXPECT_TRUE(ring.allocate(20 * 1000).valid());
+		EXPECT_TRUE(ring.allocate(100 * 1000).valid());
+		EXPECT_TRUE(ring.allocate(1).valid());
+		ring.endFrame();
+	}
+}
@@ -0,0 +1,88 @@
+#include "pch.h"
+#include "frustum_culling.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace
+{
+
+// Camera at the origin looking down -z, seeing from 0.1 to 100.
+wmcv::Frustum MakeCameraFrustum()
+{
+	const glm::mat4 projection = glm::perspective(glm::radians(90.f), 1.f, 0.1f, 100.f);
+	const glm::mat4 view = glm::lookAt(glm::vec3{0.f}, glm::vec3{0.f, 0.f, -1.f}, glm::vec3{0.f, 1.f, 0.f});
+	return wmcv::ExtractFrustum(projection * view);
+}
+
+} // namespace
+
+TEST(FrustumCulling, boxes_are_tested_against_every_plane)
+{
+	wmcv::CullingBounds bounds;
+	bounds.add({0.f, 0.f, -10.f}, glm::vec3{1.f});	// in front
+	bounds.add({0.f, 0.f, 10.f}, glm::vec3{1.f});	// behind
+	bounds.add({50.f, 0.f, -10.f}, glm::vec3{1.f});	// off to the right
+	bounds.add({0.f, 0.f, -200.f}, glm::vec3{1.f});	// past the far plane
+	bounds.add({10.5f, 0.f, -10.f}, glm::vec3{1.f});	// straddling the right plane
+	bounds.add({0.f, -20.f, -10.f}, glm::vec3{1.f});	// below
+
+	std::vector<uint32_t> visible{42};
+	wmcv::CullFrustum(MakeCameraFrustum(), bounds, visible, wmcv::CullingPath::Scalar);
+	EXPECT_EQ(visible, (std::vector<uint32_t>{0, 4}));
+}
+
+TEST(FrustumCulling, every_path_agrees_with_the_scalar_path)
+{
+	// Not a multiple of the lane count, so the last lanes are padding.
+	constexpr size_t COUNT = 10'003;
+
+	std::mt19937 random{7};
+	std::uniform_real_distribution<float> position{-150.f, 150.f};
+	std::uniform_real_distribution<float> size{0.f, 5.f};
+
+	wmcv::CullingBounds bounds;
+	bounds.reserve(COUNT);
+	for (size_t i = 0; i < COUNT; ++i)
+	{
+		const glm::vec3 center{position(random), position(random), position(random)};
+		bounds.add(center, glm::vec3{size(random), size(random), size(random)});
+	}
+
+	const wmcv::Frustum frustum = MakeCameraFrustum();
+	std::vector<uint32_t> expected;
+	wmcv::CullFrustum(frustum, bounds, expected, wmcv::CullingPath::Scalar);
+	ASSERT_FALSE(expected.empty());
+	ASSERT_LT(expected.size(), COUNT);
+
+	for (const wmcv::CullingPath path : {wmcv::CullingPath::SSE, wmcv::CullingPath::AVX})
+	{
+		if (!wmcv::CullingPathSupported(path))
+			continue;
+
+		std::vector<uint32_t> visible;
+		wmcv::CullFrustum(frustum, bounds, visible, path);
+		EXPECT_EQ(visible, expected) << "path " << static_cast<int>(path);
+	}
+}
+
+TEST(FrustumCulling, transformed_boxes_enclose_the_rotated_box)
+{
+	glm::mat4 model = glm::translate(glm::mat4{1.f}, glm::vec3{1.f, 2.f, 3.f});
+	model = glm::rotate(model, glm::radians(45.f), glm::vec3{0.f, 0.f, 1.f});
+	model = glm::scale(model, glm::vec3{2.f});
+
+	wmcv::CullingBounds bounds;
+	const uint32_t index = bounds.addTransformedBox(model, glm::vec3{0.5f});
+	EXPECT_EQ(bounds.size(), 1u);
+
+	const glm::vec3 center = bounds.boxCenter(index);
+	const glm::vec3 extents = bounds.boxExtents(index);
+	EXPECT_FLOAT_EQ(center.x, 1.f);
+	EXPECT_FLOAT_EQ(center.y, 2.f);
+	EXPECT_FLOAT_EQ(center.z, 3.f);
+	EXPECT_FLOAT_EQ(extents.x, std::sqrt(2.f));
+	EXPECT_FLOAT_EQ(extents.y, std::sqrt(2.f));
+	EXPECT_FLOAT_EQ(extents.z, 1.f);
+}
@@ -0,0 +1,127 @@
+#include "pch.h"
+#include "gl_state.h"
+#include "render_commands.h"
+#include "mock_opengl.h"
+
+#include <gtest/gtest.h>
+
+TEST(GLStateCache, redundant_program_and_vertex_array_binds_are_elided)
+{
+	wmcv::test::MockOpenGL gl;
+	wmcv::GLStateCache state;
+
+	state.useProgram(3);
+	state.useProgram(3);
+	state.bindVertexArray(7);
+	state.bindVertexArray(7);
+	state.bindVertexArray(8);
+
+	EXPECT_EQ(gl.calls("glUseProgram"), 1);
+	EXPECT_EQ(gl.calls("glBindVertexArray"), 2);
+	EXPECT_EQ(gl.program, 3u);
+	EXPECT_EQ(gl.boundVertexArray, 8u);
+	EXPECT_EQ(state.stats().issued, 3u);
+	EXPECT_EQ(state.stats().elided, 2u);
+
+	state.resetStats();
+	EXPECT_EQ(state.stats().issued, 0u);
+	EXPECT_EQ(state.stats().elided, 0u);
+}
+
+TEST(GLStateCache, textures_are_tracked_per_unit)
+{
+	wmcv::test::MockOpenGL gl;
+	wmcv::GLStateCache state;
+
+	state.bindTexture(0, 10);
+	state.bindTexture(1, 11);
+	state.bindTexture(2, 12);
+	EXPECT_EQ(gl.calls("glActiveTexture"), 3);
+	EXPECT_EQ(gl.calls("glBindTexture"), 3);
+
+	// Already bound, so neither the unit nor the binding changes.
+	gl.resetCalls();
+	state.bindTexture(0, 10);
+	state.bindTexture(1, 11);
+	state.bindTexture(2, 12);
+	EXPECT_EQ(gl.totalCalls(), 0);
+
+	state.bindTexture(2, 0);
+	state.bindTexture(1, 13);
+	EXPECT_EQ(gl.calls("glActiveTexture"), 1);
+	EXPECT_EQ(gl.calls("glBindTexture"), 2);
+	EXPECT_EQ(gl.boundTextures[0], 10u);
+	EXPECT_EQ(gl.boundTextures[1], 13u);
+	EXPECT_EQ(gl.boundTextures[2], 0u);
+}
+
+#ifndef NDEBUG
+TEST(GLStateCache, texture_units_past_the_limit_assert)
+{
+	wmcv::test::MockOpenGL gl;
+	wmcv::GLStateCache state;
+	EXPECT_DEATH(state.bindTexture(wmcv::GLStateCache::MAX_TEXTURE_UNITS, 1), "");
+}
+#endif
+
+TEST(GLStateCache, forgotten_names_are_bound_again)
+{
+	wmcv::test::MockOpenGL gl;
+	wmcv::GLStateCache state;
+
+	state.useProgram(5);
+	state.bindVertexArray(6);
+	state.bindTexture(3, 7);
+
+	// The driver may hand the same names out again after a delete.
+	state.forgetProgram(5);
+	state.forgetVertexArray(6);
+	state.forgetTexture(7);
+	gl.resetCalls();
+	state.useProgram(5);
+	state.bindVertexArray(6);
+	state.bindTexture(3, 7);
+	EXPECT_EQ(gl.calls("glUseProgram"), 1);
+	EXPECT_EQ(gl.calls("glBindVertexArray"), 1);
+	EXPECT_EQ(gl.calls("glBindTexture"), 1);
+
+	state.invalidate();
+	gl.resetCalls();
+	state.useProgram(5);
+	EXPECT_EQ(gl.calls("glUseProgram"), 1);
+}
+
+TEST(GLStateCache, a_repeated_frame_issues_no_binds)
+{
+	wmcv::test::MockOpenGL gl;
+	wmcv::GLStateCache& state = wmcv::GetGLState();
+	wmcv::RenderCommandBuffer commands;
+
+	const auto drawFrame = [&]
+	{
+		state.resetStats();
+		commands.push(0, wmcv::DrawArraysInstancedCommand{1, 0, 36, 10});
+		commands.push(1, wmcv::DrawArraysInstancedCommand{2, 0, 36, 4});
+
+		state.useProgram(1);
+		state.bindTexture(0, 20);
+		state.bindTexture(1, 21);
+		wmcv::ExecuteRenderCommand(commands.commands()[0]);
+		state.useProgram(2);
+		wmcv::ExecuteRenderCommand(commands.commands()[1]);
+		commands.reset();
+	};
+
+	drawFrame();
+	EXPECT_EQ(state.stats().issued, 8u);
+
+	gl.resetCalls();
+	drawFrame();
+	// Only the program and vertex array switches between the two draws remain.
+	EXPECT_EQ(gl.calls("glUseProgram"), 2);
+	EXPECT_EQ(gl.calls("glBindVertexArray"), 2);
+	EXPECT_EQ(gl.calls("glBindTexture"), 0);
+	EXPECT_EQ(gl.calls("glActiveTexture"), 0);
+	EXPECT_EQ(state.stats().issued, 4u);
+	EXPECT_EQ(state.stats().elided, 2u);
+}
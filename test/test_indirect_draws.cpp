@@ -0,0 +1,148 @@
+#include "pch.h"
+#include "indirect_draws.h"
+#include "dynamic_ring_buffer.h"
+#include "render_commands.h"
+#include "mock_opengl.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+constexpr wmcv::MeshRange CUBE{36, 0, 0};
+constexpr wmcv::MeshRange SPHERE{960, 36, 24};
+constexpr wmcv::MeshRange QUAD{6, 996, 504};
+
+wmcv::MeshInstance At(float x)
+{
+	return wmcv::MakeMeshInstance(glm::translate(glm::mat4{1.f}, glm::vec3{x, 0.f, 0.f}));
+}
+
+float XOf(const wmcv::MeshInstance& instance)
+{
+	return instance.model[3][0];
+}
+
+// The test GPU never falls behind.
+class ImmediateFenceProvider final : public wmcv::FenceProvider
+{
+public:
+	wmcv::FenceHandle insert() override { return nullptr; }
+	bool signaled(wmcv::FenceHandle) override { return true; }
+	void wait(wmcv::FenceHandle) override {}
+	void release(wmcv::FenceHandle) override {}
+};
+
+} // namespace
+
+TEST(IndirectDrawBuilder, consecutive_draws_of_a_mesh_share_a_command)
+{
+	wmcv::IndirectDrawBuilder draws;
+	draws.add(CUBE, At(0.f));
+	draws.add(CUBE, std::vector{At(1.f), At(2.f)});
+	draws.add(SPHERE, At(3.f));
+	draws.add(CUBE, At(4.f));
+	draws.add(QUAD, std::span<const wmcv::MeshInstance>{});
+
+	const auto commands = draws.commands();
+	ASSERT_EQ(commands.size(), 3u);
+
+	EXPECT_EQ(commands[0].count, 36u);
+	EXPECT_EQ(commands[0].instanceCount, 3u);
+	EXPECT_EQ(commands[0].baseInstance, 0u);
+
+	EXPECT_EQ(commands[1].count, 960u);
+	EXPECT_EQ(commands[1].firstIndex, 36u);
+	EXPECT_EQ(commands[1].baseVertex, 24);
+	EXPECT_EQ(commands[1].instanceCount, 1u);
+	EXPECT_EQ(commands[1].baseInstance, 3u);
+
+	EXPECT_EQ(commands[2].instanceCount, 1u);
+	EXPECT_EQ(commands[2].baseInstance, 4u);
+
+	// baseInstance + gl_InstanceID indexes the instance stream.
+	ASSERT_EQ(draws.instances().size(), 5u);
+	for (const wmcv::DrawElementsIndirectCommand& command : commands)
+	{
+		for (uint32_t i = 0; i < command.instanceCount; ++i)
+			EXPECT_EQ(XOf(draws.instances()[command.baseInstance + i]), static_cast<float>(command.baseInstance + i));
+	}
+
+	draws.reset();
+	EXPECT_TRUE(draws.commands().empty());
+	EXPECT_TRUE(draws.instances().empty());
+}
+
+TEST(IndirectDrawBuilder, build_gives_one_command_per_mesh_in_use)
+{
+	const std::array meshes{CUBE, SPHERE, QUAD};
+	std::vector<uint32_t> objectMeshes;
+	std::vector<wmcv::MeshInstance> objectInstances;
+	for (uint32_t object = 0; object < 1000; ++object)
+	{
+		// No quads, and cubes and spheres interleaved.
+		objectMeshes.push_back(object % 3 == 0 ? 1u : 0u);
+		objectInstances.push_back(At(static_cast<float>(object)));
+	}
+
+	wmcv::IndirectDrawBuilder draws;
+	draws.build(meshes, objectMeshes, objectInstances);
+
+	const auto commands = draws.commands();
+	ASSERT_EQ(commands.size(), 2u);
+	EXPECT_EQ(commands[0].count, CUBE.indexCount);
+	EXPECT_EQ(commands[0].instanceCount, 666u);
+	EXPECT_EQ(commands[0].baseInstance, 0u);
+	EXPECT_EQ(commands[1].count, SPHERE.indexCount);
+	EXPECT_EQ(commands[1].instanceCount, 334u);
+	EXPECT_EQ(commands[1].baseInstance, 666u);
+
+	// Objects keep their relative order within a mesh.
+	const auto instances = draws.instances();
+	EXPECT_EQ(XOf(instances[0]), 1.f);
+	EXPECT_EQ(XOf(instances[1]), 2.f);
+	EXPECT_EQ(XOf(instances[2]), 4.f);
+	EXPECT_EQ(XOf(instances[666]), 0.f);
+	EXPECT_EQ(XOf(instances[667]), 3.f);
+	EXPECT_EQ(XOf(instances[999]), 999.f);
+}
+
+TEST(IndirectDrawBuilder, a_pass_is_submitted_as_one_multi_draw)
+{
+	wmcv::test::MockOpenGL gl;
+	ImmediateFenceProvider fences;
+	wmcv::DynamicRingBuffer frameData{4096, 2, fences};
+
+	wmcv::IndirectDrawBuilder draws;
+	draws.add(CUBE, std::vector(100, At(1.f)));
+	draws.add(SPHERE, std::vector(20, At(2.f)));
+
+	frameData.beginFrame();
+	frameData.allocate(64);
+	const wmcv::DynamicAllocation commands = frameData.write(draws.commands());
+	ASSERT_TRUE(commands.valid());
+
+	wmcv::RenderCommandBuffer buffer;
+	buffer.push(0, wmcv::MultiDrawElementsIndirectCommand{
+		.vertexArray = 9,
+		.indirectBuffer = frameData.bufferId(),
+		.indirectOffset = commands.offset,
+		.drawCount = static_cast<int32_t>(draws.commands().size())});
+	for (const wmcv::RenderCommandEntry& entry : buffer.commands())
+		wmcv::ExecuteRenderCommand(entry);
+	frameData.endFrame();
+
+	ASSERT_EQ(gl.indirectDraws.size(), 1u);
+	const wmcv::test::MockIndirectDraw& draw = gl.indirectDraws[0];
+	EXPECT_EQ(draw.vertexArray, 9u);
+	EXPECT_EQ(draw.indirectBuffer, frameData.bufferId());
+	EXPECT_EQ(draw.offset, commands.offset);
+	EXPECT_EQ(draw.drawCount, 2);
+
+	std::array<wmcv::DrawElementsIndirectCommand, 2> written;
+	std::memcpy(written.data(), gl.bufferData(frameData.bufferId()).data() + draw.offset, sizeof(written));
+	EXPECT_EQ(written[0].instanceCount, 100u);
+	EXPECT_EQ(written[1].instanceCount, 20u);
+	EXPECT_EQ(written[1].baseInstance, 100u);
+	EXPECT_EQ(written[1].firstIndex, SPHERE.firstIndex);
+}
@@ -0,0 +1,110 @@
+#include "pch.h"
+#include "instance_buffer.h"
+#include "dynamic_ring_buffer.h"
+#include "mock_opengl.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+constexpr GLuint VERTEX_ARRAY = 42;
+
+bool NearlyEqual(const glm::vec3& a, const glm::vec3& b)
+{
+	return glm::length(a - b) < 1e-5f;
+}
+
+// The test GPU never falls behind.
+class ImmediateFenceProvider final : public wmcv::FenceProvider
+{
+public:
+	wmcv::FenceHandle insert() override { return nullptr; }
+	bool signaled(wmcv::FenceHandle) override { return true; }
+	void wait(wmcv::FenceHandle) override {}
+	void release(wmcv::FenceHandle) override {}
+};
+
+} // namespace
+
+TEST(InstanceAttributes, model_and_normal_matrices_read_one_instance_binding)
+{
+	wmcv::test::MockOpenGL gl;
+	wmcv::SetupInstanceAttributes(VERTEX_ARRAY);
+
+	for (GLuint column = 0; column < 4; ++column)
+	{
+		const wmcv::test::MockVertexAttribute& attribute = gl.attributes[{VERTEX_ARRAY, wmcv::INSTANCE_MODEL_ATTRIBUTE + column}];
+		EXPECT_TRUE(attribute.enabled);
+		EXPECT_EQ(attribute.size, 4);
+		EXPECT_EQ(attribute.offset, column * sizeof(glm::vec4));
+		EXPECT_EQ(attribute.binding, wmcv::INSTANCE_BINDING);
+	}
+
+	for (GLuint column = 0; column < 3; ++column)
+	{
+		const wmcv::test::MockVertexAttribute& attribute = gl.attributes[{VERTEX_ARRAY, wmcv::INSTANCE_NORMAL_ATTRIBUTE + column}];
+		EXPECT_TRUE(attribute.enabled);
+		EXPECT_EQ(attribute.size, 3);
+		EXPECT_EQ(attribute.offset, sizeof(glm::mat4) + column * sizeof(glm::vec3));
+		EXPECT_EQ(attribute.binding, wmcv::INSTANCE_BINDING);
+	}
+
+	EXPECT_EQ((gl.vertexBindings[{VERTEX_ARRAY, wmcv::INSTANCE_BINDING}].divisor), 1u);
+	EXPECT_EQ(gl.boundVertexArray, 0u);
+}
+
+TEST(InstanceAttributes, a_frame_streams_instances_from_the_ring_without_buffer_uploads)
+{
+	wmcv::test::MockOpenGL gl;
+	ImmediateFenceProvider fences;
+	wmcv::DynamicRingBuffer frameData{4 * 1024 * 1024, 2, fences};
+	wmcv::SetupInstanceAttributes(VERTEX_ARRAY);
+
+	std::vector<wmcv::MeshInstance> field;
+	field.reserve(10'000);
+	for (int i = 0; i < 10'000; ++i)
+	{
+		const glm::vec3 position{static_cast<float>(i % 100), static_cast<float>(i / 100), 0.f};
+		field.push_back(wmcv::MakeMeshInstance(glm::translate(glm::mat4{1.f}, position)));
+	}
+
+	gl.resetCalls();
+	for (int frame = 0; frame < 3; ++frame)
+	{
+		frameData.beginFrame();
+		frameData.allocate(64);
+		const wmcv::DynamicAllocation instances = frameData.write(std::span<const wmcv::MeshInstance>{field});
+		ASSERT_TRUE(instances.valid());
+		wmcv::BindInstanceStream(VERTEX_ARRAY, frameData.bufferId(), instances.offset);
+
+		const wmcv::test::MockVertexBinding& binding = gl.vertexBindings[{VERTEX_ARRAY, wmcv::INSTANCE_BINDING}];
+		EXPECT_EQ(binding.buffer, frameData.bufferId());
+		EXPECT_EQ(binding.offset, static_cast<GLintptr>(instances.offset));
+		EXPECT_EQ(binding.stride, static_cast<GLsizei>(sizeof(wmcv::MeshInstance)));
+
+		wmcv::MeshInstance last;
+		std::memcpy(&last, gl.bufferData(frameData.bufferId()).data() + instances.offset + (field.size() - 1) * sizeof(wmcv::MeshInstance), sizeof(last));
+		EXPECT_EQ(last.model, field.back().model);
+		frameData.endFrame();
+	}
+
+	EXPECT_EQ(gl.calls("glBufferData"), 0);
+	EXPECT_EQ(gl.calls("glBufferSubData"), 0);
+}
+
+TEST(MeshInstance, normal_matrix_is_the_inverse_transpose_of_the_model)
+{
+	glm::mat4 model = glm::translate(glm::mat4{1.f}, glm::vec3{5.f, -2.f, 1.f});
+	model = glm::rotate(model, glm::radians(30.f), glm::vec3{0.f, 1.f, 0.f});
+	model = glm::scale(model, glm::vec3{4.f, 1.f, 1.f});
+	const wmcv::MeshInstance instance = wmcv::MakeMeshInstance(model);
+
+	// A normal stays perpendicular to the transformed surface under non-uniform scale.
+	const glm::vec3 tangent = glm::vec3{model * glm::vec4{1.f, 1.f, 0.f, 0.f}};
+	const glm::vec3 normal = instance.normal * glm::vec3{1.f, -1.f, 0.f};
+	EXPECT_NEAR(glm::dot(tangent, normal), 0.f, 1e-5f);
+
+	const wmcv::MeshInstance rigid = wmcv::MakeMeshInstance(glm::rotate(glm::mat4{1.f}, 1.f, glm::vec3{0.f, 0.f, 1.f}));
+	EXPECT_TRUE(NearlyEqual(rigid.normal * glm::vec3{1.f, 0.f, 0.f}, glm::vec3{glm::cos(1.f), glm::sin(1.f), 0.f}));
+}
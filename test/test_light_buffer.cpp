@@ -0,0 +1,62 @@
+#include "pch.h"
+#include "light_buffer.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+wmcv::PointLight MakeLight(int i)
+{
+	const auto f = static_cast<float>(i);
+	return wmcv::PointLight{
+		.position = glm::vec4{f, -f, 2.f * f, 1.f},
+		.ambient = glm::vec4{0.05f},
+		.diffuse = glm::vec4{0.8f},
+		.specular = glm::vec4{1.f},
+		.constant = 1.f,
+		.linear = 0.09f,
+		.quadratic = 0.032f * f,
+		.padding = 0.f};
+}
+
+wmcv::PointLight ReadLight(std::span<const std::byte> bytes, size_t index)
+{
+	wmcv::PointLight light;
+	std::memcpy(&light, bytes.data() + sizeof(wmcv::PointLightBufferHeader) + index * sizeof(wmcv::PointLight), sizeof(light));
+	return light;
+}
+
+uint32_t ReadCount(std::span<const std::byte> bytes)
+{
+	uint32_t count = 0;
+	std::memcpy(&count, bytes.data(), sizeof(count));
+	return count;
+}
+
+} // namespace
+
+TEST(PointLightBuffer, writes_the_count_then_the_lights)
+{
+	std::vector<wmcv::PointLight> lights;
+	for (int i = 0; i < 500; ++i)
+		lights.push_back(MakeLight(i));
+
+	std::vector<std::byte> bytes(wmcv::PointLightBufferSize(lights.size()));
+	ASSERT_EQ(bytes.size(), sizeof(wmcv::PointLightBufferHeader) + 500 * sizeof(wmcv::PointLight));
+	wmcv::WritePointLightBuffer(lights, bytes.data());
+
+	EXPECT_EQ(ReadCount(bytes), 500u);
+	EXPECT_EQ(ReadLight(bytes, 3).position, (glm::vec4{3.f, -3.f, 6.f, 1.f}));
+	EXPECT_EQ(ReadLight(bytes, 3).quadratic, 0.032f * 3.f);
+	for (size_t i = 0; i < lights.size(); i += 37)
+		EXPECT_EQ(ReadLight(bytes, i).position, lights[i].position);
+}
+
+TEST(PointLightBuffer, an_empty_frame_is_just_the_header)
+{
+	std::vector<std::byte> bytes(wmcv::PointLightBufferSize(0), std::byte{0xff});
+	ASSERT_EQ(bytes.size(), sizeof(wmcv::PointLightBufferHeader));
+	wmcv::WritePointLightBuffer({}, bytes.data());
+	EXPECT_EQ(ReadCount(bytes), 0u);
+}
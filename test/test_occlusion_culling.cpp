@@ -0,0 +1,142 @@
+#include "pch.h"
+#include "occlusion_culling.h"
+#include "frustum_culling.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace
+{
+
+// Camera at the origin looking down -z, seeing from 0.1 to 100.
+glm::mat4 MakeViewProjection()
+{
+	const glm::mat4 projection = glm::perspective(glm::radians(90.f), 2.f, 0.1f, 100.f);
+	const glm::mat4 view = glm::lookAt(glm::vec3{0.f}, glm::vec3{0.f, 0.f, -1.f}, glm::vec3{0.f, 1.f, 0.f});
+	return projection * view;
+}
+
+// A 4 x 4 wall, 10 in front of the camera.
+void AddWall(wmcv::OcclusionBuffer& buffer)
+{
+	const glm::mat4 model = glm::translate(glm::mat4{1.f}, glm::vec3{0.f, 0.f, -10.f});
+	buffer.addOccluderBox(model, glm::vec3{2.f, 2.f, 0.1f});
+}
+
+} // namespace
+
+TEST(OcclusionBuffer, boxes_behind_an_occluder_are_culled)
+{
+	wmcv::OcclusionBuffer buffer{128, 64};
+	buffer.begin(MakeViewProjection());
+	AddWall(buffer);
+	buffer.rasterize();
+
+	wmcv::CullingBounds bounds;
+	bounds.add({0.f, 0.f, -20.f}, glm::vec3{1.f});		// behind the wall
+	bounds.add({0.f, 0.f, -5.f}, glm::vec3{1.f});		// in front of it
+	bounds.add({8.f, 0.f, -20.f}, glm::vec3{1.f});		// off to the side
+	bounds.add({4.f, 0.f, -20.f}, glm::vec3{1.f});		// poking out past its edge
+	bounds.add({0.f, 0.f, 0.f}, glm::vec3{1.f});		// around the camera
+	bounds.add({0.f, 0.f, -12.f}, glm::vec3{0.5f});		// small and just behind
+
+	std::vector<uint32_t> visible{0, 1, 2, 3, 4, 5};
+	buffer.cull(bounds, visible);
+	EXPECT_EQ(visible, (std::vector<uint32_t>{1, 2, 3, 4}));
+
+	const wmcv::OcclusionStats stats = buffer.stats();
+	EXPECT_EQ(stats.triangles, 12u);
+	EXPECT_EQ(stats.tested, 6u);
+	EXPECT_EQ(stats.occluded, 2u);
+}
+
+TEST(OcclusionBuffer, rasterized_depth_is_the_nearest_face)
+{
+	const glm::mat4 viewProjection = MakeViewProjection();
+	wmcv::OcclusionBuffer buffer{100, 50};
+	EXPECT_EQ(buffer.width(), 128u);
+	EXPECT_EQ(buffer.height(), 64u);
+	EXPECT_EQ(buffer.tileCount(), 8u);
+
+	buffer.begin(viewProjection);
+	AddWall(buffer);
+	buffer.rasterize();
+
+	const glm::vec4 front = viewProjection * glm::vec4{0.f, 0.f, -9.9f, 1.f};
+	EXPECT_NEAR(buffer.depth(64, 32), front.z / front.w, 1e-5f);
+	EXPECT_EQ(buffer.depth(0, 0), 1.f);
+	EXPECT_EQ(buffer.depth(127, 63), 1.f);
+
+	// Nothing queued, so the next frame starts clear.
+	buffer.begin(viewProjection);
+	buffer.rasterize();
+	EXPECT_EQ(buffer.depth(64, 32), 1.f);
+}
+
+TEST(OcclusionBuffer, occluders_crossing_the_near_plane_are_clipped)
+{
+	wmcv::OcclusionBuffer buffer{128, 64};
+	buffer.begin(MakeViewProjection());
+
+	// A long box from behind the camera out to z = -10.
+	const glm::mat4 model = glm::translate(glm::mat4{1.f}, glm::vec3{0.f, 0.f, -4.f});
+	buffer.addOccluderBox(model, glm::vec3{1.f, 1.f, 6.f});
+	buffer.rasterize();
+
+	// Only the part past the near plane is drawn, and it still hides what
+	// is behind it.
+	EXPECT_LT(buffer.depth(64, 32), 1.f);
+	EXPECT_GE(buffer.depth(64, 32), -1.f);
+	EXPECT_TRUE(buffer.occluded(glm::vec3{0.f, 0.f, -30.f}, glm::vec3{0.5f}));
+}
+
+TEST(OcclusionBuffer, tiles_rasterized_in_parallel_match_a_single_thread)
+{
+	std::mt19937 random{11};
+	std::uniform_real_distribution<float> position{-20.f, 20.f};
+	std::uniform_real_distribution<float> distance{-60.f, -2.f};
+	std::uniform_real_distribution<float> size{0.5f, 4.f};
+
+	std::vector<glm::mat4> occluders;
+	for (int i = 0; i < 64; ++i)
+	{
+		glm::mat4 model = glm::translate(glm::mat4{1.f}, glm::vec3{position(random), position(random), distance(random)});
+		model = glm::rotate(model, position(random), glm::vec3{0.3f, 1.f, 0.2f});
+		occluders.push_back(glm::scale(model, glm::vec3{size(random), size(random), size(random)}));
+	}
+
+	const auto render = [&occluders](wmcv::OcclusionBuffer& buffer, size_t count)
+	{
+		buffer.begin(MakeViewProjection());
+		for (size_t i = 0; i < count; ++i)
+			buffer.addOccluderBox(occluders[i], glm::vec3{0.5f});
+		buffer.rasterize();
+
+		std::vector<float> depth;
+		for (uint32_t y = 0; y < buffer.height(); ++y)
+		{
+			for (uint32_t x = 0; x < buffer.width(); ++x)
+				depth.push_back(buffer.depth(x, y));
+		}
+		return depth;
+	};
+
+	wmcv::OcclusionBuffer serial{256, 128};
+	wmcv::OcclusionBuffer parallel{256, 128, 4};
+	wmcv::OcclusionBuffer oversubscribed{256, 128, 64};
+	EXPECT_EQ(parallel.threadCount(), 4u);
+	EXPECT_EQ(oversubscribed.threadCount(), oversubscribed.tileCount());
+
+	// The same workers serve frame after frame.
+	for (const size_t count : {size_t{64}, size_t{8}, size_t{0}, size_t{64}})
+	{
+		const std::vector<float> expected = render(serial, count);
+		if (count > 0)
+		{
+			EXPECT_NE(std::count(expected.begin(), expected.end(), 1.f), static_cast<std::ptrdiff_t>(expected.size()));
+		}
+		EXPECT_EQ(render(parallel, count), expected);
+		EXPECT_EQ(render(oversubscribed, count), expected);
+	}
+}
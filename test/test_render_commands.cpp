@@ -0,0 +1,127 @@
+#include "pch.h"
+#include "render_commands.h"
+#include "mock_opengl.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+TEST(RenderSortKey, round_trips_every_field)
+{
+	constexpr wmcv::RenderSortKey fields{
+		.pass = wmcv::RenderPass::Transparent,
+		.depth = 0xabcdef,
+		.shader = 0x123,
+		.material = 0x456,
+		.mesh = 0xfff};
+	constexpr uint64_t key = wmcv::EncodeSortKey(fields);
+	constexpr wmcv::RenderSortKey decoded = wmcv::DecodeSortKey(key);
+	static_assert(decoded.pass == fields.pass);
+	static_assert(decoded.depth == fields.depth);
+
+	EXPECT_EQ(decoded.shader, fields.shader);
+	EXPECT_EQ(decoded.material, fields.material);
+	EXPECT_EQ(decoded.mesh, fields.mesh);
+}
+
+TEST(RenderSortKey, orders_by_pass_then_depth_then_state)
+{
+	using wmcv::EncodeSortKey;
+	using wmcv::RenderPass;
+
+	EXPECT_LT(EncodeSortKey({.pass = RenderPass::Opaque, .depth = wmcv::sort_key::MAX_DEPTH, .shader = 4095}),
+		EncodeSortKey({.pass = RenderPass::Emissive}));
+	EXPECT_LT(EncodeSortKey({.depth = 1, .shader = 4095, .material = 4095, .mesh = 4095}), EncodeSortKey({.depth = 2}));
+	EXPECT_LT(EncodeSortKey({.shader = 1, .material = 4095}), EncodeSortKey({.shader = 2}));
+	EXPECT_LT(EncodeSortKey({.material = 1, .mesh = 4095}), EncodeSortKey({.material = 2}));
+
+	EXPECT_EQ(wmcv::QuantizeDepth(0.1f, 0.1f, 100.f), 0u);
+	EXPECT_EQ(wmcv::QuantizeDepth(500.f, 0.1f, 100.f), wmcv::sort_key::MAX_DEPTH);
+	EXPECT_LT(wmcv::QuantizeDepth(5.f, 0.1f, 100.f), wmcv::QuantizeDepth(6.f, 0.1f, 100.f));
+}
+
+TEST(RenderCommandBuffer, radix_sort_matches_a_stable_sort)
+{
+	std::mt19937_64 random{7};
+	std::vector<int32_t> payload(20'000);
+	std::vector<wmcv::RenderCommandEntry> entries;
+	for (size_t i = 0; i < payload.size(); ++i)
+	{
+		// Few distinct keys so stability is exercised, spread over every byte.
+		const uint64_t key = (random() % 64) * 0x0101010101010101ull;
+		entries.push_back({key, &payload[i], wmcv::RenderCommandType::DrawArrays});
+	}
+
+	std::vector<wmcv::RenderCommandEntry> expected = entries;
+	std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) { return a.key < b.key; });
+
+	std::vector<wmcv::RenderCommandEntry> scratch(entries.size());
+	wmcv::RadixSortByKey(entries, scratch);
+
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		ASSERT_EQ(entries[i].key, expected[i].key);
+		ASSERT_EQ(entries[i].command, expected[i].command);
+	}
+}
+
+TEST(RenderCommandBuffer, steady_frames_reuse_one_arena_block)
+{
+	wmcv::RenderCommandBuffer commands{256};
+
+	const auto recordFrame = [&commands](int32_t count)
+	{
+		for (int32_t i = 0; i < count; ++i)
+		{
+			const auto mesh = static_cast<uint16_t>(count - i);
+			commands.push(wmcv::EncodeSortKey({.mesh = mesh}), wmcv::DrawArraysCommand{1, 0, i});
+			commands.push(wmcv::EncodeSortKey({.pass = wmcv::RenderPass::Emissive}), wmcv::DrawArraysInstancedCommand{2, 0, 36, i});
+		}
+	};
+
+	recordFrame(100);
+	EXPECT_GT(commands.arena().blockCount(), 1u);
+	commands.sort();
+
+	const auto sorted = commands.commands();
+	ASSERT_EQ(sorted.size(), 200u);
+	for (size_t i = 0; i < 100; ++i)
+	{
+		ASSERT_EQ(sorted[i].type, wmcv::RenderCommandType::DrawArrays);
+		EXPECT_EQ(wmcv::CommandAs<wmcv::DrawArraysCommand>(sorted[i]).count, 99 - static_cast<int32_t>(i));
+	}
+	for (size_t i = 100; i < 200; ++i)
+	{
+		ASSERT_EQ(sorted[i].type, wmcv::RenderCommandType::DrawArraysInstanced);
+		EXPECT_EQ(wmcv::CommandAs<wmcv::DrawArraysInstancedCommand>(sorted[i]).instanceCount, static_cast<int32_t>(i - 100));
+	}
+
+	commands.reset();
+	const size_t capacity = commands.arena().capacity();
+	EXPECT_EQ(commands.arena().blockCount(), 1u);
+	EXPECT_EQ(commands.size(), 0u);
+
+	for (int frame = 0; frame < 10; ++frame)
+	{
+		recordFrame(100);
+		commands.sort();
+		EXPECT_EQ(commands.arena().blockCount(), 1u);
+		EXPECT_EQ(commands.arena().capacity(), capacity);
+		commands.reset();
+	}
+}
+
+TEST(RenderCommandBuffer, executes_each_command_as_one_draw)
+{
+	wmcv::test::MockOpenGL gl;
+	wmcv::RenderCommandBuffer commands;
+	commands.push(0, wmcv::DrawArraysInstancedCommand{3, 0, 36, 1000});
+	commands.push(1, wmcv::DrawArraysCommand{4, 0, 36});
+
+	for (const wmcv::RenderCommandEntry& entry : commands.commands())
+		wmcv::ExecuteRenderCommand(entry);
+
+	EXPECT_EQ(gl.calls("glDrawArraysInstanced"), 1);
+	EXPECT_EQ(gl.calls("glDrawArrays"), 1);
+	EXPECT_EQ(gl.boundVertexArray, 4u);
+}
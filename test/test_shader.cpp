@@ -0,0 +1,213 @@
+#include "pch.h"
+#include "shader.h"
+#include "mock_opengl.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+namespace
+{
+
+using wmcv::test::MockOpenGL;
+
+class ShaderTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		const auto dir = std::filesystem::temp_directory_path();
+		m_vertexPath = dir / "learn_opengl_test.vs";
+		m_fragmentPath = dir / "learn_opengl_test.fs";
+		std::ofstream{m_vertexPath} << "void main() {}";
+		std::ofstream{m_fragmentPath} << "void main() {}";
+
+		gl.addUniform("model", GL_FLOAT_MAT4);
+		gl.addUniform("view", GL_FLOAT_MAT4);
+		gl.addUniform("material.shininess", GL_FLOAT);
+		gl.addUniform("material.diffuse", GL_SAMPLER_2D);
+		gl.addUniform("pointLights[0].position", GL_FLOAT_VEC3);
+		gl.addUniform("pointLights[1].position", GL_FLOAT_VEC3);
+		gl.addUniform("weights[0]", GL_FLOAT, 4);
+	}
+
+	void TearDown() override
+	{
+		std::filesystem::remove(m_vertexPath);
+		std::filesystem::remove(m_fragmentPath);
+	}
+
+	wmcv::Shader makeShader() const { return wmcv::Shader{m_vertexPath, m_fragmentPath}; }
+
+	MockOpenGL gl;
+	std::filesystem::path m_vertexPath;
+	std::filesystem::path m_fragmentPath;
+};
+
+} // namespace
+
+TEST_F(ShaderTest, uniform_locations_are_resolved_once_at_link)
+{
+	wmcv::Shader shader = makeShader();
+
+	EXPECT_EQ(gl.calls("glGetActiveUniform"), 7);
+	// One lookup per plain uniform and one per element of the float array.
+	EXPECT_EQ(gl.calls("glGetUniformLocation"), 6 + 4);
+	// The array is also reachable by its bare name.
+	EXPECT_EQ(shader.uniformCount(), 11u);
+
+	gl.resetCalls();
+	for (int frame = 0; frame < 100; ++frame)
+	{
+		// Values change every frame so none of the uploads are shadowed away.
+		const float value = static_cast<float>(frame);
+		shader.setMat4("model", glm::mat4{value});
+		shader.setFloat("material.shininess", value);
+		shader.setVec3("pointLights[1].position", glm::vec3{value, 2.f, 3.f});
+	}
+
+	EXPECT_EQ(gl.calls("glGetUniformLocation"), 0);
+	EXPECT_EQ(gl.calls("glUniformMatrix4fv"), 100);
+	EXPECT_EQ(gl.calls("glUniform1f"), 100);
+	EXPECT_EQ(gl.calls("glUniform3fv"), 100);
+
+	EXPECT_EQ(gl.uniformValue<float>(gl.locationOf("material.shininess")), 99.f);
+	EXPECT_EQ(gl.uniformValue<glm::vec3>(gl.locationOf("pointLights[1].position")), (glm::vec3{99.f, 2.f, 3.f}));
+}
+
+TEST_F(ShaderTest, array_elements_resolve_by_index_and_bare_name)
+{
+	wmcv::Shader shader = makeShader();
+
+	EXPECT_EQ(shader.uniform<float>("weights").location, gl.locationOf("weights[0]"));
+	EXPECT_EQ(shader.uniform<float>("weights[0]").location, gl.locationOf("weights[0]"));
+	EXPECT_EQ(shader.uniform<float>("weights[3]").location, gl.locationOf("weights[3]"));
+	EXPECT_FALSE(shader.uniform<float>("weights[4]").valid());
+}
+
+TEST_F(ShaderTest, handles_skip_the_lookup_and_unknown_names_issue_no_calls)
+{
+	wmcv::Shader shader = makeShader();
+	const auto model = shader.uniform<glm::mat4>("model");
+	const auto diffuse = shader.uniform<int>("material.diffuse");
+	const auto missing = shader.uniform<glm::vec3>("spotLight.position");
+
+	ASSERT_TRUE(model.valid());
+	ASSERT_TRUE(diffuse.valid());
+	EXPECT_FALSE(missing.valid());
+
+	gl.resetCalls();
+	const glm::mat4 transform = glm::translate(glm::mat4{1.f}, glm::vec3{4.f, 5.f, 6.f});
+	shader.set(model, transform);
+	shader.set(diffuse, 1);
+	shader.set(missing, glm::vec3{1.f});
+	shader.setVec3("not.a.uniform", glm::vec3{1.f});
+
+	EXPECT_EQ(gl.totalCalls(), 2);
+	EXPECT_EQ(gl.uniformValue<glm::mat4>(model.location), transform);
+	EXPECT_EQ(gl.uniformValue<int>(diffuse.location), 1);
+}
+
+TEST_F(ShaderTest, moved_shader_deletes_its_program_once)
+{
+	{
+		wmcv::Shader shader = makeShader();
+		wmcv::Shader moved = std::move(shader);
+		EXPECT_EQ(shader.m_programId, 0u);
+		EXPECT_TRUE(moved.uniform<glm::mat4>("view").valid());
+		EXPECT_FALSE(shader.uniform<glm::mat4>("view").valid());
+	}
+
+	EXPECT_EQ(gl.calls("glDeleteProgram"), 1);
+}
+
+TEST_F(ShaderTest, unchanged_values_are_not_uploaded_again)
+{
+	wmcv::Shader shader = makeShader();
+	const auto model = shader.uniform<glm::mat4>("model");
+	const auto shininess = shader.uniform<float>("material.shininess");
+	const auto diffuse = shader.uniform<bool>("material.diffuse");
+
+	gl.resetCalls();
+	shader.set(model, glm::mat4{1.f});
+	shader.set(shininess, 32.f);
+	shader.set(diffuse, true);
+	EXPECT_EQ(gl.totalCalls(), 3);
+	EXPECT_EQ(shader.uploadStats().uploaded, 3u);
+	EXPECT_EQ(shader.uploadStats().skipped, 0u);
+
+	gl.resetCalls();
+	shader.set(model, glm::mat4{1.f});
+	shader.setFloat("material.shininess", 32.f);
+	shader.setBool("material.diffuse", true);
+	EXPECT_EQ(gl.totalCalls(), 0);
+	EXPECT_EQ(shader.uploadStats().skipped, 3u);
+
+	shader.set(shininess, 64.f);
+	shader.setInt("material.diffuse", 0);
+	EXPECT_EQ(gl.calls("glUniform1f"), 1);
+	EXPECT_EQ(gl.calls("glUniform1i"), 1);
+	EXPECT_EQ(gl.uniformValue<float>(shininess.location), 64.f);
+	EXPECT_EQ(gl.uniformValue<int>(diffuse.location), 0);
+	EXPECT_EQ(shader.uploadStats().uploaded, 5u);
+
+	shader.resetUploadStats();
+	EXPECT_EQ(shader.uploadStats().uploaded, 0u);
+	EXPECT_EQ(shader.uploadStats().skipped, 0u);
+}
+
+TEST_F(ShaderTest, a_steady_frame_only_uploads_what_moved)
+{
+	wmcv::Shader shader = makeShader();
+	const auto drawFrame = [&shader](float time)
+	{
+		shader.setInt("material.diffuse", 0);
+		shader.setFloat("material.shininess", 32.f);
+		shader.setVec3("pointLights[0].position", glm::vec3{0.7f, 0.2f, 2.f});
+		shader.setVec3("pointLights[1].position", glm::vec3{2.3f, -3.3f, -4.f});
+		shader.setMat4("view", glm::mat4{1.f});
+		for (int i = 0; i < 4; ++i)
+			shader.setFloat("weights[" + std::to_string(i) + "]", 0.25f);
+		shader.setMat4("model", glm::rotate(glm::mat4{1.f}, time, glm::vec3{0.f, 1.f, 0.f}));
+	};
+
+	drawFrame(0.f);
+	EXPECT_EQ(shader.uploadStats().uploaded, 10u);
+
+	for (int frame = 1; frame <= 60; ++frame)
+	{
+		shader.resetUploadStats();
+		gl.resetCalls();
+		drawFrame(static_cast<float>(frame) * 0.01f);
+
+		EXPECT_EQ(shader.uploadStats().uploaded, 1u);
+		EXPECT_EQ(shader.uploadStats().skipped, 9u);
+		EXPECT_EQ(gl.totalCalls(), 1);
+	}
+}
+
+TEST(UniformNameTable, finds_every_inserted_hash)
+{
+	wmcv::UniformNameTable table;
+	EXPECT_EQ(table.find(wmcv::HashUniformName("model")), -1);
+
+	for (int32_t i = 0; i < 1000; ++i)
+		table.insert(wmcv::HashUniformName("uniform" + std::to_string(i)), i);
+
+	EXPECT_EQ(table.size(), 1000u);
+	for (int32_t i = 0; i < 1000; ++i)
+		EXPECT_EQ(table.find(wmcv::HashUniformName("uniform" + std::to_string(i))), i);
+
+	EXPECT_EQ(table.find(wmcv::HashUniformName("uniform1000")), -1);
+
+	table.insert(wmcv::HashUniformName("uniform7"), 42);
+	EXPECT_EQ(table.size(), 1000u);
+	EXPECT_EQ(table.find(wmcv::HashUniformName("uniform7")), 42);
+}
+
+TEST(UniformNameTable, name_hash_is_usable_at_compile_time)
+{
+	constexpr uint64_t hash = wmcv::HashUniformName("projection");
+	static_assert(hash != 0);
+	EXPECT_EQ(hash, wmcv::HashUniformName(std::string{"projection"}));
+}